@@ -0,0 +1,92 @@
+#include <stdint.h>
+#include "bench_utils.h"
+#include "main/collections/list/array_list.h"
+#include "main/concurrency/thread_pool.h"
+
+// usage: array_list_parallel_bench [elements] [workers]
+// a plain loop against array_list_parallel_map, _filter and _reduce, with callbacks that
+// cost a few hundred nanoseconds each. workers 0 means one per online cpu
+
+static uint64_t *values;
+static uint64_t *results;
+
+static uint64_t mix(uint64_t x)
+{
+    for (int i = 0; i < 256; i++)
+    {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+    }
+    return x;
+}
+
+static void *mix_element(void *x)
+{
+    uint64_t *value = x;
+    long index = value - values;
+    results[index] = mix(*value);
+    return &results[index];
+}
+
+static bool mixes_odd(void *x)
+{
+    return mix(*(uint64_t *)x) & 1;
+}
+
+// the one whose mix is bigger, so the operation is associative and costs a mix per call
+static void *bigger_mix(void *a, void *b)
+{
+    return mix(*(uint64_t *)b) > mix(*(uint64_t *)a) ? b : a;
+}
+
+int main(int argc, char **argv)
+{
+    long count = bench_arg_or_default(argc, argv, 1, 1000000);
+    t_thread_pool *pool = thread_pool_create(bench_arg_or_default(argc, argv, 2, 0));
+    printf("%d workers\n", thread_pool_size(pool));
+    values = malloc(count * sizeof(uint64_t));
+    results = malloc(count * sizeof(uint64_t));
+    t_array_list *list = array_list_create_with_capacity(count);
+    for (long i = 0; i < count; i++)
+    {
+        values[i] = i + 1;
+        array_list_add(list, &values[i]);
+    }
+
+    double start = bench_now_seconds();
+    for (long i = 0; i < count; i++)
+        mix_element(list->array[i]);
+    bench_report("map loop", count, bench_now_seconds() - start);
+    start = bench_now_seconds();
+    t_array_list *mapped = array_list_parallel_map(list, pool, mix_element);
+    bench_report("parallel_map", count, bench_now_seconds() - start);
+
+    start = bench_now_seconds();
+    long kept = 0;
+    for (long i = 0; i < count; i++)
+        kept += mixes_odd(list->array[i]);
+    bench_report("filter loop", count, bench_now_seconds() - start);
+    start = bench_now_seconds();
+    t_array_list *filtered = array_list_parallel_filter(list, pool, mixes_odd);
+    bench_report("parallel_filter", count, bench_now_seconds() - start);
+
+    start = bench_now_seconds();
+    void *best = list->array[0];
+    for (long i = 1; i < count; i++)
+        best = bigger_mix(best, list->array[i]);
+    bench_report("reduce loop", count, bench_now_seconds() - start);
+    start = bench_now_seconds();
+    void *parallel_best = array_list_parallel_reduce(list, pool, bigger_mix);
+    bench_report("parallel_reduce", count, bench_now_seconds() - start);
+
+    if ((long)array_list_size(filtered) != kept || best != parallel_best)
+        printf("results differ\n");
+    array_list_destroy(mapped);
+    array_list_destroy(filtered);
+    array_list_destroy(list);
+    free(values);
+    free(results);
+    thread_pool_destroy(pool);
+    return 0;
+}
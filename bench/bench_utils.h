@@ -0,0 +1,46 @@
+#ifndef BENCH_UTILS_H_INCLUDED
+#define BENCH_UTILS_H_INCLUDED
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+static inline double bench_now_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static inline long bench_arg_or_default(int argc, char **argv, int position, long default_value)
+{
+    if (argc <= position)
+        return default_value;
+    return strtol(argv[position], NULL, 10);
+}
+
+static inline void bench_report(const char *name, long operations, double seconds)
+{
+    printf("%-40s %10ld ops %9.3f s %12.0f ops/s %8.1f ns/op\n",
+           name, operations, seconds, operations / seconds, seconds * 1e9 / operations);
+}
+
+static inline int bench_compare_doubles(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// sorts samples in place and prints the usual latency percentiles, samples in seconds
+static inline void bench_report_latencies(const char *name, double *samples, long count)
+{
+    qsort(samples, count, sizeof(double), bench_compare_doubles);
+    printf("%-40s p50 %8.0f ns  p99 %8.0f ns  p99.9 %10.0f ns  max %12.0f ns\n", name,
+           samples[count / 2] * 1e9,
+           samples[(long)(count * 0.99)] * 1e9,
+           samples[(long)(count * 0.999)] * 1e9,
+           samples[count - 1] * 1e9);
+}
+
+#endif
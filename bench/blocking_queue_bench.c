@@ -0,0 +1,98 @@
+#include <pthread.h>
+#include <stdint.h>
+#include "bench_utils.h"
+#include "main/collections/queue/blocking_queue.h"
+
+// usage: blocking_queue_bench [items] [threads_per_side] [batch_size]
+// producers push items one by one into a t_blocking_queue, consumers drain it with
+// blocking_queue_pop (one lock round trip per item) or blocking_queue_pop_batch
+
+typedef struct
+{
+    t_blocking_queue *queue;
+    long items;
+    int batch_size;
+    long calls;
+} t_worker;
+
+static void *producer_body(void *arg)
+{
+    t_worker *worker = arg;
+    for (long i = 1; i <= worker->items; i++)
+        blocking_queue_push(worker->queue, (void *)(uintptr_t)i);
+    return NULL;
+}
+
+static void *single_consumer_body(void *arg)
+{
+    t_worker *worker = arg;
+    void *item;
+    while (blocking_queue_pop(worker->queue, &item) == QUEUE_SUCCESS)
+        worker->calls++;
+    return NULL;
+}
+
+static void *batch_consumer_body(void *arg)
+{
+    t_worker *worker = arg;
+    void **items = malloc(worker->batch_size * sizeof(void *));
+    while (blocking_queue_pop_batch(worker->queue, items, worker->batch_size) > 0)
+        worker->calls++;
+    free(items);
+    return NULL;
+}
+
+static void run(const char *name, void *(*consumer_body)(void *), long items, int threads, int batch_size)
+{
+    t_blocking_queue *queue = blocking_queue_create();
+    pthread_t *producers = malloc(threads * sizeof(pthread_t));
+    pthread_t *consumers = malloc(threads * sizeof(pthread_t));
+    t_worker *producer_args = malloc(threads * sizeof(t_worker));
+    t_worker *consumer_args = malloc(threads * sizeof(t_worker));
+    char label[64];
+
+    double start = bench_now_seconds();
+    for (int i = 0; i < threads; i++)
+    {
+        consumer_args[i] = (t_worker){.queue = queue, .batch_size = batch_size};
+        pthread_create(&consumers[i], NULL, consumer_body, &consumer_args[i]);
+    }
+    for (int i = 0; i < threads; i++)
+    {
+        producer_args[i] = (t_worker){.queue = queue, .items = items / threads};
+        pthread_create(&producers[i], NULL, producer_body, &producer_args[i]);
+    }
+    for (int i = 0; i < threads; i++)
+        pthread_join(producers[i], NULL);
+    blocking_queue_close(queue);
+    long calls = 0;
+    for (int i = 0; i < threads; i++)
+    {
+        pthread_join(consumers[i], NULL);
+        calls += consumer_args[i].calls;
+    }
+    double elapsed = bench_now_seconds() - start;
+
+    snprintf(label, sizeof(label), "%s %dP/%dC", name, threads, threads);
+    bench_report(label, items / threads * threads, elapsed);
+    printf("%-40s %10ld pops, %.2f items per pop\n", label, calls, (double)(items / threads * threads) / calls);
+
+    blocking_queue_destroy(queue);
+    free(consumer_args);
+    free(producer_args);
+    free(consumers);
+    free(producers);
+}
+
+int main(int argc, char **argv)
+{
+    long items = bench_arg_or_default(argc, argv, 1, 5000000);
+    int threads = bench_arg_or_default(argc, argv, 2, 4);
+    int batch_size = bench_arg_or_default(argc, argv, 3, 64);
+
+    run("pop", single_consumer_body, items, 1, batch_size);
+    run("pop_batch", batch_consumer_body, items, 1, batch_size);
+    run("pop", single_consumer_body, items, threads, batch_size);
+    run("pop_batch", batch_consumer_body, items, threads, batch_size);
+    return 0;
+}
@@ -0,0 +1,119 @@
+
+#include <pthread.h>
+#include "bench_utils.h"
+#include "main/collections/map/concurrent_hashmap.h"
+
+// usage: concurrent_hash_map_bench [max_threads] [ops_per_thread] [key_count]
+// mixed 90% get / 10% put over a preloaded key set, run with 1, 2, 4... threads against
+// a t_hash_map behind one global mutex and against the lock striped map
+
+#define KEY_LENGTH 16
+#define PUT_EVERY 10
+
+typedef struct{
+    const char *keys;
+    long key_count;
+    long operations;
+    unsigned int seed;
+    pthread_mutex_t *global_lock;
+    t_hash_map *global_map;
+    t_concurrent_hash_map *striped_map;
+} t_worker;
+
+static char *generate_keys(long count)
+{
+    char *keys = malloc(count * KEY_LENGTH);
+    for (long i = 0; i < count; i++)
+        snprintf(keys + i * KEY_LENGTH, KEY_LENGTH, "key:%u", (unsigned)i);
+    return keys;
+}
+
+static unsigned int next_random(unsigned int *state)
+{
+    // xorshift, cheap enough not to show up next to the map operations
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+
+static void *global_lock_worker(void *arg)
+{
+    t_worker *worker = arg;
+    for (long i = 0; i < worker->operations; i++)
+    {
+        char *key = (char *)worker->keys + (next_random(&worker->seed) % worker->key_count) * KEY_LENGTH;
+        pthread_mutex_lock(worker->global_lock);
+        if (i % PUT_EVERY == 0)
+            hash_map_put(worker->global_map, key, key);
+        else
+            hash_map_get(worker->global_map, key);
+        pthread_mutex_unlock(worker->global_lock);
+    }
+    return NULL;
+}
+
+static void *striped_worker(void *arg)
+{
+    t_worker *worker = arg;
+    for (long i = 0; i < worker->operations; i++)
+    {
+        char *key = (char *)worker->keys + (next_random(&worker->seed) % worker->key_count) * KEY_LENGTH;
+        if (i % PUT_EVERY == 0)
+            concurrent_hash_map_put(worker->striped_map, key, key);
+        else
+            concurrent_hash_map_get(worker->striped_map, key);
+    }
+    return NULL;
+}
+
+static void run(const char *name, void *(*body)(void *), t_worker template, int thread_count)
+{
+    pthread_t *threads = malloc(thread_count * sizeof(pthread_t));
+    t_worker *workers = malloc(thread_count * sizeof(t_worker));
+    char label[64];
+
+    double start = bench_now_seconds();
+    for (int i = 0; i < thread_count; i++)
+    {
+        workers[i] = template;
+        workers[i].seed = 2463534242u + i;
+        pthread_create(&threads[i], NULL, body, &workers[i]);
+    }
+    for (int i = 0; i < thread_count; i++)
+        pthread_join(threads[i], NULL);
+
+    snprintf(label, sizeof(label), "%s, %d threads", name, thread_count);
+    bench_report(label, template.operations * thread_count, bench_now_seconds() - start);
+    free(workers);
+    free(threads);
+}
+
+int main(int argc, char **argv)
+{
+    int max_threads = bench_arg_or_default(argc, argv, 1, 8);
+    long operations = bench_arg_or_default(argc, argv, 2, 2000000);
+    long key_count = bench_arg_or_default(argc, argv, 3, 1000000);
+    char *keys = generate_keys(key_count);
+    pthread_mutex_t global_lock = PTHREAD_MUTEX_INITIALIZER;
+
+    t_worker template = {.keys = keys, .key_count = key_count, .operations = operations, .global_lock = &global_lock};
+    template.global_map = hash_map_create();
+    template.striped_map = concurrent_hash_map_create();
+    for (long i = 0; i < key_count; i++)
+    {
+        hash_map_put(template.global_map, keys + i * KEY_LENGTH, keys);
+        concurrent_hash_map_put(template.striped_map, keys + i * KEY_LENGTH, keys);
+    }
+
+    for (int threads = 1; threads <= max_threads; threads *= 2)
+    {
+        run("global mutex", global_lock_worker, template, threads);
+        run("lock striping", striped_worker, template, threads);
+    }
+
+    hash_map_destroy(template.global_map);
+    concurrent_hash_map_destroy(template.striped_map);
+    free(keys);
+    return 0;
+}
@@ -0,0 +1,174 @@
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include "bench_utils.h"
+#include "main/collections/queue/queue.h"
+#include "main/collections/queue/spsc_queue.h"
+#include "main/collections/queue/mpmc_queue.h"
+
+// usage: concurrent_queue_bench [items] [threads_per_side] [capacity]
+// producers push items, consumers pop them until all are through. Reports throughput and the
+// time each sampled item spent between push and pop, for a t_queue behind a mutex, the spsc
+// queue (one thread per side) and the mpmc queue (one and threads_per_side per side)
+
+#define SAMPLE_EVERY 16
+
+typedef enum
+{
+    MUTEX_QUEUE,
+    SPSC_QUEUE,
+    MPMC_QUEUE
+} t_queue_kind;
+
+typedef struct
+{
+    t_queue_kind kind;
+    t_queue *queue;
+    pthread_mutex_t lock;
+    t_spsc_queue *spsc;
+    t_mpmc_queue *mpmc;
+    // indexed by item, only every SAMPLE_EVERY-th item is timed
+    double *push_times;
+    double *latencies;
+    atomic_long latency_count;
+    atomic_long items_left;
+} t_shared;
+
+typedef struct
+{
+    t_shared *shared;
+    long first_item;
+    long item_count;
+} t_producer;
+
+static bool push(t_shared *shared, void *item)
+{
+    switch (shared->kind)
+    {
+    case SPSC_QUEUE:
+        return spsc_queue_push(shared->spsc, item) == QUEUE_SUCCESS;
+    case MPMC_QUEUE:
+        return mpmc_queue_push(shared->mpmc, item) == QUEUE_SUCCESS;
+    default:
+        pthread_mutex_lock(&shared->lock);
+        queue_push(shared->queue, item);
+        pthread_mutex_unlock(&shared->lock);
+        return true;
+    }
+}
+
+static bool pop(t_shared *shared, void **item)
+{
+    t_queue_error result;
+    switch (shared->kind)
+    {
+    case SPSC_QUEUE:
+        return spsc_queue_pop(shared->spsc, item) == QUEUE_SUCCESS;
+    case MPMC_QUEUE:
+        return mpmc_queue_pop(shared->mpmc, item) == QUEUE_SUCCESS;
+    default:
+        pthread_mutex_lock(&shared->lock);
+        result = queue_pop(shared->queue, item);
+        pthread_mutex_unlock(&shared->lock);
+        return result == QUEUE_SUCCESS;
+    }
+}
+
+static void *producer_body(void *arg)
+{
+    t_producer *producer = arg;
+    for (long i = producer->first_item; i < producer->first_item + producer->item_count; i++)
+    {
+        if (i % SAMPLE_EVERY == 0)
+            producer->shared->push_times[i / SAMPLE_EVERY] = bench_now_seconds();
+        // items are offset by one so no item is a NULL pointer
+        while (!push(producer->shared, (void *)(uintptr_t)(i + 1)))
+            sched_yield();
+    }
+    return NULL;
+}
+
+static void *consumer_body(void *arg)
+{
+    t_shared *shared = arg;
+    void *item;
+    while (atomic_load_explicit(&shared->items_left, memory_order_relaxed) > 0)
+    {
+        if (!pop(shared, &item))
+        {
+            sched_yield();
+            continue;
+        }
+        atomic_fetch_sub_explicit(&shared->items_left, 1, memory_order_relaxed);
+        long index = (long)(uintptr_t)item - 1;
+        if (index % SAMPLE_EVERY == 0)
+        {
+            long sample = atomic_fetch_add_explicit(&shared->latency_count, 1, memory_order_relaxed);
+            shared->latencies[sample] = bench_now_seconds() - shared->push_times[index / SAMPLE_EVERY];
+        }
+    }
+    return NULL;
+}
+
+static void run(const char *name, t_queue_kind kind, long items, int threads, int capacity)
+{
+    t_shared shared = {.kind = kind};
+    pthread_t *producers = malloc(threads * sizeof(pthread_t));
+    pthread_t *consumers = malloc(threads * sizeof(pthread_t));
+    t_producer *producer_args = malloc(threads * sizeof(t_producer));
+    char label[64];
+
+    shared.queue = queue_create();
+    pthread_mutex_init(&shared.lock, NULL);
+    shared.spsc = spsc_queue_create(capacity);
+    shared.mpmc = mpmc_queue_create(capacity);
+    shared.push_times = malloc((items / SAMPLE_EVERY + 1) * sizeof(double));
+    shared.latencies = malloc((items / SAMPLE_EVERY + 1) * sizeof(double));
+    atomic_init(&shared.latency_count, 0);
+    atomic_init(&shared.items_left, items);
+
+    double start = bench_now_seconds();
+    for (int i = 0; i < threads; i++)
+        pthread_create(&consumers[i], NULL, consumer_body, &shared);
+    for (int i = 0; i < threads; i++)
+    {
+        producer_args[i] = (t_producer){.shared = &shared, .first_item = i * (items / threads), .item_count = items / threads};
+        if (i == threads - 1)
+            producer_args[i].item_count = items - producer_args[i].first_item;
+        pthread_create(&producers[i], NULL, producer_body, &producer_args[i]);
+    }
+    for (int i = 0; i < threads; i++)
+        pthread_join(producers[i], NULL);
+    for (int i = 0; i < threads; i++)
+        pthread_join(consumers[i], NULL);
+    double elapsed = bench_now_seconds() - start;
+
+    snprintf(label, sizeof(label), "%s %dP/%dC", name, threads, threads);
+    bench_report(label, items, elapsed);
+    bench_report_latencies(label, shared.latencies, atomic_load(&shared.latency_count));
+
+    free(shared.push_times);
+    free(shared.latencies);
+    queue_destroy(shared.queue);
+    pthread_mutex_destroy(&shared.lock);
+    spsc_queue_destroy(shared.spsc);
+    mpmc_queue_destroy(shared.mpmc);
+    free(producer_args);
+    free(consumers);
+    free(producers);
+}
+
+int main(int argc, char **argv)
+{
+    long items = bench_arg_or_default(argc, argv, 1, 10000000);
+    int threads = bench_arg_or_default(argc, argv, 2, 4);
+    int capacity = bench_arg_or_default(argc, argv, 3, 1024);
+
+    run("mutex + t_queue", MUTEX_QUEUE, items, 1, capacity);
+    run("spsc queue", SPSC_QUEUE, items, 1, capacity);
+    run("mpmc queue", MPMC_QUEUE, items, 1, capacity);
+    run("mutex + t_queue", MUTEX_QUEUE, items, threads, capacity);
+    run("mpmc queue", MPMC_QUEUE, items, threads, capacity);
+    return 0;
+}
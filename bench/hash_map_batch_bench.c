@@ -0,0 +1,87 @@
+#include "bench_utils.h"
+#include "main/collections/map/hashmap.h"
+
+// usage: hash_map_batch_bench [key_count] [batch_size]
+// random order lookups on a map far bigger than the cache, one hash_map_get per key
+// against hash_map_get_batch over batch_size keys at a time
+
+#define KEY_LENGTH 16
+
+static char *generate_keys(long count)
+{
+    char *keys = malloc(count * KEY_LENGTH);
+    for (long i = 0; i < count; i++)
+        snprintf(&keys[i * KEY_LENGTH], KEY_LENGTH, "key:%u", (unsigned)i);
+    return keys;
+}
+
+static char **shuffled_pointers(char *keys, long count)
+{
+    char **pointers = malloc(count * sizeof(char *));
+    for (long i = 0; i < count; i++)
+        pointers[i] = &keys[i * KEY_LENGTH];
+
+    srand(42);
+    for (long i = count - 1; i > 0; i--)
+    {
+        long j = ((long)rand() * RAND_MAX + rand()) % (i + 1);
+        char *temp = pointers[i];
+        pointers[i] = pointers[j];
+        pointers[j] = temp;
+    }
+    return pointers;
+}
+
+static void run(const char *name, t_hash_map_options options, char **lookups, long count, int batch_size)
+{
+    char label[64];
+    t_hash_map *map = hash_map_create_with_options(options);
+    void **values = malloc(batch_size * sizeof(void *));
+    long found = 0;
+
+    double start = bench_now_seconds();
+    hash_map_put_batch(map, lookups, count, (void **)lookups);
+    snprintf(label, sizeof(label), "%s put batch", name);
+    bench_report(label, count, bench_now_seconds() - start);
+
+    start = bench_now_seconds();
+    for (long i = 0; i < count; i++)
+        found += hash_map_get(map, lookups[i]) != NULL;
+    snprintf(label, sizeof(label), "%s get", name);
+    bench_report(label, count, bench_now_seconds() - start);
+
+    start = bench_now_seconds();
+    for (long i = 0; i < count; i += batch_size)
+    {
+        int size = count - i < batch_size ? count - i : batch_size;
+        hash_map_get_batch(map, &lookups[i], size, values);
+        for (int j = 0; j < size; j++)
+            found += values[j] != NULL;
+    }
+    snprintf(label, sizeof(label), "%s get batch", name);
+    bench_report(label, count, bench_now_seconds() - start);
+
+    if (found != count * 2)
+        fprintf(stderr, "%s: expected %ld hits, got %ld\n", name, count * 2, found);
+    free(values);
+    hash_map_destroy(map);
+}
+
+int main(int argc, char **argv)
+{
+    long count = bench_arg_or_default(argc, argv, 1, 5000000);
+    int batch_size = bench_arg_or_default(argc, argv, 2, 1024);
+    char *keys = generate_keys(count);
+    char **lookups = shuffled_pointers(keys, count);
+
+    // borrowed keys: the map points into keys, the batch puts copy nothing
+    run("chaining", (t_hash_map_options){.key_storage = HASH_MAP_KEYS_BORROWED}, lookups, count, batch_size);
+    run("open addressing", (t_hash_map_options){.type = HASH_MAP_OPEN_ADDRESSING, .key_storage = HASH_MAP_KEYS_BORROWED},
+        lookups, count, batch_size);
+    run("swiss table", (t_hash_map_options){.type = HASH_MAP_SWISS_TABLE, .key_storage = HASH_MAP_KEYS_BORROWED},
+        lookups, count, batch_size);
+
+    free(lookups);
+    free(keys);
+    return 0;
+}
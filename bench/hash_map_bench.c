@@ -0,0 +1,97 @@
+#include "bench_utils.h"
+#include "main/collections/map/hashmap.h"
+
+// usage: hash_map_bench [key_count]
+// inserts, looks up (hits and misses) and removes key_count string keys on every map type
+
+#define KEY_LENGTH 16
+
+static char *generate_keys(long count, const char *prefix)
+{
+    char *keys = malloc(count * KEY_LENGTH);
+    if (!keys)
+        return NULL;
+    for (long i = 0; i < count; i++)
+        snprintf(&keys[i * KEY_LENGTH], KEY_LENGTH, "%s%u", prefix, (unsigned)i);
+    return keys;
+}
+
+// lookups go in random order, sequential keys would otherwise hit neighbouring buckets
+static void shuffle_keys(char *keys, long count)
+{
+    char temp[KEY_LENGTH];
+    srand(42);
+    for (long i = count - 1; i > 0; i--)
+    {
+        long j = ((long)rand() * RAND_MAX + rand()) % (i + 1);
+        memcpy(temp, &keys[i * KEY_LENGTH], KEY_LENGTH);
+        memcpy(&keys[i * KEY_LENGTH], &keys[j * KEY_LENGTH], KEY_LENGTH);
+        memcpy(&keys[j * KEY_LENGTH], temp, KEY_LENGTH);
+    }
+}
+
+static void run(const char *name, t_hash_map_options options, char *keys, char *missing, long count)
+{
+    char label[64];
+    t_hash_map *map = hash_map_create_with_options(options);
+    long found = 0;
+
+    double start = bench_now_seconds();
+    for (long i = 0; i < count; i++)
+        hash_map_put(map, &keys[i * KEY_LENGTH], &keys[i * KEY_LENGTH]);
+    snprintf(label, sizeof(label), "%s put", name);
+    bench_report(label, count, bench_now_seconds() - start);
+
+    start = bench_now_seconds();
+    for (long i = 0; i < count; i++)
+        found += hash_map_get(map, &keys[i * KEY_LENGTH]) != NULL;
+    snprintf(label, sizeof(label), "%s get (hit)", name);
+    bench_report(label, count, bench_now_seconds() - start);
+
+    start = bench_now_seconds();
+    for (long i = 0; i < count; i++)
+        found += hash_map_get(map, &missing[i * KEY_LENGTH]) != NULL;
+    snprintf(label, sizeof(label), "%s get (miss)", name);
+    bench_report(label, count, bench_now_seconds() - start);
+
+    start = bench_now_seconds();
+    for (long i = 0; i < count; i++)
+        hash_map_remove(map, &keys[i * KEY_LENGTH]);
+    snprintf(label, sizeof(label), "%s remove", name);
+    bench_report(label, count, bench_now_seconds() - start);
+
+    if (found != count)
+        fprintf(stderr, "%s: expected %ld hits, got %ld\n", name, count, found);
+    hash_map_destroy(map);
+}
+
+int main(int argc, char **argv)
+{
+    long count = bench_arg_or_default(argc, argv, 1, 10000000);
+    char *keys = generate_keys(count, "key:");
+    char *missing = generate_keys(count, "nope:");
+    if (!keys || !missing)
+    {
+        fprintf(stderr, "Not enough memory for %ld keys\n", count);
+        return 1;
+    }
+    shuffle_keys(keys, count);
+    shuffle_keys(missing, count);
+
+    run("chaining", (t_hash_map_options){.type = HASH_MAP_CHAINING}, keys, missing, count);
+    run("open addressing", (t_hash_map_options){.type = HASH_MAP_OPEN_ADDRESSING}, keys, missing, count);
+    run("swiss table", (t_hash_map_options){.type = HASH_MAP_SWISS_TABLE}, keys, missing, count);
+    run("chaining, arena keys", (t_hash_map_options){.key_storage = HASH_MAP_KEYS_ARENA}, keys, missing, count);
+    run("swiss table, arena keys",
+        (t_hash_map_options){.type = HASH_MAP_SWISS_TABLE, .key_storage = HASH_MAP_KEYS_ARENA}, keys, missing, count);
+    run("swiss table, borrowed keys",
+        (t_hash_map_options){.type = HASH_MAP_SWISS_TABLE, .key_storage = HASH_MAP_KEYS_BORROWED}, keys, missing, count);
+    run("chaining, fnv1a", (t_hash_map_options){.hash_function = hash_fnv1a}, keys, missing, count);
+    run("chaining, wyhash", (t_hash_map_options){.hash_function = hash_wy}, keys, missing, count);
+    run("swiss table, wyhash",
+        (t_hash_map_options){.type = HASH_MAP_SWISS_TABLE, .hash_function = hash_wy}, keys, missing, count);
+
+    free(keys);
+    free(missing);
+    return 0;
+}
@@ -0,0 +1,35 @@
+#include "bench_utils.h"
+#include "main/collections/map/hashmap.h"
+
+// usage: hash_map_latency_bench [key_count]
+// per put latency of a chaining map growing from empty, with stop the world and incremental rehash
+
+#define KEY_LENGTH 16
+
+static void run(const char *name, t_hash_map_options options, long count)
+{
+    t_hash_map *map = hash_map_create_with_options(options);
+    double *samples = malloc(count * sizeof(double));
+    char key[KEY_LENGTH];
+
+    for (long i = 0; i < count; i++)
+    {
+        snprintf(key, KEY_LENGTH, "key:%u", (unsigned)i);
+        double start = bench_now_seconds();
+        hash_map_put(map, key, map);
+        samples[i] = bench_now_seconds() - start;
+    }
+
+    bench_report_latencies(name, samples, count);
+    free(samples);
+    hash_map_destroy(map);
+}
+
+int main(int argc, char **argv)
+{
+    long count = bench_arg_or_default(argc, argv, 1, 5000000);
+
+    run("chaining put", (t_hash_map_options){0}, count);
+    run("chaining put (incremental rehash)", (t_hash_map_options){.incremental_rehash = true}, count);
+    return 0;
+}
@@ -0,0 +1,50 @@
+#include "bench_utils.h"
+#include "main/collections/list/linked_list.h"
+
+// usage: linked_list_index_bench [count] [operations]
+// random positional get, add_to_index and remove on a list of count elements, walking the
+// nodes against going through the skip list index
+
+static void bench_list(const char *kind, long count, long operations, bool indexed)
+{
+    int value = 0;
+    char label[64];
+    t_linked_list *list = linked_list_create();
+    if (indexed)
+        linked_list_enable_index(list);
+    for (long i = 0; i < count; i++)
+        linked_list_add(list, &value);
+
+    unsigned int random_state = 42;
+    void *buffer;
+    double start = bench_now_seconds();
+    for (long i = 0; i < operations; i++)
+    {
+        random_state = random_state * 1103515245 + 12345;
+        linked_list_get(list, (int)((random_state >> 1) % count), &buffer);
+    }
+    snprintf(label, sizeof(label), "%s get %ld", kind, count);
+    bench_report(label, operations, bench_now_seconds() - start);
+
+    start = bench_now_seconds();
+    for (long i = 0; i < operations; i++)
+    {
+        random_state = random_state * 1103515245 + 12345;
+        int position = (int)((random_state >> 1) % count);
+        linked_list_add_to_index(list, position, &value);
+        linked_list_remove(list, position, &buffer);
+    }
+    snprintf(label, sizeof(label), "%s add_to_index+remove %ld", kind, count);
+    bench_report(label, operations, bench_now_seconds() - start);
+
+    linked_list_destroy(list);
+}
+
+int main(int argc, char **argv)
+{
+    long count = bench_arg_or_default(argc, argv, 1, 100000);
+    long operations = bench_arg_or_default(argc, argv, 2, 20000);
+    bench_list("walk", count, operations, false);
+    bench_list("index", count, operations, true);
+    return 0;
+}
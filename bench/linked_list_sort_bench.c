@@ -0,0 +1,66 @@
+#include <stdint.h>
+#include "bench_utils.h"
+#include "main/collections/list/linked_list.h"
+
+// usage: linked_list_sort_bench [max_count]
+// linked_list_sort_in_place (bottom-up merge relinking nodes) against linked_list_sort
+// (through a temporary array) for growing list sizes, on nodes added in random order
+
+static bool int_less_than(void *a, void *b)
+{
+    return *(int *)a < *(int *)b;
+}
+
+static t_linked_list *random_list(int *values, long count)
+{
+    t_linked_list *list = linked_list_create();
+    unsigned int random_state = 42;
+    for (long i = 0; i < count; i++)
+    {
+        random_state = random_state * 1103515245 + 12345;
+        values[i] = (int)(random_state >> 1);
+        linked_list_add(list, &values[i]);
+    }
+    return list;
+}
+
+static void bench_size(long count)
+{
+    int *values = malloc(count * sizeof(int));
+    char label[64];
+    // enough repetitions that small sizes still take measurable time
+    long repetitions = 4000000 / count > 0 ? 4000000 / count : 1;
+
+    double elapsed = 0;
+    for (long r = 0; r < repetitions; r++)
+    {
+        t_linked_list *list = random_list(values, count);
+        double start = bench_now_seconds();
+        linked_list_sort_in_place(list, int_less_than);
+        elapsed += bench_now_seconds() - start;
+        linked_list_destroy(list);
+    }
+    snprintf(label, sizeof(label), "sort_in_place %ld", count);
+    bench_report(label, count * repetitions, elapsed);
+
+    elapsed = 0;
+    for (long r = 0; r < repetitions; r++)
+    {
+        t_linked_list *list = random_list(values, count);
+        double start = bench_now_seconds();
+        linked_list_sort(list, int_less_than);
+        elapsed += bench_now_seconds() - start;
+        linked_list_destroy(list);
+    }
+    snprintf(label, sizeof(label), "sort %ld", count);
+    bench_report(label, count * repetitions, elapsed);
+    free(values);
+}
+
+int main(int argc, char **argv)
+{
+    long max_count = bench_arg_or_default(argc, argv, 1, 1000000);
+    for (long count = 4; count <= max_count; count *= 4)
+        bench_size(count);
+    return 0;
+}
@@ -0,0 +1,94 @@
+#include <stdint.h>
+#include "bench_utils.h"
+#include "main/collections/list/array_list.h"
+#include "main/collections/list/linked_list.h"
+#include "main/concurrency/thread_pool.h"
+
+// usage: parallel_sort_bench [count] [max_threads]
+// qsort and array_list_sort on one thread, then array_list_parallel_sort and
+// linked_list_parallel_sort on pools of 1, 2, 4 ... max_threads workers, all on the same
+// random ints. Scaling stops at the number of cores, past it only the overhead shows
+
+static bool int_less_than(void *a, void *b)
+{
+    return *(int *)a < *(int *)b;
+}
+
+static int compare_int_pointers(const void *a, const void *b)
+{
+    int x = **(int *const *)a;
+    int y = **(int *const *)b;
+    return (x > y) - (x < y);
+}
+
+static void shuffle_into(t_array_list *list, int *values, long count)
+{
+    unsigned int random_state = 42;
+    array_list_clean(list);
+    for (long i = 0; i < count; i++)
+    {
+        random_state = random_state * 1103515245 + 12345;
+        values[i] = (int)(random_state >> 1);
+        array_list_add(list, &values[i]);
+    }
+}
+
+static void check_sorted(const char *name, void **elements, long count)
+{
+    for (long i = 1; i < count; i++)
+    {
+        if (int_less_than(elements[i], elements[i - 1]))
+        {
+            fprintf(stderr, "%s left the elements unsorted at %ld\n", name, i);
+            return;
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    long count = bench_arg_or_default(argc, argv, 1, 4000000);
+    int max_threads = bench_arg_or_default(argc, argv, 2, 64);
+    int *values = malloc(count * sizeof(int));
+    t_array_list *list = array_list_create_with_capacity(count);
+    char label[64];
+
+    shuffle_into(list, values, count);
+    double start = bench_now_seconds();
+    qsort(list->array, count, sizeof(void *), compare_int_pointers);
+    bench_report("qsort", count, bench_now_seconds() - start);
+
+    shuffle_into(list, values, count);
+    start = bench_now_seconds();
+    array_list_sort(list, int_less_than);
+    bench_report("array_list_sort", count, bench_now_seconds() - start);
+    check_sorted("array_list_sort", list->array, count);
+
+    for (int threads = 1; threads <= max_threads; threads *= 2)
+    {
+        t_thread_pool *pool = thread_pool_create(threads);
+
+        shuffle_into(list, values, count);
+        start = bench_now_seconds();
+        array_list_parallel_sort(list, pool, int_less_than);
+        snprintf(label, sizeof(label), "array_list_parallel_sort %d threads", threads);
+        bench_report(label, count, bench_now_seconds() - start);
+        check_sorted(label, list->array, count);
+
+        t_linked_list *linked = linked_list_create();
+        shuffle_into(list, values, count);
+        for (long i = 0; i < count; i++)
+            linked_list_add(linked, list->array[i]);
+        start = bench_now_seconds();
+        linked_list_parallel_sort(linked, pool, int_less_than);
+        snprintf(label, sizeof(label), "linked_list_parallel_sort %d threads", threads);
+        bench_report(label, count, bench_now_seconds() - start);
+        linked_list_destroy(linked);
+
+        thread_pool_destroy(pool);
+    }
+
+    array_list_destroy(list);
+    free(values);
+    return 0;
+}
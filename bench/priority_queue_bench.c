@@ -0,0 +1,102 @@
+#include <stdint.h>
+#include "bench_utils.h"
+#include "main/collections/list/linked_list.h"
+#include "main/collections/queue/priority_queue.h"
+
+// usage: priority_queue_bench [count]
+// count random ints pushed then popped in order: a t_linked_list kept sorted with
+// linked_list_add_sorted against the 4-ary heap t_priority_queue. Then heapify from a
+// t_array_list against one push per element, and decrease-key on random handles
+
+static bool int_less_than(void *a, void *b)
+{
+    return *(int *)a < *(int *)b;
+}
+
+static void bench_sorted_list(int *values, long count)
+{
+    t_linked_list *list = linked_list_create();
+    void *out;
+
+    double start = bench_now_seconds();
+    for (long i = 0; i < count; i++)
+        linked_list_add_sorted(list, &values[i], int_less_than);
+    for (long i = 0; i < count; i++)
+        linked_list_remove(list, 0, &out);
+    bench_report("linked_list_add_sorted + remove(0)", count, bench_now_seconds() - start);
+    linked_list_destroy(list);
+}
+
+static void bench_priority_queue(int *values, long count)
+{
+    t_priority_queue *queue = priority_queue_create(int_less_than);
+    void *out;
+
+    double start = bench_now_seconds();
+    for (long i = 0; i < count; i++)
+        priority_queue_push(queue, &values[i]);
+    for (long i = 0; i < count; i++)
+        priority_queue_pop(queue, &out);
+    bench_report("priority_queue push + pop", count, bench_now_seconds() - start);
+    priority_queue_destroy(queue);
+}
+
+static void bench_heapify(int *values, long count)
+{
+    t_array_list *list = array_list_create_with_capacity(count);
+    for (long i = 0; i < count; i++)
+        array_list_add(list, &values[i]);
+
+    double start = bench_now_seconds();
+    t_priority_queue *queue = priority_queue_create(int_less_than);
+    for (long i = 0; i < count; i++)
+        priority_queue_push(queue, &values[i]);
+    bench_report("priority_queue one push each", count, bench_now_seconds() - start);
+    priority_queue_destroy(queue);
+
+    start = bench_now_seconds();
+    queue = priority_queue_create_from_array_list(list, int_less_than);
+    bench_report("priority_queue from array list", count, bench_now_seconds() - start);
+
+    // handles are the list indexes, lower random elements by half their value
+    unsigned int random_state = 12345;
+    start = bench_now_seconds();
+    for (long i = 0; i < count; i++)
+    {
+        random_state = random_state * 1103515245 + 12345;
+        long index = (random_state >> 8) % count;
+        values[index] /= 2;
+        priority_queue_decrease_key(queue, index);
+    }
+    bench_report("priority_queue decrease_key", count, bench_now_seconds() - start);
+
+    priority_queue_destroy(queue);
+    array_list_destroy(list);
+}
+
+static void fill_random(int *values, long count)
+{
+    unsigned int random_state = 42;
+    for (long i = 0; i < count; i++)
+    {
+        random_state = random_state * 1103515245 + 12345;
+        values[i] = (int)(random_state >> 1);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    long count = bench_arg_or_default(argc, argv, 1, 1000000);
+    // the sorted list is quadratic, it gets a smaller share
+    long list_count = count / 50 > 0 ? count / 50 : 1;
+    int *values = malloc(count * sizeof(int));
+
+    fill_random(values, list_count);
+    bench_sorted_list(values, list_count);
+    bench_priority_queue(values, list_count);
+    fill_random(values, count);
+    bench_priority_queue(values, count);
+    bench_heapify(values, count);
+    free(values);
+    return 0;
+}
@@ -0,0 +1,66 @@
+#include "bench_utils.h"
+#include "main/collections/queue/queue.h"
+#include "main/collections/stack/stack.h"
+
+// usage: queue_stack_bench [operations] [depth]
+// push/pop throughput of t_queue and t_stack: a steady state where the container oscillates
+// around depth elements, then a fill to operations elements and a full drain
+
+static void bench_queue(long operations, long depth)
+{
+    t_queue *queue = queue_create();
+    void *out;
+
+    for (long i = 0; i < depth; i++)
+        queue_push(queue, queue);
+    double start = bench_now_seconds();
+    for (long i = 0; i < operations; i++)
+    {
+        queue_push(queue, queue);
+        queue_pop(queue, &out);
+    }
+    bench_report("queue push+pop (steady)", operations, bench_now_seconds() - start);
+    queue_clean(queue);
+
+    start = bench_now_seconds();
+    for (long i = 0; i < operations; i++)
+        queue_push(queue, queue);
+    while (!queue_is_empty(queue))
+        queue_pop(queue, &out);
+    bench_report("queue fill then drain", operations, bench_now_seconds() - start);
+    queue_destroy(queue);
+}
+
+static void bench_stack(long operations, long depth)
+{
+    t_stack *stack = stack_create();
+    void *out;
+
+    for (long i = 0; i < depth; i++)
+        stack_push(stack, stack);
+    double start = bench_now_seconds();
+    for (long i = 0; i < operations; i++)
+    {
+        stack_push(stack, stack);
+        stack_pop(stack, &out);
+    }
+    bench_report("stack push+pop (steady)", operations, bench_now_seconds() - start);
+    stack_clean(stack);
+
+    start = bench_now_seconds();
+    for (long i = 0; i < operations; i++)
+        stack_push(stack, stack);
+    while (!stack_is_empty(stack))
+        stack_pop(stack, &out);
+    bench_report("stack fill then drain", operations, bench_now_seconds() - start);
+    stack_destroy(stack);
+}
+
+int main(int argc, char **argv)
+{
+    long operations = bench_arg_or_default(argc, argv, 1, 10000000);
+    long depth = bench_arg_or_default(argc, argv, 2, 1000);
+    bench_queue(operations, depth);
+    bench_stack(operations, depth);
+    return 0;
+}
@@ -0,0 +1,102 @@
+#include <stdint.h>
+#include "bench_utils.h"
+#include "main/collections/tree/red_black_tree.h"
+
+// usage: rb_tree_bench [count]
+// insert, find and remove of count keys in random order: 8 byte integers and 16 byte
+// strings, each with a less than comparator, a three-way one and the built-in
+
+static bool int64_less_than(void *a, void *b)
+{
+    return *(int64_t *)a < *(int64_t *)b;
+}
+
+static int int64_compare(const void *a, const void *b)
+{
+    int64_t x = *(const int64_t *)a;
+    int64_t y = *(const int64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static bool string_less_than(void *a, void *b)
+{
+    return strcmp(a, b) < 0;
+}
+
+static int string_compare(const void *a, const void *b)
+{
+    return strcmp(a, b);
+}
+
+static void bench_tree(const char *kind, t_rb_tree *tree, char *keys, size_t key_size, long count)
+{
+    char label[64];
+    double start = bench_now_seconds();
+    for (long i = 0; i < count; i++)
+        rb_tree_insert(tree, (t_key){.data = keys + i * key_size, .size = key_size}, NULL);
+    snprintf(label, sizeof(label), "%s insert", kind);
+    bench_report(label, count, bench_now_seconds() - start);
+
+    long found = 0;
+    start = bench_now_seconds();
+    for (long i = count - 1; i >= 0; i--)
+        found += rb_tree_find(tree, keys + i * key_size, NULL);
+    snprintf(label, sizeof(label), "%s find", kind);
+    bench_report(label, count, bench_now_seconds() - start);
+
+    start = bench_now_seconds();
+    for (long i = 0; i < count; i++)
+        found -= rb_tree_remove(tree, keys + i * key_size, NULL);
+    snprintf(label, sizeof(label), "%s remove", kind);
+    bench_report(label, count, bench_now_seconds() - start);
+
+    if (found != 0 || !rb_tree_is_empty(tree))
+        printf("tree lost keys\n");
+    rb_tree_destroy(tree);
+}
+
+int main(int argc, char **argv)
+{
+    long count = bench_arg_or_default(argc, argv, 1, 1000000);
+    if (count <= 0)
+    {
+        fprintf(stderr, "count must be positive, got %ld\n", count);
+        return 1;
+    }
+    int64_t *numbers = malloc((size_t)count * sizeof(int64_t));
+    // the same order as strings sharing a long prefix, the case where comparisons cost most
+    char *strings = malloc((size_t)count * 16);
+    if (!numbers || !strings)
+    {
+        fprintf(stderr, "Not enough memory for %ld keys\n", count);
+        free(numbers);
+        free(strings);
+        return 1;
+    }
+    for (long i = 0; i < count; i++)
+        numbers[i] = i;
+    // random order, so the tree is not built from sorted input
+    uint64_t random_state = 88172645463325252ull;
+    for (long i = count - 1; i > 0; i--)
+    {
+        random_state ^= random_state << 13;
+        random_state ^= random_state >> 7;
+        random_state ^= random_state << 17;
+        long j = (long)(random_state % (uint64_t)(i + 1));
+        int64_t swap = numbers[i];
+        numbers[i] = numbers[j];
+        numbers[j] = swap;
+    }
+    for (long i = 0; i < count; i++)
+        snprintf(strings + i * 16, 16, "key:%010lld", (long long)numbers[i]);
+
+    bench_tree("int64 less than", rbt_tree_create(int64_less_than), (char *)numbers, sizeof(int64_t), count);
+    bench_tree("int64 three-way", rbt_tree_create_with_cmp(int64_compare), (char *)numbers, sizeof(int64_t), count);
+    bench_tree("int64 built-in", rbt_tree_create_with_cmp(rb_tree_compare_int64), (char *)numbers, sizeof(int64_t), count);
+    bench_tree("string less than", rbt_tree_create(string_less_than), strings, 16, count);
+    bench_tree("string three-way", rbt_tree_create_with_cmp(string_compare), strings, 16, count);
+    bench_tree("string built-in", rbt_tree_create_with_cmp(rb_tree_compare_string), strings, 16, count);
+    free(numbers);
+    free(strings);
+    return 0;
+}
@@ -0,0 +1,96 @@
+#include "bench_utils.h"
+#include "main/collections/tree/red_black_tree.h"
+
+// usage: rb_tree_bulk_bench [count]
+// filling a tree with count int keys: rb_tree_insert one by one against
+// rb_tree_build_from_sorted for sorted keys and rb_tree_insert_batch for shuffled ones
+
+static long checksum;
+
+static void sum_key(void *key, void *value)
+{
+    (void)value;
+    checksum += *(int *)key;
+}
+
+static void time_lookups(const char *name, t_rb_tree *tree, long count)
+{
+    double start = bench_now_seconds();
+    for (long i = 0; i < count; i++)
+    {
+        int key = (int)((i * 7919) % count);
+        void *found;
+        checksum += rb_tree_find(tree, &key, &found);
+    }
+    bench_report(name, count, bench_now_seconds() - start);
+    start = bench_now_seconds();
+    rb_tree_iterate_inorder(tree, sum_key);
+    char walk[64];
+    snprintf(walk, sizeof(walk), "%s walk", name);
+    bench_report(walk, count, bench_now_seconds() - start);
+}
+
+int main(int argc, char **argv)
+{
+    long count = bench_arg_or_default(argc, argv, 1, 1000000);
+    int *sorted = malloc(count * sizeof(int));
+    int *shuffled = malloc(count * sizeof(int));
+    t_key *sorted_keys = malloc(count * sizeof(t_key));
+    t_key *shuffled_keys = malloc(count * sizeof(t_key));
+    for (long i = 0; i < count; i++)
+    {
+        sorted[i] = (int)i;
+        shuffled[i] = (int)i;
+    }
+    unsigned int random_state = 2463534242u;
+    for (long i = count - 1; i > 0; i--)
+    {
+        random_state ^= random_state << 13;
+        random_state ^= random_state >> 17;
+        random_state ^= random_state << 5;
+        long j = random_state % (i + 1);
+        int swap = shuffled[i];
+        shuffled[i] = shuffled[j];
+        shuffled[j] = swap;
+    }
+    for (long i = 0; i < count; i++)
+    {
+        sorted_keys[i] = (t_key){.data = &sorted[i], .size = sizeof(int)};
+        shuffled_keys[i] = (t_key){.data = &shuffled[i], .size = sizeof(int)};
+    }
+
+    t_rb_tree *tree = rbt_tree_create_with_cmp(rb_tree_compare_int);
+    double start = bench_now_seconds();
+    for (long i = 0; i < count; i++)
+        rb_tree_insert(tree, sorted_keys[i], NULL);
+    bench_report("sorted insert one by one", count, bench_now_seconds() - start);
+    time_lookups("one by one find", tree, count);
+    rb_tree_destroy(tree);
+
+    tree = rbt_tree_create_with_cmp(rb_tree_compare_int);
+    start = bench_now_seconds();
+    rb_tree_build_from_sorted(tree, sorted_keys, NULL, (int)count);
+    bench_report("rb_tree_build_from_sorted", count, bench_now_seconds() - start);
+    time_lookups("bulk built find", tree, count);
+    rb_tree_destroy(tree);
+
+    tree = rbt_tree_create_with_cmp(rb_tree_compare_int);
+    start = bench_now_seconds();
+    for (long i = 0; i < count; i++)
+        rb_tree_insert(tree, shuffled_keys[i], NULL);
+    bench_report("shuffled insert one by one", count, bench_now_seconds() - start);
+    rb_tree_destroy(tree);
+
+    tree = rbt_tree_create_with_cmp(rb_tree_compare_int);
+    start = bench_now_seconds();
+    rb_tree_insert_batch(tree, shuffled_keys, NULL, (int)count);
+    bench_report("rb_tree_insert_batch", count, bench_now_seconds() - start);
+    rb_tree_destroy(tree);
+
+    printf("checksum %ld\n", checksum);
+    free(sorted);
+    free(shuffled);
+    free(sorted_keys);
+    free(shuffled_keys);
+    return 0;
+}
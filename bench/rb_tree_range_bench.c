@@ -0,0 +1,69 @@
+#include <stdint.h>
+#include "bench_utils.h"
+#include "main/collections/tree/red_black_tree.h"
+
+// usage: rb_tree_range_bench [count] [width]
+// the keys in [lo, lo + width) of a tree of count int keys: rb_tree_range against the old
+// way of dumping every key with rb_tree_iterate_preorder, sorting and picking the window
+
+static int *dumped;
+static long dumped_count;
+static long visited;
+
+static void dump_key(void *key, void *value)
+{
+    (void)value;
+    dumped[dumped_count++] = *(int *)key;
+}
+
+static void visit_key(void *key, void *value)
+{
+    (void)key;
+    (void)value;
+    visited++;
+}
+
+static int compare_ints(const void *a, const void *b)
+{
+    return rb_tree_compare_int(a, b);
+}
+
+int main(int argc, char **argv)
+{
+    long count = bench_arg_or_default(argc, argv, 1, 1000000);
+    long width = bench_arg_or_default(argc, argv, 2, 100);
+    t_rb_tree *tree = rbt_tree_create_with_cmp(rb_tree_compare_int);
+    for (long i = 0; i < count; i++)
+    {
+        int key = (int)((i * 2654435761u) % count);
+        rb_tree_insert(tree, (t_key){.data = &key, .size = sizeof(int)}, NULL);
+    }
+    dumped = malloc(rb_tree_size(tree) * sizeof(int));
+
+    long queries = 10;
+    double start = bench_now_seconds();
+    for (long q = 0; q < queries; q++)
+    {
+        int lo = (int)((q * 7919) % count);
+        dumped_count = 0;
+        rb_tree_iterate_preorder(tree, dump_key);
+        qsort(dumped, dumped_count, sizeof(int), compare_ints);
+        for (long i = 0; i < dumped_count && dumped[i] < lo + width; i++)
+            visited += dumped[i] >= lo;
+    }
+    bench_report("dump, sort and scan", queries, bench_now_seconds() - start);
+
+    queries = 100000;
+    start = bench_now_seconds();
+    for (long q = 0; q < queries; q++)
+    {
+        int lo = (int)((q * 7919) % count);
+        rb_tree_range(tree, &lo, &(int){lo + width - 1}, visit_key);
+    }
+    bench_report("rb_tree_range", queries, bench_now_seconds() - start);
+
+    printf("%ld keys visited\n", visited);
+    free(dumped);
+    rb_tree_destroy(tree);
+    return 0;
+}
@@ -0,0 +1,53 @@
+#include "bench_utils.h"
+#include "main/collections/tree/red_black_tree.h"
+
+// usage: rb_tree_rank_bench [count]
+// the k-th smallest key and the rank of a key in a tree of count int keys: rb_tree_select and
+// rb_tree_rank against walking a cursor from the first key
+
+int main(int argc, char **argv)
+{
+    long count = bench_arg_or_default(argc, argv, 1, 1000000);
+    t_rb_tree *tree = rbt_tree_create_with_cmp(rb_tree_compare_int);
+    double start = bench_now_seconds();
+    for (long i = 0; i < count; i++)
+    {
+        int key = (int)((i * 2654435761u) % count);
+        rb_tree_insert(tree, (t_key){.data = &key, .size = sizeof(int)}, NULL);
+    }
+    bench_report("insert", count, bench_now_seconds() - start);
+
+    long checksum = 0;
+    long queries = 20;
+    start = bench_now_seconds();
+    for (long q = 0; q < queries; q++)
+    {
+        long k = (q * 7919) % count;
+        t_rb_tree_cursor cursor = rb_tree_first(tree);
+        for (long i = 0; i < k; i++)
+            rb_tree_cursor_next(&cursor);
+        checksum += *(int *)rb_tree_cursor_key(&cursor);
+    }
+    bench_report("cursor walk to k", queries, bench_now_seconds() - start);
+
+    queries = 1000000;
+    start = bench_now_seconds();
+    for (long q = 0; q < queries; q++)
+    {
+        t_rb_tree_cursor cursor = rb_tree_select(tree, (int)((q * 7919) % count));
+        checksum += *(int *)rb_tree_cursor_key(&cursor);
+    }
+    bench_report("rb_tree_select", queries, bench_now_seconds() - start);
+
+    start = bench_now_seconds();
+    for (long q = 0; q < queries; q++)
+    {
+        int key = (int)((q * 7919) % count);
+        checksum += rb_tree_rank(tree, &key);
+    }
+    bench_report("rb_tree_rank", queries, bench_now_seconds() - start);
+
+    printf("checksum %ld\n", checksum);
+    rb_tree_destroy(tree);
+    return 0;
+}
@@ -0,0 +1,72 @@
+#include "bench_utils.h"
+#include "main/collections/stream/stream.h"
+
+// usage: stream_bench [count] [repetitions]
+// filter -> map -> foldl over a linked list: the eager functions building a list per stage
+// against one fused stream pass, plus the same stream over an array list
+
+static int *doubled;
+
+static bool is_even(void *x)
+{
+    return *(int *)x % 2 == 0;
+}
+
+static void *twice(void *x)
+{
+    int i = *(int *)x;
+    doubled[i] = i * 2;
+    return &doubled[i];
+}
+
+static void *sum(void *acc, void *x)
+{
+    *(long *)acc += *(int *)x;
+    return acc;
+}
+
+int main(int argc, char **argv)
+{
+    long count = bench_arg_or_default(argc, argv, 1, 1000000);
+    long repetitions = bench_arg_or_default(argc, argv, 2, 20);
+    int *values = malloc(count * sizeof(int));
+    doubled = malloc(count * sizeof(int));
+    t_linked_list *linked = linked_list_create();
+    t_array_list *array = array_list_create();
+    for (long i = 0; i < count; i++)
+    {
+        values[i] = (int)i;
+        linked_list_add(linked, &values[i]);
+        array_list_add(array, &values[i]);
+    }
+
+    long eager = 0, lazy = 0, from_array = 0;
+    double start = bench_now_seconds();
+    for (long r = 0; r < repetitions; r++)
+    {
+        t_linked_list *evens = linked_list_filter(linked, is_even);
+        t_linked_list *mapped = linked_list_map(evens, twice);
+        linked_list_foldl(mapped, &eager, sum);
+        linked_list_destroy(evens);
+        linked_list_destroy(mapped);
+    }
+    bench_report("eager filter/map/foldl", count * repetitions, bench_now_seconds() - start);
+
+    start = bench_now_seconds();
+    for (long r = 0; r < repetitions; r++)
+        stream_foldl(stream_map(stream_filter(stream_from_linked_list(linked), is_even), twice), &lazy, sum);
+    bench_report("stream over linked list", count * repetitions, bench_now_seconds() - start);
+
+    start = bench_now_seconds();
+    for (long r = 0; r < repetitions; r++)
+        stream_foldl(stream_map(stream_filter(stream_from_array_list(array), is_even), twice), &from_array, sum);
+    bench_report("stream over array list", count * repetitions, bench_now_seconds() - start);
+
+    if (eager != lazy || lazy != from_array)
+        printf("results differ: %ld %ld %ld\n", eager, lazy, from_array);
+    linked_list_destroy(linked);
+    array_list_destroy(array);
+    free(values);
+    free(doubled);
+    return 0;
+}
@@ -0,0 +1,78 @@
+#include <stdint.h>
+#include "bench_utils.h"
+#include "main/collections/list/array_list.h"
+#include "main/collections/list/linked_list.h"
+#include "main/concurrency/thread_pool.h"
+
+// usage: thread_pool_bench [elements] [workers]
+// foreach against parallel_foreach over the same elements, for t_array_list and t_linked_list.
+// Elements cost uneven amounts of work (up to 64x apart), the case work stealing evens out.
+// workers 0 means one per online cpu
+
+typedef struct
+{
+    uint64_t seed;
+    int rounds;
+} t_work_item;
+
+static void do_work(void *arg)
+{
+    t_work_item *item = arg;
+    uint64_t x = item->seed;
+    for (int i = 0; i < item->rounds; i++)
+    {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+    }
+    item->seed = x;
+}
+
+static void bench_lists(t_thread_pool *pool, long count)
+{
+    t_array_list *array = array_list_create_with_capacity(count);
+    t_linked_list *linked = linked_list_create();
+    t_work_item *items = malloc(count * sizeof(t_work_item));
+    for (long i = 0; i < count; i++)
+    {
+        // the expensive ones bunch up at the end of every block of 4096
+        items[i] = (t_work_item){.seed = i + 1, .rounds = 16 + (int)(i % 4096) / 64 * 16};
+        array_list_add(array, &items[i]);
+        linked_list_add(linked, &items[i]);
+    }
+
+    double start = bench_now_seconds();
+    array_list_foreach(array, do_work);
+    bench_report("array list foreach", count, bench_now_seconds() - start);
+
+    start = bench_now_seconds();
+    array_list_parallel_foreach(array, pool, do_work);
+    bench_report("array list parallel_foreach", count, bench_now_seconds() - start);
+
+    start = bench_now_seconds();
+    linked_list_foreach(linked, do_work);
+    bench_report("linked list foreach", count, bench_now_seconds() - start);
+
+    start = bench_now_seconds();
+    linked_list_parallel_foreach(linked, pool, do_work);
+    bench_report("linked list parallel_foreach", count, bench_now_seconds() - start);
+
+    uint64_t checksum = 0;
+    for (long i = 0; i < count; i++)
+        checksum ^= items[i].seed;
+    printf("checksum %llx\n", (unsigned long long)checksum);
+
+    array_list_destroy(array);
+    linked_list_destroy(linked);
+    free(items);
+}
+
+int main(int argc, char **argv)
+{
+    long count = bench_arg_or_default(argc, argv, 1, 1000000);
+    t_thread_pool *pool = thread_pool_create(bench_arg_or_default(argc, argv, 2, 0));
+    printf("%d workers\n", thread_pool_size(pool));
+    bench_lists(pool, count);
+    thread_pool_destroy(pool);
+    return 0;
+}
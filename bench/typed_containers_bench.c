@@ -0,0 +1,108 @@
+#include <stdint.h>
+#include "bench_utils.h"
+#include "main/collections/list/array_list.h"
+#include "main/collections/list/typed_array_list.h"
+#include "main/collections/map/hashmap.h"
+#include "main/collections/map/typed_hash_map.h"
+
+// usage: typed_containers_bench [count]
+// ints in a t_array_list / t_hash_map (boxed behind void*, keys printed as strings)
+// against the DEFINE_ARRAY_LIST / DEFINE_HASH_MAP specializations storing them inline
+
+#define KEY_LENGTH 24
+
+DEFINE_ARRAY_LIST(int32_t, i32)
+DEFINE_HASH_MAP(uint64_t, int64_t, u64_i64)
+
+static void bench_array_lists(long count)
+{
+    t_array_list *boxed = array_list_create();
+    t_array_list_i32 *typed = array_list_i32_create();
+    long long sum = 0;
+
+    double start = bench_now_seconds();
+    for (long i = 0; i < count; i++)
+    {
+        int32_t *value = malloc(sizeof(int32_t));
+        *value = (int32_t)i;
+        array_list_add(boxed, value);
+    }
+    bench_report("array list void* add", count, bench_now_seconds() - start);
+
+    start = bench_now_seconds();
+    for (long i = 0; i < count; i++)
+    {
+        int32_t *value;
+        array_list_get(boxed, i, (void **)&value);
+        sum += *value;
+    }
+    bench_report("array list void* get", count, bench_now_seconds() - start);
+
+    start = bench_now_seconds();
+    for (long i = 0; i < count; i++)
+        array_list_i32_add(typed, (int32_t)i);
+    bench_report("array list i32 add", count, bench_now_seconds() - start);
+
+    start = bench_now_seconds();
+    for (long i = 0; i < count; i++)
+    {
+        int32_t value = 0;
+        array_list_i32_get(typed, i, &value);
+        sum -= value;
+    }
+    bench_report("array list i32 get", count, bench_now_seconds() - start);
+
+    if (sum != 0)
+        fprintf(stderr, "array lists disagree: %lld\n", sum);
+    array_list_destroy_and_destroy_elements(boxed, free);
+    array_list_i32_destroy(typed);
+}
+
+static void bench_hash_maps(long count)
+{
+    t_hash_map *boxed = hash_map_create_with_options((t_hash_map_options){.type = HASH_MAP_OPEN_ADDRESSING});
+    t_hash_map_u64_i64 *typed = hash_map_u64_i64_create();
+    char key[KEY_LENGTH];
+    long long sum = 0;
+
+    double start = bench_now_seconds();
+    for (long i = 0; i < count; i++)
+    {
+        int64_t *value = malloc(sizeof(int64_t));
+        *value = i;
+        snprintf(key, KEY_LENGTH, "%lu", (unsigned long)i * 2654435761u);
+        hash_map_put(boxed, key, value);
+    }
+    bench_report("hash map void* put", count, bench_now_seconds() - start);
+
+    start = bench_now_seconds();
+    for (long i = 0; i < count; i++)
+    {
+        snprintf(key, KEY_LENGTH, "%lu", (unsigned long)i * 2654435761u);
+        sum += *(int64_t *)hash_map_get(boxed, key);
+    }
+    bench_report("hash map void* get", count, bench_now_seconds() - start);
+
+    start = bench_now_seconds();
+    for (long i = 0; i < count; i++)
+        hash_map_u64_i64_put(typed, (uint64_t)i * 2654435761u, i);
+    bench_report("hash map u64 -> i64 put", count, bench_now_seconds() - start);
+
+    start = bench_now_seconds();
+    for (long i = 0; i < count; i++)
+        sum -= *hash_map_u64_i64_get(typed, (uint64_t)i * 2654435761u);
+    bench_report("hash map u64 -> i64 get", count, bench_now_seconds() - start);
+
+    if (sum != 0)
+        fprintf(stderr, "hash maps disagree: %lld\n", sum);
+    hash_map_destroy_and_destroy_elements(boxed, free);
+    hash_map_u64_i64_destroy(typed);
+}
+
+int main(int argc, char **argv)
+{
+    long count = bench_arg_or_default(argc, argv, 1, 5000000);
+    bench_array_lists(count);
+    bench_hash_maps(count);
+    return 0;
+}
@@ -0,0 +1,106 @@
+#include <stdint.h>
+#include "bench_utils.h"
+#include "main/collections/list/array_list.h"
+#include "main/collections/list/linked_list.h"
+#include "main/collections/list/unrolled_list.h"
+
+// usage: unrolled_list_bench [count] [middle_inserts]
+// t_linked_list, t_unrolled_list and t_array_list built by inserting at random positions
+// (so linked nodes end up scattered in memory), then walked with foreach and filter,
+// and a few inserts in the middle of the full lists
+
+static long long total;
+
+static void add_to_total(void *x)
+{
+    total += (long long)(uintptr_t)x;
+}
+
+static bool is_even(void *x)
+{
+    return (uintptr_t)x % 2 == 0;
+}
+
+static unsigned int next_random(unsigned int *state)
+{
+    *state = *state * 1103515245 + 12345;
+    return *state >> 8;
+}
+
+int main(int argc, char **argv)
+{
+    long count = bench_arg_or_default(argc, argv, 1, 100000);
+    long middle_inserts = bench_arg_or_default(argc, argv, 2, 10000);
+    t_linked_list *linked = linked_list_create();
+    t_unrolled_list *unrolled = unrolled_list_create();
+    t_array_list *array = array_list_create();
+    unsigned int random_state;
+
+    random_state = 1;
+    double start = bench_now_seconds();
+    for (long i = 0; i < count; i++)
+        linked_list_add_to_index(linked, next_random(&random_state) % (i + 1), (void *)(uintptr_t)(i + 1));
+    bench_report("linked list random position add", count, bench_now_seconds() - start);
+
+    random_state = 1;
+    start = bench_now_seconds();
+    for (long i = 0; i < count; i++)
+        unrolled_list_add_to_index(unrolled, next_random(&random_state) % (i + 1), (void *)(uintptr_t)(i + 1));
+    bench_report("unrolled list random position add", count, bench_now_seconds() - start);
+
+    random_state = 1;
+    start = bench_now_seconds();
+    for (long i = 0; i < count; i++)
+        array_list_add_to_index(array, next_random(&random_state) % (i + 1), (void *)(uintptr_t)(i + 1));
+    bench_report("array list random position add", count, bench_now_seconds() - start);
+
+    int rounds = 20;
+    start = bench_now_seconds();
+    for (int r = 0; r < rounds; r++)
+        linked_list_foreach(linked, add_to_total);
+    bench_report("linked list foreach", count * rounds, bench_now_seconds() - start);
+
+    start = bench_now_seconds();
+    for (int r = 0; r < rounds; r++)
+        unrolled_list_foreach(unrolled, add_to_total);
+    bench_report("unrolled list foreach", count * rounds, bench_now_seconds() - start);
+
+    start = bench_now_seconds();
+    for (int r = 0; r < rounds; r++)
+        array_list_foreach(array, add_to_total);
+    bench_report("array list foreach", count * rounds, bench_now_seconds() - start);
+
+    start = bench_now_seconds();
+    t_linked_list *linked_evens = linked_list_filter(linked, is_even);
+    bench_report("linked list filter", count, bench_now_seconds() - start);
+
+    start = bench_now_seconds();
+    t_unrolled_list *unrolled_evens = unrolled_list_filter(unrolled, is_even);
+    bench_report("unrolled list filter", count, bench_now_seconds() - start);
+
+    random_state = 2;
+    start = bench_now_seconds();
+    for (long i = 0; i < middle_inserts; i++)
+        linked_list_add_to_index(linked, next_random(&random_state) % count, NULL);
+    bench_report("linked list middle insert", middle_inserts, bench_now_seconds() - start);
+
+    random_state = 2;
+    start = bench_now_seconds();
+    for (long i = 0; i < middle_inserts; i++)
+        unrolled_list_add_to_index(unrolled, next_random(&random_state) % count, NULL);
+    bench_report("unrolled list middle insert", middle_inserts, bench_now_seconds() - start);
+
+    random_state = 2;
+    start = bench_now_seconds();
+    for (long i = 0; i < middle_inserts; i++)
+        array_list_add_to_index(array, next_random(&random_state) % count, NULL);
+    bench_report("array list middle insert", middle_inserts, bench_now_seconds() - start);
+
+    printf("checksum %lld\n", total);
+    linked_list_destroy(linked_evens);
+    unrolled_list_destroy(unrolled_evens);
+    linked_list_destroy(linked);
+    unrolled_list_destroy(unrolled);
+    array_list_destroy(array);
+    return 0;
+}
@@ -1,4 +1,70 @@
 #include "array_list.h"
+#include "../../concurrency/thread_pool.h"
+
+// [begin, end) of the array, split in halves until no bigger than grain
+typedef struct
+{
+    t_thread_pool *pool;
+    t_task_group *group;
+    void **array;
+    unsigned int begin;
+    unsigned int end;
+    unsigned int grain;
+    void (*operation)(void *);
+} t_foreach_range;
+
+// what every chunk of a parallel map, filter or reduce shares
+typedef struct
+{
+    void **source;
+    void **target;
+    // filter only: one flag per element, so condition runs once per element
+    bool *kept;
+    void *(*mapper)(void *);
+    bool (*condition)(void *);
+    void *(*operation)(void *, void *);
+} t_parallel_job;
+
+// [begin, end) of the source
+typedef struct
+{
+    t_parallel_job *job;
+    unsigned int begin;
+    unsigned int end;
+    // filter: how many elements the chunk keeps, then where the first one goes
+    unsigned int kept_count;
+    unsigned int offset;
+    // reduce: the chunk's elements folded together
+    void *partial;
+} t_chunk;
+
+// sorts [begin, end) of elements, leaving the result in buffer when into_buffer
+typedef struct
+{
+    t_thread_pool *pool;
+    void **elements;
+    void **buffer;
+    int begin;
+    int end;
+    int grain;
+    bool into_buffer;
+    bool (*comparator)(void *, void *);
+} t_sort_range;
+
+// merges the sorted [left_begin, left_end) and [right_begin, right_end) of from into to,
+// starting at out
+typedef struct
+{
+    t_thread_pool *pool;
+    void **from;
+    void **to;
+    int left_begin;
+    int left_end;
+    int right_begin;
+    int right_end;
+    int out;
+    bool (*comparator)(void *, void *);
+} t_merge_range;
 
 static bool index_out_of_bounds(t_array_list *self, int index);
 
@@ -14,6 +80,40 @@ static void shift_elements_to_left(t_array_list *self, int end);
 
 static t_list_error remove_element(t_array_list *self, int index, void **deleted, void (*element_destroyer)(void *));
 
+static void foreach_range(void *range);
+
+static t_chunk *split_in_chunks(t_array_list *self, t_thread_pool *pool, t_parallel_job *job, int *chunk_count);
+
+static void run_chunks(t_thread_pool *pool, t_chunk *chunks, int chunk_count, void (*run)(void *));
+
+static void map_chunk(void *chunk);
+
+static void mark_chunk(void *chunk);
+
+static void compact_chunk(void *chunk);
+
+static void reduce_chunk(void *chunk);
+
+static void introsort(void **elements, int count, int depth_limit, bool (*comparator)(void *, void *));
+
+static int partition(void **elements, int count, bool (*comparator)(void *, void *));
+
+static void insertion_sort(void **elements, int count, bool (*comparator)(void *, void *));
+
+static void swap_elements(void **elements, int a, int b);
+
+static void heap_sort(void **elements, int count, bool (*comparator)(void *, void *));
+
+static void heap_sift_down(void **elements, int index, int count, bool (*comparator)(void *, void *));
+
+static void sort_range(void *range);
+
+static void merge_range(void *range);
+
+static int first_not_before(void **elements, int begin, int end, void *pivot, bool (*comparator)(void *, void *));
+
+static int first_after(void **elements, int begin, int end, void *pivot, bool (*comparator)(void *, void *));
+
 t_array_list *array_list_create_with_capacity(unsigned int capacity)
 {
     t_array_list *array_list = malloc(sizeof(t_array_list));
@@ -77,6 +177,109 @@ void array_list_foreach(t_array_list *self, void (*operation)(void *))
     }
 }
 
+void array_list_parallel_foreach(t_array_list *self, t_thread_pool *pool, void (*operation)(void *))
+{
+    if (self->element_count == 0)
+        return;
+    t_task_group group;
+    task_group_init(&group);
+    t_foreach_range *range = malloc(sizeof(t_foreach_range));
+    if (!range)
+    {
+        array_list_foreach(self, operation);
+        return;
+    }
+    unsigned int grain = self->element_count / (thread_pool_size(pool) * THREAD_POOL_CHUNKS_PER_WORKER);
+    *range = (t_foreach_range){pool, &group, self->array, 0, self->element_count, grain ? grain : 1, operation};
+    // the calling thread takes the first piece itself, then helps with the rest
+    foreach_range(range);
+    thread_pool_join(pool, &group);
+}
+
+t_array_list *array_list_parallel_map(t_array_list *self, t_thread_pool *pool, void *(*mapper)(void *))
+{
+    unsigned int count = self->element_count;
+    t_array_list *result = array_list_create_with_capacity(count > 0 ? count : BASE_CAPACITY);
+    if (!result)
+        return NULL;
+    t_parallel_job job = {.source = self->array, .target = result->array, .mapper = mapper};
+    int chunk_count;
+    t_chunk *chunks = split_in_chunks(self, pool, &job, &chunk_count);
+    if (!chunks)
+    {
+        for (unsigned int i = 0; i < count; i++)
+            result->array[i] = mapper(self->array[i]);
+    }
+    else
+    {
+        run_chunks(pool, chunks, chunk_count, map_chunk);
+        free(chunks);
+    }
+    result->element_count = count;
+    return result;
+}
+
+t_array_list *array_list_parallel_filter(t_array_list *self, t_thread_pool *pool, bool (*condition)(void *))
+{
+    unsigned int count = self->element_count;
+    t_parallel_job job = {.source = self->array, .kept = malloc(count > 0 ? count : 1), .condition = condition};
+    int chunk_count;
+    t_chunk *chunks = job.kept ? split_in_chunks(self, pool, &job, &chunk_count) : NULL;
+    if (!chunks)
+    {
+        free(job.kept);
+        t_array_list *result = array_list_create();
+        for (unsigned int i = 0; result && i < count; i++)
+        {
+            if (condition(self->array[i]))
+                array_list_add(result, self->array[i]);
+        }
+        return result;
+    }
+
+    // where every chunk starts writing is the sum of what the chunks before it keep
+    run_chunks(pool, chunks, chunk_count, mark_chunk);
+    unsigned int total = 0;
+    for (int i = 0; i < chunk_count; i++)
+    {
+        chunks[i].offset = total;
+        total += chunks[i].kept_count;
+    }
+    t_array_list *result = array_list_create_with_capacity(total > 0 ? total : BASE_CAPACITY);
+    if (result)
+    {
+        job.target = result->array;
+        run_chunks(pool, chunks, chunk_count, compact_chunk);
+        result->element_count = total;
+    }
+    free(chunks);
+    free(job.kept);
+    return result;
+}
+
+void *array_list_parallel_reduce(t_array_list *self, t_thread_pool *pool, void *(*operation)(void *, void *))
+{
+    if (self->element_count == 0)
+        return NULL;
+    t_parallel_job job = {.source = self->array, .operation = operation};
+    int chunk_count;
+    t_chunk *chunks = split_in_chunks(self, pool, &job, &chunk_count);
+    if (!chunks)
+    {
+        void *acc = self->array[0];
+        for (unsigned int i = 1; i < self->element_count; i++)
+            acc = operation(acc, self->array[i]);
+        return acc;
+    }
+    run_chunks(pool, chunks, chunk_count, reduce_chunk);
+    // partials are combined in chunk order, operation only has to be associative
+    void *acc = chunks[0].partial;
+    for (int i = 1; i < chunk_count; i++)
+        acc = operation(acc, chunks[i].partial);
+    free(chunks);
+    return acc;
+}
+
 t_list_error array_list_add_to_index(t_array_list *self, int index, void *data)
 {
     if (index_out_of_bounds(self, index))
@@ -129,6 +332,29 @@ t_list_error array_list_remove_and_destroy(t_array_list *self, int index, void (
     return remove_element(self, index, NULL, element_destroyer);
 }
 
+void array_list_sort(t_array_list *self, bool (*comparator)(void *, void *))
+{
+    int depth_limit = 0;
+    for (unsigned int count = self->element_count; count > 1; count >>= 1)
+        depth_limit += 2;
+    introsort(self->array, self->element_count, depth_limit, comparator);
+}
+
+void array_list_parallel_sort(t_array_list *self, t_thread_pool *pool, bool (*comparator)(void *, void *))
+{
+    int count = self->element_count;
+    void **buffer = count > ARRAY_LIST_PARALLEL_SORT_GRAIN && thread_pool_size(pool) > 1 ? malloc(count * sizeof(void *)) : NULL;
+    if (!buffer)
+    {
+        array_list_sort(self, comparator);
+        return;
+    }
+    int grain = count / (thread_pool_size(pool) * THREAD_POOL_CHUNKS_PER_WORKER);
+    t_sort_range range = {pool, self->array, buffer, 0, count, grain > ARRAY_LIST_PARALLEL_SORT_GRAIN ? grain : ARRAY_LIST_PARALLEL_SORT_GRAIN, false, comparator};
+    sort_range(&range);
+    free(buffer);
+}
+
 t_list_error array_list_remove_element(t_array_list *self, void *to_delete)
 {
     int len = array_list_size(self);
@@ -200,3 +426,313 @@ static void shift_elements_to_left(t_array_list *self, int end)
                 (self->element_count - end - 1) * sizeof(void *));
     }
 }
+
+static void foreach_range(void *arg)
+{
+    t_foreach_range *range = arg;
+    // hand the upper half to the pool and keep splitting the lower one, thieves end up
+    // with the biggest pieces left
+    while (range->end - range->begin > range->grain)
+    {
+        t_foreach_range *upper = malloc(sizeof(t_foreach_range));
+        if (!upper)
+            break;
+        *upper = *range;
+        upper->begin = range->begin + (range->end - range->begin) / 2;
+        range->end = upper->begin;
+        thread_pool_spawn(range->pool, range->group, foreach_range, upper);
+    }
+    for (unsigned int i = range->begin; i < range->end; i++)
+        range->operation(range->array[i]);
+    free(range);
+}
+
+// THREAD_POOL_CHUNKS_PER_WORKER chunks per worker of about the same size, never empty
+static t_chunk *split_in_chunks(t_array_list *self, t_thread_pool *pool, t_parallel_job *job, int *chunk_count)
+{
+    unsigned int count = self->element_count;
+    unsigned int chunks_wanted = thread_pool_size(pool) * THREAD_POOL_CHUNKS_PER_WORKER;
+    int total = count < chunks_wanted ? (count > 0 ? count : 1) : chunks_wanted;
+    t_chunk *chunks = malloc(total * sizeof(t_chunk));
+    if (!chunks)
+        return NULL;
+    for (int i = 0; i < total; i++)
+    {
+        unsigned int begin = (unsigned long long)count * i / total;
+        unsigned int end = (unsigned long long)count * (i + 1) / total;
+        chunks[i] = (t_chunk){job, begin, end, 0, 0, NULL};
+    }
+    *chunk_count = total;
+    return chunks;
+}
+
+// the calling thread runs the first chunk itself, then helps with the rest
+static void run_chunks(t_thread_pool *pool, t_chunk *chunks, int chunk_count, void (*run)(void *))
+{
+    t_task_group group;
+    task_group_init(&group);
+    for (int i = 1; i < chunk_count; i++)
+        thread_pool_spawn(pool, &group, run, &chunks[i]);
+    run(&chunks[0]);
+    thread_pool_join(pool, &group);
+}
+
+static void map_chunk(void *arg)
+{
+    t_chunk *chunk = arg;
+    t_parallel_job *job = chunk->job;
+    for (unsigned int i = chunk->begin; i < chunk->end; i++)
+        job->target[i] = job->mapper(job->source[i]);
+}
+
+static void mark_chunk(void *arg)
+{
+    t_chunk *chunk = arg;
+    t_parallel_job *job = chunk->job;
+    unsigned int kept_count = 0;
+    for (unsigned int i = chunk->begin; i < chunk->end; i++)
+    {
+        job->kept[i] = job->condition(job->source[i]);
+        kept_count += job->kept[i];
+    }
+    chunk->kept_count = kept_count;
+}
+
+static void compact_chunk(void *arg)
+{
+    t_chunk *chunk = arg;
+    t_parallel_job *job = chunk->job;
+    unsigned int out = chunk->offset;
+    for (unsigned int i = chunk->begin; i < chunk->end; i++)
+    {
+        if (job->kept[i])
+            job->target[out++] = job->source[i];
+    }
+}
+
+static void reduce_chunk(void *arg)
+{
+    t_chunk *chunk = arg;
+    t_parallel_job *job = chunk->job;
+    void *acc = job->source[chunk->begin];
+    for (unsigned int i = chunk->begin + 1; i < chunk->end; i++)
+        acc = job->operation(acc, job->source[i]);
+    chunk->partial = acc;
+}
+
+static void introsort(void **elements, int count, int depth_limit, bool (*comparator)(void *, void *))
+{
+    while (count > ARRAY_LIST_INSERTION_SORT_THRESHOLD)
+    {
+        if (depth_limit-- == 0)
+        {
+            // the pivots keep going wrong, heapsort caps it at n log n
+            heap_sort(elements, count, comparator);
+            return;
+        }
+        int split = partition(elements, count, comparator);
+        // recurse into the smaller side and loop on the bigger one, the stack stays O(log n)
+        if (split < count - split)
+        {
+            introsort(elements, split, depth_limit, comparator);
+            elements += split;
+            count -= split;
+        }
+        else
+        {
+            introsort(elements + split, count - split, depth_limit, comparator);
+            count = split;
+        }
+    }
+    insertion_sort(elements, count, comparator);
+}
+
+// Hoare partition around the median of the first, middle and last elements. Returns the
+// size of the lower part, both parts are non empty and nothing in the lower one goes after
+// anything in the upper one. The scans are bounded: with a less or equal comparator a run of
+// elements equal to the pivot no longer stops them
+static int partition(void **elements, int count, bool (*comparator)(void *, void *))
+{
+    int middle = count / 2;
+    if (comparator(elements[middle], elements[0]))
+        swap_elements(elements, middle, 0);
+    if (comparator(elements[count - 1], elements[middle]))
+    {
+        swap_elements(elements, middle, count - 1);
+        if (comparator(elements[middle], elements[0]))
+            swap_elements(elements, middle, 0);
+    }
+    void *pivot = elements[middle];
+
+    int i = -1;
+    int j = count;
+    for (;;)
+    {
+        do
+            i++;
+        while (i < count - 1 && comparator(elements[i], pivot));
+        do
+            j--;
+        while (j > 0 && comparator(pivot, elements[j]));
+        if (i >= j)
+            return j + 1;
+        swap_elements(elements, i, j);
+    }
+}
+
+static void insertion_sort(void **elements, int count, bool (*comparator)(void *, void *))
+{
+    for (int i = 1; i < count; i++)
+    {
+        void *data = elements[i];
+        int j = i;
+        for (; j > 0 && comparator(data, elements[j - 1]); j--)
+            elements[j] = elements[j - 1];
+        elements[j] = data;
+    }
+}
+
+static void swap_elements(void **elements, int a, int b)
+{
+    void *swap = elements[a];
+    elements[a] = elements[b];
+    elements[b] = swap;
+}
+
+static void heap_sort(void **elements, int count, bool (*comparator)(void *, void *))
+{
+    for (int i = count / 2 - 1; i >= 0; i--)
+        heap_sift_down(elements, i, count, comparator);
+    for (int end = count - 1; end > 0; end--)
+    {
+        swap_elements(elements, 0, end);
+        heap_sift_down(elements, 0, end, comparator);
+    }
+}
+
+// max heap: the element that goes last sits on top
+static void heap_sift_down(void **elements, int index, int count, bool (*comparator)(void *, void *))
+{
+    void *data = elements[index];
+    for (int child = 2 * index + 1; child < count; child = 2 * index + 1)
+    {
+        if (child + 1 < count && comparator(elements[child], elements[child + 1]))
+            child++;
+        if (!comparator(data, elements[child]))
+            break;
+        elements[index] = elements[child];
+        index = child;
+    }
+    elements[index] = data;
+}
+
+// both halves sort into the other array, so merging them lands the result where it belongs
+// without copying anything back
+static void sort_range(void *arg)
+{
+    t_sort_range *range = arg;
+    int count = range->end - range->begin;
+    if (count <= range->grain)
+    {
+        int depth_limit = 0;
+        for (int n = count; n > 1; n >>= 1)
+            depth_limit += 2;
+        introsort(range->elements + range->begin, count, depth_limit, range->comparator);
+        if (range->into_buffer)
+            memcpy(range->buffer + range->begin, range->elements + range->begin, count * sizeof(void *));
+        return;
+    }
+
+    int middle = range->begin + count / 2;
+    t_sort_range lower = *range;
+    t_sort_range upper = *range;
+    lower.end = middle;
+    upper.begin = middle;
+    lower.into_buffer = upper.into_buffer = !range->into_buffer;
+    t_task_group group;
+    task_group_init(&group);
+    thread_pool_spawn(range->pool, &group, sort_range, &upper);
+    sort_range(&lower);
+    thread_pool_join(range->pool, &group);
+
+    void **from = range->into_buffer ? range->elements : range->buffer;
+    void **to = range->into_buffer ? range->buffer : range->elements;
+    t_merge_range merge = {range->pool, from, to, range->begin, middle, middle, range->end, range->begin, range->comparator};
+    merge_range(&merge);
+}
+
+// splits the merge in two independent ones around the middle of the longer run: the other
+// run is cut where the pivot would go, everything left of both cuts goes first
+static void merge_range(void *arg)
+{
+    t_merge_range *merge = arg;
+    int left_count = merge->left_end - merge->left_begin;
+    int right_count = merge->right_end - merge->right_begin;
+
+    if (left_count + right_count <= ARRAY_LIST_PARALLEL_SORT_GRAIN)
+    {
+        int left = merge->left_begin;
+        int right = merge->right_begin;
+        int out = merge->out;
+        while (left < merge->left_end && right < merge->right_end)
+        {
+            if (merge->comparator(merge->from[right], merge->from[left]))
+                merge->to[out++] = merge->from[right++];
+            else
+                merge->to[out++] = merge->from[left++];
+        }
+        memcpy(merge->to + out, merge->from + left, (merge->left_end - left) * sizeof(void *));
+        out += merge->left_end - left;
+        memcpy(merge->to + out, merge->from + right, (merge->right_end - right) * sizeof(void *));
+        return;
+    }
+
+    int left_split, right_split;
+    if (left_count >= right_count)
+    {
+        left_split = merge->left_begin + left_count / 2;
+        right_split = first_not_before(merge->from, merge->right_begin, merge->right_end, merge->from[left_split], merge->comparator);
+    }
+    else
+    {
+        right_split = merge->right_begin + right_count / 2;
+        left_split = first_after(merge->from, merge->left_begin, merge->left_end, merge->from[right_split], merge->comparator);
+    }
+
+    t_merge_range first = *merge;
+    t_merge_range second = *merge;
+    first.left_end = second.left_begin = left_split;
+    first.right_end = second.right_begin = right_split;
+    second.out = merge->out + (left_split - merge->left_begin) + (right_split - merge->right_begin);
+    t_task_group group;
+    task_group_init(&group);
+    thread_pool_spawn(merge->pool, &group, merge_range, &second);
+    merge_range(&first);
+    thread_pool_join(merge->pool, &group);
+}
+
+static int first_not_before(void **elements, int begin, int end, void *pivot, bool (*comparator)(void *, void *))
+{
+    while (begin < end)
+    {
+        int middle = begin + (end - begin) / 2;
+        if (comparator(elements[middle], pivot))
+            begin = middle + 1;
+        else
+            end = middle;
+    }
+    return begin;
+}
+
+static int first_after(void **elements, int begin, int end, void *pivot, bool (*comparator)(void *, void *))
+{
+    while (begin < end)
+    {
+        int middle = begin + (end - begin) / 2;
+        if (comparator(pivot, elements[middle]))
+            end = middle;
+        else
+            begin = middle + 1;
+    }
+    return begin;
+}
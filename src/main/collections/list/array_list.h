@@ -7,10 +7,20 @@
 #include <stdbool.h>
 #include <stdio.h>
 
+// only handled through pointers here, so list users don't pull in pthread
+typedef struct thread_pool t_thread_pool;
+
 #define BASE_CAPACITY 10
 
 #define CAPACITY_MULTIPLIER 2
 
+// array_list_sort leaves ranges this short to insertion sort
+#define ARRAY_LIST_INSERTION_SORT_THRESHOLD 16
+
+// array_list_parallel_sort never hands out less than this many elements to sort or merge
+// as one task, smaller pieces cost more to schedule than to do
+#define ARRAY_LIST_PARALLEL_SORT_GRAIN 4096
+
 typedef struct
 {
     unsigned int capacity;
@@ -24,6 +34,25 @@ t_array_list *array_list_create_with_capacity(unsigned int capacity);
 
 void array_list_foreach(t_array_list *self, void (*operation)(void *));
 
+// runs operation on every element across the pool's workers, returns once all are done.
+// operation must be safe to call from several threads at once
+void array_list_parallel_foreach(t_array_list *self, t_thread_pool *pool, void (*operation)(void *));
+
+// the following split the array in THREAD_POOL_CHUNKS_PER_WORKER chunks per worker of the
+// pool, the calling thread works on them too. Their callbacks run on several threads at once
+
+// a new list with mapper applied to every element, in the same order
+t_array_list *array_list_parallel_map(t_array_list *self, t_thread_pool *pool, void *(*mapper)(void *));
+
+// a new list with the elements satisfying condition, in the same order. Every chunk counts
+// what it keeps, a prefix sum over the counts tells each one where to copy its elements
+t_array_list *array_list_parallel_filter(t_array_list *self, t_thread_pool *pool, bool (*condition)(void *));
+
+// like foldl1: every chunk folds its elements, the partial results are then folded in chunk
+// order. operation must be associative and must not modify its arguments, they may be
+// elements or partial results alike. NULL for an empty list
+void *array_list_parallel_reduce(t_array_list *self, t_thread_pool *pool, void *(*operation)(void *, void *));
+
 void array_list_clean(t_array_list *self);
 
 void array_list_clean_and_destroy_elements(t_array_list *self, void (*element_destroyer)(void *));
@@ -48,6 +77,15 @@ t_list_error array_list_remove_and_destroy(t_array_list *self, int index, void (
 
 t_list_error array_list_remove_element(t_array_list *self, void *to_delete);
 
+// introsort: quicksort with median of three pivots, heapsort once it recurses too deep,
+// insertion sort for short ranges. comparator(a, b) is true when a goes before b.
+// Not stable, equal elements may end up in any order
+void array_list_sort(t_array_list *self, bool (*comparator)(void *, void *));
+
+// merge sort across the pool's workers: pieces are sorted with array_list_sort, then merged
+// in parallel by splitting every merge around a binary searched pivot. Not stable either
+void array_list_parallel_sort(t_array_list *self, t_thread_pool *pool, bool (*comparator)(void *, void *));
+
 //TODO: Implement all same methods as linked lists
 
 #endif
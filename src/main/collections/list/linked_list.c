@@ -1,6 +1,17 @@
 #include "linked_list.h"
+#include "array_list.h"
+#include "skip_index.h"
+#include "../../concurrency/thread_pool.h"
 
-static t_double_l_node *create_element(void *data);
+// count nodes starting at first
+typedef struct
+{
+    t_double_l_node *first;
+    int count;
+    void (*closure)(void *);
+} t_foreach_chunk;
+
+static t_double_l_node *create_element(t_linked_list *list, void *data);
 
 static bool should_traverse_backwards(t_linked_list *list, int index);
 
@@ -10,39 +21,94 @@ static t_double_l_node *list_traverse_backwards(t_linked_list *list, int index);
 
 static t_list_error list_internal_get(t_linked_list *list, int index, t_double_l_node **result);
 
-static t_list_error list_internal_find(t_linked_list *list, bool (*condition)(void *), t_double_l_node **result);
+static t_list_error list_internal_find(t_linked_list *list, bool (*condition)(void *), t_double_l_node **result, int *position);
 
 static bool index_out_of_bounds(t_linked_list *list, int index);
 
-static void destroy_node(t_double_l_node *node);
+static void destroy_node(t_linked_list *list, t_double_l_node *node);
+
+static void clean_nodes(t_linked_list *list, void (*element_destroyer)(void *));
+
+static void linked_list_remove_element(t_linked_list *list, t_double_l_node *element, int position);
 
-static void linked_list_remove_element(t_linked_list *list, t_double_l_node *element);
+static void index_inserted(t_linked_list *list, t_double_l_node *node, int position);
 
-static void adjust_tail(t_linked_list *list);
+static void drop_index(t_linked_list *list);
 
-static t_double_l_node *split_linked_list(t_double_l_node *head);
+static void merge_sort_nodes(t_linked_list *list, bool (*comparator)(void *, void *));
 
-static t_double_l_node *merge_linked_lists(t_double_l_node *a, t_double_l_node *b, bool (*comparator)(void *, void *));
+static bool merge_sort_through_array(t_linked_list *list, bool (*comparator)(void *, void *));
 
-static t_double_l_node *merge_sort(t_double_l_node *head, bool (*comparator)(void *, void *));
+static void merge_runs(void **from, void **to, int start, int middle, int end, bool (*comparator)(void *, void *));
 
-static void add_element_in_front_of(t_linked_list *list, void *data, t_double_l_node *node);
+static void add_element_in_front_of(t_linked_list *list, void *data, t_double_l_node *node, int position);
 
-static void add_element_behind(t_linked_list *list, void *data, t_double_l_node *node);
+static void add_element_behind(t_linked_list *list, void *data, t_double_l_node *node, int position);
 
 static void *linked_list_internal_foldl(t_double_l_node *head, void *seed, void *(*operation)(void *, void *));
 
 static void *linked_list_internal_foldr(t_double_l_node *tail, void *seed, void *(*operation)(void *, void *));
 
+static void foreach_chunk(void *chunk);
+
 t_linked_list *linked_list_create(void)
+{
+    t_node_pool *pool = node_pool_create();
+    if (!pool)
+        return NULL;
+
+    t_linked_list *list = linked_list_create_with_pool(pool);
+    if (!list)
+    {
+        node_pool_destroy(pool);
+        return NULL;
+    }
+    list->owns_pool = true;
+    return list;
+}
+
+t_linked_list *linked_list_create_with_pool(t_node_pool *pool)
 {
     t_linked_list *list = malloc(sizeof(t_linked_list));
+    if (!list)
+        return NULL;
     list->size = 0;
     list->head = NULL;
     list->tail = NULL;
+    list->pool = pool;
+    list->owns_pool = false;
+    list->index = NULL;
     return list;
 }
 
+bool linked_list_enable_index(t_linked_list *list)
+{
+    if (list->index)
+        return true;
+    list->index = skip_index_create();
+    if (!list->index)
+        return false;
+    if (!skip_index_rebuild(list->index, list->head))
+    {
+        linked_list_disable_index(list);
+        return false;
+    }
+    return true;
+}
+
+void linked_list_disable_index(t_linked_list *list)
+{
+    if (!list->index)
+        return;
+    skip_index_destroy(list->index);
+    list->index = NULL;
+}
+
+bool linked_list_is_indexed(t_linked_list *list)
+{
+    return list->index != NULL;
+}
+
 int linked_list_size(t_linked_list *list)
 {
     return list->size;
@@ -56,18 +122,19 @@ bool linked_list_is_empty(t_linked_list *list)
 // al final
 void linked_list_add(t_linked_list *list, void *elem)
 {
-    t_double_l_node *node = create_element(elem);
+    t_double_l_node *node = create_element(list, elem);
     if (linked_list_is_empty(list))
     {
         list->head = list->tail = node;
-        list->size++;
-        return;
     }
-
-    list->tail->next = node;
-    node->prev = list->tail;
-    list->tail = node;
+    else
+    {
+        list->tail->next = node;
+        node->prev = list->tail;
+        list->tail = node;
+    }
     list->size++;
+    index_inserted(list, node, list->size - 1);
     return;
 }
 
@@ -77,11 +144,12 @@ void linked_list_add_first(t_linked_list *list, void *elem)
         linked_list_add(list,elem);
         return;
     }
-    t_double_l_node *node = create_element(elem);
+    t_double_l_node *node = create_element(list, elem);
     node->next = list->head;
     list->head->prev = node;
     list->head = node;
     list->size++;
+    index_inserted(list, node, 0);
     return;
 }
 
@@ -105,7 +173,7 @@ t_list_error linked_list_add_to_index(t_linked_list *list, int index, void *elem
     if (err != LIST_SUCCESS)
         return err;
 
-    add_element_in_front_of(list, elem, temp);
+    add_element_in_front_of(list, elem, temp, index);
 
     return err;
 }
@@ -140,7 +208,7 @@ int linked_list_add_sorted(t_linked_list *list, void *data, bool (*comparator)(v
                 linked_list_add_first(list, data);
                 return index;
             }
-            add_element_behind(list, data, temp);
+            add_element_behind(list, data, temp, index);
 
             return index;
         }
@@ -197,7 +265,7 @@ t_list_error linked_list_set_and_destroy_element(t_linked_list *list, int index,
 t_list_error linked_list_replace_by_condition(t_linked_list *list, bool (*condition)(void *), void *new_value, void **old_value)
 {
     t_double_l_node *temp;
-    t_list_error result_error = list_internal_find(list, condition, &temp);
+    t_list_error result_error = list_internal_find(list, condition, &temp, NULL);
     if (result_error != LIST_SUCCESS)
     {
         return result_error;
@@ -234,7 +302,7 @@ t_list_error linked_list_remove(t_linked_list *list, int index, void **buffer)
     {
         if (buffer)
             *buffer = to_delete->data;
-        linked_list_remove_element(list, to_delete);
+        linked_list_remove_element(list, to_delete, index);
     }
 
     return result_error;
@@ -251,7 +319,7 @@ t_list_error linked_list_remove_and_destroy(t_linked_list *list, int index, void
     if (to_delete)
     {
         element_destroyer(to_delete->data);
-        linked_list_remove_element(list, to_delete);
+        linked_list_remove_element(list, to_delete, index);
     }
 
     return result_error;
@@ -261,7 +329,8 @@ t_list_error linked_list_remove_by_condition(t_linked_list *list, bool (*conditi
 {
 
     t_double_l_node *to_delete;
-    t_list_error err = list_internal_find(list, condition, &to_delete);
+    int position;
+    t_list_error err = list_internal_find(list, condition, &to_delete, &position);
 
     if (err != LIST_SUCCESS)
     {
@@ -272,7 +341,7 @@ t_list_error linked_list_remove_by_condition(t_linked_list *list, bool (*conditi
     {
         if (buffer)
             *buffer = to_delete->data;
-        linked_list_remove_element(list, to_delete);
+        linked_list_remove_element(list, to_delete, position);
     }
 
     return err;
@@ -282,7 +351,8 @@ t_list_error linked_list_remove_and_destroy_by_condition(t_linked_list *list, bo
 {
 
     t_double_l_node *to_delete;
-    t_list_error err = list_internal_find(list, condition, &to_delete);
+    int position;
+    t_list_error err = list_internal_find(list, condition, &to_delete, &position);
 
     if (err != LIST_SUCCESS)
         return err;
@@ -290,7 +360,7 @@ t_list_error linked_list_remove_and_destroy_by_condition(t_linked_list *list, bo
     if (to_delete)
     {
         element_destroyer(to_delete->data);
-        linked_list_remove_element(list, to_delete);
+        linked_list_remove_element(list, to_delete, position);
     }
 
     return err;
@@ -308,10 +378,40 @@ void linked_list_foreach(t_linked_list *list, void (*closure)(void *))
     return;
 }
 
+void linked_list_parallel_foreach(t_linked_list *list, t_thread_pool *pool, void (*closure)(void *))
+{
+    int grain = list->size / (thread_pool_size(pool) * THREAD_POOL_CHUNKS_PER_WORKER);
+    if (grain == 0)
+        grain = 1;
+    t_task_group group;
+    task_group_init(&group);
+
+    t_double_l_node *node = list->head;
+    while (node)
+    {
+        t_foreach_chunk *chunk = malloc(sizeof(t_foreach_chunk));
+        if (!chunk)
+        {
+            // whatever could not be handed out runs right here
+            for (; node; node = node->next)
+                closure(node->data);
+            break;
+        }
+        *chunk = (t_foreach_chunk){node, 0, closure};
+        while (node && chunk->count < grain)
+        {
+            node = node->next;
+            chunk->count++;
+        }
+        thread_pool_spawn(pool, &group, foreach_chunk, chunk);
+    }
+    thread_pool_join(pool, &group);
+}
+
 t_list_error linked_list_find(t_linked_list *list, bool (*condition)(void *), void **buffer)
 {
     t_double_l_node *temp;
-    t_list_error err = list_internal_find(list, condition, &temp);
+    t_list_error err = list_internal_find(list, condition, &temp, NULL);
     if (err != LIST_SUCCESS)
     {
         return err;
@@ -339,23 +439,17 @@ int linked_list_index_of(t_linked_list *list, void *elem)
 
 void linked_list_clean(t_linked_list *list)
 {
-    while (linked_list_size(list) > 0)
-    {
-        linked_list_remove(list, 0, NULL);
-    }
+    clean_nodes(list, NULL);
 }
 
 void linked_list_clean_and_destroy_elements(t_linked_list *list, void (*element_destroyer)(void *))
 {
-    while (linked_list_size(list) > 0)
-    {
-        linked_list_remove_and_destroy(list, 0, element_destroyer);
-    }
+    clean_nodes(list, element_destroyer);
 }
 
 bool linked_list_any_satisfy(t_linked_list *list, bool (*condition)(void *))
 {
-    return list_internal_find(list, condition, NULL) == LIST_SUCCESS;
+    return list_internal_find(list, condition, NULL, NULL) == LIST_SUCCESS;
 }
 
 int linked_list_count(t_linked_list *list, bool (*condition)(void *))
@@ -385,13 +479,15 @@ bool linked_list_all_satisfy(t_linked_list *list, bool (*condition)(void *))
 
 void linked_list_destroy(t_linked_list *list)
 {
-    linked_list_clean(list);
-    free(list);
+    linked_list_destroy_and_destroy_elements(list, NULL);
 }
 
 void linked_list_destroy_and_destroy_elements(t_linked_list *list, void (*element_destroyer)(void *))
 {
-    linked_list_clean_and_destroy_elements(list, element_destroyer);
+    clean_nodes(list, element_destroyer);
+    linked_list_disable_index(list);
+    if (list->owns_pool)
+        node_pool_destroy(list->pool);
     free(list);
 }
 
@@ -431,12 +527,42 @@ t_linked_list *linked_list_map(t_linked_list *list, void *(*mapper)(void *))
 
 void linked_list_sort(t_linked_list *list, bool (*comparator)(void *, void *))
 {
-    if (!list)
+    if (!list || list->size < 2)
         return;
 
-    list->head = merge_sort(list->head, comparator);
+    if (list->size < LINKED_LIST_ARRAY_SORT_THRESHOLD || !merge_sort_through_array(list, comparator))
+        merge_sort_nodes(list, comparator);
+}
+
+void linked_list_sort_in_place(t_linked_list *list, bool (*comparator)(void *, void *))
+{
+    if (!list || list->size < 2)
+        return;
 
-    adjust_tail(list);
+    merge_sort_nodes(list, comparator);
+}
+
+void linked_list_parallel_sort(t_linked_list *list, t_thread_pool *pool, bool (*comparator)(void *, void *))
+{
+    if (!list || list->size < 2)
+        return;
+
+    void **elements = malloc(list->size * sizeof(void *));
+    if (!elements)
+    {
+        linked_list_sort_in_place(list, comparator);
+        return;
+    }
+    int index = 0;
+    for (t_double_l_node *node = list->head; node; node = node->next)
+        elements[index++] = node->data;
+    // an array list over the copy, only for the sort
+    t_array_list view = {.capacity = list->size, .element_count = list->size, .array = elements};
+    array_list_parallel_sort(&view, pool, comparator);
+    index = 0;
+    for (t_double_l_node *node = list->head; node; node = node->next)
+        node->data = elements[index++];
+    free(elements);
 }
 
 t_linked_list *linked_list_sorted(t_linked_list *list, bool (*comparator)(void *, void *))
@@ -479,7 +605,7 @@ t_linked_list *linked_list_slice_and_remove(t_linked_list *list, int start, int
     {
         linked_list_add(result, temp->data);
         next = temp->next;
-        linked_list_remove_element(list, temp);
+        linked_list_remove_element(list, temp, start);
         temp = next;
     }
 
@@ -567,19 +693,26 @@ static t_list_error list_internal_get(t_linked_list *list, int index, t_double_l
 {
     if (index_out_of_bounds(list, index))
         return LIST_INDEX_OUT_OF_BOUNDS;
+    if (list->index)
+    {
+        *result = index < list->size ? skip_index_find(list->index, list->head, index) : list->tail;
+        return LIST_SUCCESS;
+    }
     *result = should_traverse_backwards(list, index) ? list_traverse_backwards(list, index) : list_traverse_forward(list, index);
     return LIST_SUCCESS;
 }
 
-static t_list_error list_internal_find(t_linked_list *list, bool (*condition)(void *), t_double_l_node **result)
+static t_list_error list_internal_find(t_linked_list *list, bool (*condition)(void *), t_double_l_node **result, int *position)
 {
     t_double_l_node *temp = list->head;
-    while (temp)
+    for (int index = 0; temp; index++)
     {
         if (condition(temp->data))
         {
             if (result)
                 *result = temp;
+            if (position)
+                *position = index;
             return LIST_SUCCESS;
         }
         temp = temp->next;
@@ -592,23 +725,46 @@ static bool should_traverse_backwards(t_linked_list *list, int index)
     return index >= (linked_list_size(list) / 2);
 }
 
-static t_double_l_node *create_element(void *data)
+static t_double_l_node *create_element(t_linked_list *list, void *data)
 {
-    t_double_l_node *node = malloc(sizeof(t_double_l_node));
+    t_double_l_node *node = node_pool_acquire(list->pool);
     node->data = data;
     node->next = NULL;
     node->prev = NULL;
     return node;
 }
 
-static void destroy_node(t_double_l_node *node)
+static void destroy_node(t_linked_list *list, t_double_l_node *node)
 {
-    free(node);
+    node_pool_release(list->pool, node);
 }
 
-static void add_element_in_front_of(t_linked_list *list, void *data, t_double_l_node *node)
+static void clean_nodes(t_linked_list *list, void (*element_destroyer)(void *))
 {
-    t_double_l_node *new = create_element(data);
+    t_double_l_node *temp = list->head;
+    while (temp)
+    {
+        t_double_l_node *next = temp->next;
+        if (element_destroyer)
+            element_destroyer(temp->data);
+        // a shared pool may hold nodes of other lists, give them back one by one
+        if (!list->owns_pool)
+            destroy_node(list, temp);
+        temp = next;
+    }
+
+    if (list->owns_pool)
+        node_pool_reset(list->pool);
+    if (list->index)
+        skip_index_clear(list->index);
+    list->head = list->tail = NULL;
+    list->size = 0;
+}
+
+// position is where the new element ends up, for the index
+static void add_element_in_front_of(t_linked_list *list, void *data, t_double_l_node *node, int position)
+{
+    t_double_l_node *new = create_element(list, data);
 
     new->prev = node;
     new->next = node->next;
@@ -618,14 +774,19 @@ static void add_element_in_front_of(t_linked_list *list, void *data, t_double_l_
     {
         new->next->prev = new;
     }
+    else
+    {
+        list->tail = new;
+    }
 
     list->size++;
+    index_inserted(list, new, position);
 }
 
-static void add_element_behind(t_linked_list *list, void *data, t_double_l_node *node)
+static void add_element_behind(t_linked_list *list, void *data, t_double_l_node *node, int position)
 {
 
-    t_double_l_node *new = create_element(data);
+    t_double_l_node *new = create_element(list, data);
     new->prev = node->prev;
     new->next = node;
 
@@ -637,10 +798,14 @@ static void add_element_behind(t_linked_list *list, void *data, t_double_l_node
     }
 
     list->size++;
+    index_inserted(list, new, position);
 }
 
-static void linked_list_remove_element(t_linked_list *list, t_double_l_node *element)
+// position of element in the list, for the index
+static void linked_list_remove_element(t_linked_list *list, t_double_l_node *element, int position)
 {
+    if (list->index)
+        skip_index_remove(list->index, position);
 
     if (linked_list_size(list) == 1)
     {
@@ -673,72 +838,152 @@ static void linked_list_remove_element(t_linked_list *list, t_double_l_node *ele
     }
 
     list->size--;
-    destroy_node(element);
+    destroy_node(list, element);
 }
 
-static bool index_out_of_bounds(t_linked_list *list, int index)
+static void index_inserted(t_linked_list *list, t_double_l_node *node, int position)
 {
-    return index > linked_list_size(list) || index < 0;
+    if (list->index && !skip_index_insert(list->index, node, position))
+        drop_index(list);
 }
 
-static void adjust_tail(t_linked_list *list)
+static void drop_index(t_linked_list *list)
 {
-    list->tail = list->head;
-    while (list->tail && list->tail->next)
-    {
-        list->tail = list->tail->next;
-    }
+    fprintf(stderr, "Not enough memory for the index of linked list %p, dropping it", (void *)list);
+    linked_list_disable_index(list);
 }
 
-static t_double_l_node *split_linked_list(t_double_l_node *head)
+static bool index_out_of_bounds(t_linked_list *list, int index)
 {
-    t_double_l_node *slow = head;
-    t_double_l_node *fast = head;
+    return index > linked_list_size(list) || index < 0;
+}
 
-    while (fast && fast->next && fast->next->next)
+// bottom-up merge sort on the next pointers: merges runs of width 1, 2, 4... in one walk
+// each, with no recursion and no extra memory. prev and tail are fixed in a last walk
+static void merge_sort_nodes(t_linked_list *list, bool (*comparator)(void *, void *))
+{
+    t_double_l_node *head = list->head;
+    for (int width = 1;; width *= 2)
     {
-        slow = slow->next;
-        fast = fast->next->next;
+        t_double_l_node *left = head;
+        t_double_l_node *tail = NULL;
+        int merges = 0;
+        head = NULL;
+        while (left)
+        {
+            merges++;
+            t_double_l_node *right = left;
+            int left_size = 0;
+            while (right && left_size < width)
+            {
+                right = right->next;
+                left_size++;
+            }
+            int right_size = width;
+
+            while (left_size > 0 || (right_size > 0 && right))
+            {
+                t_double_l_node *next;
+                // ties go to the left run, which keeps the sort stable
+                if (left_size == 0 || (right_size > 0 && right && comparator(right->data, left->data)))
+                {
+                    next = right;
+                    right = right->next;
+                    right_size--;
+                }
+                else
+                {
+                    next = left;
+                    left = left->next;
+                    left_size--;
+                }
+                if (tail)
+                    tail->next = next;
+                else
+                    head = next;
+                tail = next;
+            }
+            left = right;
+        }
+        if (tail)
+            tail->next = NULL;
+        if (merges <= 1)
+            break;
     }
 
-    t_double_l_node *back = slow->next;
-    slow->next = NULL;
-    if (back)
-        back->prev = NULL;
-    return back;
+    t_double_l_node *previous = NULL;
+    for (t_double_l_node *node = head; node; node = node->next)
+    {
+        node->prev = previous;
+        previous = node;
+    }
+    list->head = head;
+    list->tail = previous;
+    // the nodes moved, unlike the array sorts which only rewrite their data
+    if (list->index && !skip_index_rebuild(list->index, list->head))
+        drop_index(list);
 }
 
-static t_double_l_node *merge_linked_lists(t_double_l_node *a, t_double_l_node *b, bool (*comparator)(void *, void *))
+// copies the data pointers into an array, merge sorts them there and writes them back
+// in node order: sequential passes over contiguous memory instead of chasing next pointers
+static bool merge_sort_through_array(t_linked_list *list, bool (*comparator)(void *, void *))
 {
-    if (!a)
-        return b;
-    if (!b)
-        return a;
+    int size = list->size;
+    void **allocation = malloc(2 * size * sizeof(void *));
+    if (!allocation)
+        return false;
+    void **elements = allocation;
+    void **buffer = allocation + size;
+
+    int index = 0;
+    for (t_double_l_node *node = list->head; node; node = node->next)
+        elements[index++] = node->data;
 
-    if (comparator(a->data, b->data))
+    // short runs by insertion sort first, merging them one by one is wasted work
+    for (int start = 0; start < size; start += LINKED_LIST_SORT_RUN)
     {
-        // a before b
-        a->next = merge_linked_lists(a->next, b, comparator);
-        if (a->next)
-            a->next->prev = a;
-        return a;
+        int end = start + LINKED_LIST_SORT_RUN < size ? start + LINKED_LIST_SORT_RUN : size;
+        for (int i = start + 1; i < end; i++)
+        {
+            void *data = elements[i];
+            int j = i;
+            for (; j > start && comparator(data, elements[j - 1]); j--)
+                elements[j] = elements[j - 1];
+            elements[j] = data;
+        }
     }
-    b->next = merge_linked_lists(a, b->next, comparator);
-    if (b->next)
-        b->next->prev = b;
-    return b;
+    for (int width = LINKED_LIST_SORT_RUN; width < size; width *= 2)
+    {
+        for (int start = 0; start < size; start += 2 * width)
+        {
+            int middle = start + width < size ? start + width : size;
+            int end = start + 2 * width < size ? start + 2 * width : size;
+            merge_runs(elements, buffer, start, middle, end, comparator);
+        }
+        void **swap = elements;
+        elements = buffer;
+        buffer = swap;
+    }
+
+    index = 0;
+    for (t_double_l_node *node = list->head; node; node = node->next)
+        node->data = elements[index++];
+    free(allocation);
+    return true;
 }
 
-static t_double_l_node *merge_sort(t_double_l_node *head, bool (*comparator)(void *, void *))
+static void merge_runs(void **from, void **to, int start, int middle, int end, bool (*comparator)(void *, void *))
 {
-    if (!head || !head->next)
-        return head;
-
-    t_double_l_node *back = split_linked_list(head);
-    head = merge_sort(head, comparator);
-    back = merge_sort(back, comparator);
-
-    return merge_linked_lists(head, back, comparator);
+    int left = start;
+    int right = middle;
+    for (int i = start; i < end; i++)
+    {
+        // ties go to the left run, which keeps the sort stable
+        if (left < middle && (right >= end || !comparator(from[right], from[left])))
+            to[i] = from[left++];
+        else
+            to[i] = from[right++];
+    }
 }
 
 static void *linked_list_internal_foldl(t_double_l_node *head, void *seed, void *(*operation)(void *, void *))
@@ -764,3 +1009,15 @@ static void *linked_list_internal_foldr(t_double_l_node *tail, void *seed, void
 
     return acc;
 }
+
+static void foreach_chunk(void *arg)
+{
+    t_foreach_chunk *chunk = arg;
+    t_double_l_node *node = chunk->first;
+    for (int i = 0; i < chunk->count; i++)
+    {
+        chunk->closure(node->data);
+        node = node->next;
+    }
+    free(chunk);
+}
@@ -2,22 +2,51 @@
 #define LINK_LIST_H_INCLUDED
 
 #include "../node.h"
+#include "../node_pool.h"
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdbool.h>
 #include "list_error.h"
 
+// only handled through pointers here, so list users don't pull in pthread or the index internals
+typedef struct thread_pool t_thread_pool;
+typedef struct skip_index t_skip_index;
+
+// from this size on linked_list_sort copies the elements into an array and sorts them there
+#define LINKED_LIST_ARRAY_SORT_THRESHOLD 16
+
+// array sorts insertion sort runs of this length before merging
+#define LINKED_LIST_SORT_RUN 16
+
 typedef struct
 {
     int size;
     t_double_l_node *head;
     t_double_l_node *tail;
+    // nodes come from here, owned pools are reset in one go on clean and freed with the list
+    t_node_pool *pool;
+    bool owns_pool;
+    // positional access goes through here when not NULL, see linked_list_enable_index
+    t_skip_index *index;
 } t_linked_list;
 
 // creation/deletion
 
 t_linked_list *linked_list_create(void);
 
+// the list takes its nodes from pool but never frees it, the pool must outlive every list using it
+t_linked_list *linked_list_create_with_pool(t_node_pool *pool);
+
+// keeps a skip list over the nodes so get, set, add_to_index and the removes by position
+// take O(log n) expected instead of walking up to half the list, for about a third of a node
+// more memory per element. false when there was no memory for it. If the index cannot grow
+// later on the list drops it and goes on without
+bool linked_list_enable_index(t_linked_list *list);
+
+void linked_list_disable_index(t_linked_list *list);
+
+bool linked_list_is_indexed(t_linked_list *list);
+
 // list primitives
 
 int linked_list_size(t_linked_list *list);
@@ -68,6 +97,10 @@ int linked_list_count(t_linked_list *list, bool (*condition)(void *));
 
 void linked_list_foreach(t_linked_list *list, void (*closure)(void *));
 
+// one walk cuts the list in chunks for the pool's workers, returns once all are done.
+// closure must be safe to call from several threads at once
+void linked_list_parallel_foreach(t_linked_list *list, t_thread_pool *pool, void (*closure)(void *));
+
 void linked_list_destroy(t_linked_list *list);
 
 void linked_list_destroy_and_destroy_elements(t_linked_list *list, void (*element_destroyer)(void *));
@@ -78,8 +111,17 @@ t_linked_list *linked_list_filter(t_linked_list *list, bool (*condition)(void *)
 
 t_linked_list *linked_list_map(t_linked_list *list, void *(*mapper)(void *));
 
+// stable merge sort, comparator(a, b) is true when a goes before b. Big lists are sorted in
+// a temporary array of their elements, which is faster than relinking nodes all over memory
 void linked_list_sort(t_linked_list *list, bool (*comparator)(void *, void *));
 
+// the same sort relinking the nodes bottom-up, without allocating anything
+void linked_list_sort_in_place(t_linked_list *list, bool (*comparator)(void *, void *));
+
+// the elements are sorted in a temporary array by array_list_parallel_sort, so unlike
+// linked_list_sort equal elements may change order
+void linked_list_parallel_sort(t_linked_list *list, t_thread_pool *pool, bool (*comparator)(void *, void *));
+
 t_linked_list *linked_list_sorted(t_linked_list *list, bool (*comparator)(void *, void *));
 
 t_linked_list* linked_list_slice(t_linked_list* list, int start, int count);
@@ -6,7 +6,9 @@ typedef enum
     LIST_SUCCESS = 0,
     // LIST_NULL_POINTER,
     LIST_INDEX_OUT_OF_BOUNDS,
-    LIST_NOT_FOUND
+    LIST_NOT_FOUND,
+    // the list could not grow, the element was not added
+    LIST_NO_MEMORY
 } t_list_error;
 
 #endif
@@ -0,0 +1,195 @@
+#include "skip_index.h"
+
+static void descend(t_skip_index *index, int target, t_skip_entry **path, int *ranks);
+static int random_height(t_skip_index *index);
+
+t_skip_index *skip_index_create(void)
+{
+    t_skip_index *index = malloc(sizeof(t_skip_index));
+    if (!index)
+        return NULL;
+    for (int level = 0; level < SKIP_INDEX_MAX_LEVEL; level++)
+        index->heads[level] = (t_skip_entry){NULL, NULL, level > 0 ? &index->heads[level - 1] : NULL, 0};
+    index->levels = 0;
+    index->random_state = 2463534242u;
+    return index;
+}
+
+void skip_index_destroy(t_skip_index *index)
+{
+    skip_index_clear(index);
+    free(index);
+}
+
+void skip_index_clear(t_skip_index *index)
+{
+    // every level, a failed insert may have left entries above levels
+    for (int level = 0; level < SKIP_INDEX_MAX_LEVEL; level++)
+    {
+        t_skip_entry *entry = index->heads[level].next;
+        while (entry)
+        {
+            t_skip_entry *next = entry->next;
+            free(entry);
+            entry = next;
+        }
+        index->heads[level].next = NULL;
+    }
+    index->levels = 0;
+}
+
+bool skip_index_rebuild(t_skip_index *index, t_double_l_node *first)
+{
+    skip_index_clear(index);
+    // last entry of every level so far and its position
+    t_skip_entry *last[SKIP_INDEX_MAX_LEVEL];
+    int ranks[SKIP_INDEX_MAX_LEVEL];
+    for (int level = 0; level < SKIP_INDEX_MAX_LEVEL; level++)
+    {
+        last[level] = &index->heads[level];
+        ranks[level] = -1;
+    }
+
+    int position = 0;
+    for (t_double_l_node *node = first; node; node = node->next, position++)
+    {
+        int height = random_height(index);
+        t_skip_entry *below = NULL;
+        for (int level = 0; level < height; level++)
+        {
+            t_skip_entry *entry = malloc(sizeof(t_skip_entry));
+            if (!entry)
+                return false;
+            *entry = (t_skip_entry){node, NULL, below, 0};
+            last[level]->next = entry;
+            last[level]->width = position - ranks[level];
+            last[level] = entry;
+            ranks[level] = position;
+            below = entry;
+        }
+        if (height > index->levels)
+            index->levels = height;
+    }
+    return true;
+}
+
+t_double_l_node *skip_index_find(t_skip_index *index, t_double_l_node *first, int position)
+{
+    t_double_l_node *node = first;
+    int rank = 0;
+    if (index->levels > 0)
+    {
+        t_skip_entry *path[SKIP_INDEX_MAX_LEVEL];
+        int ranks[SKIP_INDEX_MAX_LEVEL];
+        descend(index, position + 1, path, ranks);
+        if (path[0]->node)
+        {
+            node = path[0]->node;
+            rank = ranks[0];
+        }
+    }
+    for (; rank < position; rank++)
+        node = node->next;
+    return node;
+}
+
+bool skip_index_insert(t_skip_index *index, t_double_l_node *node, int position)
+{
+    t_skip_entry *path[SKIP_INDEX_MAX_LEVEL];
+    int ranks[SKIP_INDEX_MAX_LEVEL];
+    descend(index, position, path, ranks);
+
+    int height = random_height(index);
+    for (int level = index->levels; level < height; level++)
+    {
+        path[level] = &index->heads[level];
+        ranks[level] = -1;
+    }
+    if (height > index->levels)
+        index->levels = height;
+
+    t_skip_entry *below = NULL;
+    for (int level = 0; level < index->levels; level++)
+    {
+        t_skip_entry *previous = path[level];
+        if (level >= height)
+        {
+            // jumps over the new node now
+            if (previous->next)
+                previous->width++;
+            continue;
+        }
+        t_skip_entry *entry = malloc(sizeof(t_skip_entry));
+        if (!entry)
+            return false;
+        *entry = (t_skip_entry){node, previous->next, below, 0};
+        // next was at ranks + width before the insert and moved one up
+        if (entry->next)
+            entry->width = ranks[level] + previous->width + 1 - position;
+        previous->next = entry;
+        previous->width = position - ranks[level];
+        below = entry;
+    }
+    return true;
+}
+
+void skip_index_remove(t_skip_index *index, int position)
+{
+    t_skip_entry *path[SKIP_INDEX_MAX_LEVEL];
+    int ranks[SKIP_INDEX_MAX_LEVEL];
+    descend(index, position, path, ranks);
+
+    for (int level = 0; level < index->levels; level++)
+    {
+        t_skip_entry *previous = path[level];
+        t_skip_entry *entry = previous->next;
+        if (!entry)
+            continue;
+        if (ranks[level] + previous->width == position)
+        {
+            previous->next = entry->next;
+            previous->width += entry->width - 1;
+            free(entry);
+        }
+        else
+            previous->width--;
+    }
+    while (index->levels > 0 && !index->heads[index->levels - 1].next)
+        index->levels--;
+}
+
+// on every level the last entry before position target and its position, -1 for the heads
+static void descend(t_skip_index *index, int target, t_skip_entry **path, int *ranks)
+{
+    if (index->levels == 0)
+        return;
+    t_skip_entry *entry = &index->heads[index->levels - 1];
+    int rank = -1;
+    for (int level = index->levels - 1; level >= 0; level--)
+    {
+        while (entry->next && rank + entry->width < target)
+        {
+            rank += entry->width;
+            entry = entry->next;
+        }
+        path[level] = entry;
+        ranks[level] = rank;
+        entry = entry->down;
+    }
+}
+
+// levels a new node gets entries on: 0 three times out of four, then each one more a fourth as often
+static int random_height(t_skip_index *index)
+{
+    index->random_state ^= index->random_state << 13;
+    index->random_state ^= index->random_state >> 17;
+    index->random_state ^= index->random_state << 5;
+    unsigned int bits = index->random_state;
+    int height = 0;
+    while (height < SKIP_INDEX_MAX_LEVEL && (bits & 3) == 0)
+    {
+        height++;
+        bits >>= 2;
+    }
+    return height;
+}
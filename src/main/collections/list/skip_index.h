@@ -0,0 +1,55 @@
+#ifndef SKIP_INDEX_H_INCLUDED
+#define SKIP_INDEX_H_INCLUDED
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include "../node.h"
+
+// a node gets an entry on the next level with probability 1/4, so there are a third as many
+// entries as nodes and 16 levels cover any int sized list
+#define SKIP_INDEX_MAX_LEVEL 16
+
+typedef struct skip_entry{
+    // NULL in the head entries, which stand before position 0
+    t_double_l_node* node;
+    struct skip_entry* next;
+    // entry of the same node one level down, NULL on the lowest level
+    struct skip_entry* down;
+    // positions between this entry's node and next's, meaningless while next is NULL
+    int width;
+} t_skip_entry;
+
+// Indexable skip list over the nodes of a linked list: the nodes themselves are the bottom
+// level and the entries above point at them, each level knowing how many positions its
+// links jump. Finding a position walks down the levels in O(log n) expected and ends with a
+// few steps along the nodes. The index only knows positions, whoever links or unlinks a
+// node has to tell it where
+typedef struct skip_index{
+    // levels holding entries, heads[levels] and above are empty
+    int levels;
+    t_skip_entry heads[SKIP_INDEX_MAX_LEVEL];
+    unsigned int random_state;
+} t_skip_index;
+
+t_skip_index* skip_index_create(void);
+
+void skip_index_destroy(t_skip_index* index);
+
+// drops every entry, for when the list is emptied
+void skip_index_clear(t_skip_index* index);
+
+// indexes from scratch the nodes from first on, for when they were relinked in another order.
+// false when there was no memory, the index is then unusable until cleared
+bool skip_index_rebuild(t_skip_index* index, t_double_l_node* first);
+
+// node at position, which must be in range, of the list starting at first
+t_double_l_node* skip_index_find(t_skip_index* index, t_double_l_node* first, int position);
+
+// node was just linked in at position, the nodes from there on moved one up.
+// false when there was no memory, the index is then unusable until cleared
+bool skip_index_insert(t_skip_index* index, t_double_l_node* node, int position);
+
+// the node at position is about to be unlinked
+void skip_index_remove(t_skip_index* index, int position);
+
+#endif
@@ -0,0 +1,133 @@
+#ifndef TYPED_ARRAY_LIST_H_INCLUDED
+#define TYPED_ARRAY_LIST_H_INCLUDED
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "list_error.h"
+#include "array_list.h"
+
+// DEFINE_ARRAY_LIST(T, name) generates t_array_list_<name> and array_list_<name>_* functions
+// with the same shape as t_array_list, but storing T values inline in one contiguous array:
+// no malloc per element and no pointer to chase on every access.
+//
+//     DEFINE_ARRAY_LIST(int32_t, i32)
+//     t_array_list_i32 *list = array_list_i32_create();
+//     array_list_i32_add(list, 42);
+//
+// Use it once per type in a .c file (every function is static inline). T must be copyable
+// with =, elements are handed out by pointer where t_array_list hands out void*.
+
+#define DEFINE_ARRAY_LIST(T, name)                                                                  \
+                                                                                                    \
+    typedef struct                                                                                  \
+    {                                                                                               \
+        unsigned int capacity;                                                                      \
+        unsigned int element_count;                                                                 \
+        T *array;                                                                                   \
+    } t_array_list_##name;                                                                          \
+                                                                                                    \
+    static inline t_array_list_##name *array_list_##name##_create_with_capacity(unsigned int capacity) \
+    {                                                                                               \
+        t_array_list_##name *self = malloc(sizeof(t_array_list_##name));                            \
+        if (!self)                                                                                  \
+            return NULL;                                                                            \
+        self->element_count = 0;                                                                    \
+        self->capacity = capacity ? capacity : 1;                                                   \
+        self->array = malloc(self->capacity * sizeof(T));                                           \
+        if (!self->array)                                                                           \
+        {                                                                                           \
+            free(self);                                                                             \
+            return NULL;                                                                            \
+        }                                                                                           \
+        return self;                                                                                \
+    }                                                                                               \
+                                                                                                    \
+    static inline t_array_list_##name *array_list_##name##_create(void)                             \
+    {                                                                                               \
+        return array_list_##name##_create_with_capacity(BASE_CAPACITY);                             \
+    }                                                                                               \
+                                                                                                    \
+    static inline void array_list_##name##_destroy(t_array_list_##name *self)                       \
+    {                                                                                               \
+        free(self->array);                                                                          \
+        free(self);                                                                                 \
+    }                                                                                               \
+                                                                                                    \
+    static inline void array_list_##name##_clean(t_array_list_##name *self)                         \
+    {                                                                                               \
+        self->element_count = 0;                                                                    \
+    }                                                                                               \
+                                                                                                    \
+    static inline unsigned int array_list_##name##_size(t_array_list_##name *self)                  \
+    {                                                                                               \
+        return self->element_count;                                                                 \
+    }                                                                                               \
+                                                                                                    \
+    static inline bool array_list_##name##_is_empty(t_array_list_##name *self)                      \
+    {                                                                                               \
+        return self->element_count == 0;                                                            \
+    }                                                                                               \
+                                                                                                    \
+    static inline void array_list_##name##_foreach(t_array_list_##name *self, void (*operation)(T *)) \
+    {                                                                                               \
+        for (unsigned int i = 0; i < self->element_count; i++)                                      \
+            operation(&self->array[i]);                                                             \
+    }                                                                                               \
+                                                                                                    \
+    static inline t_list_error array_list_##name##_get(t_array_list_##name *self, int index, T *out_buffer) \
+    {                                                                                               \
+        if (index < 0 || (unsigned int)index >= self->element_count)                                \
+            return LIST_INDEX_OUT_OF_BOUNDS;                                                        \
+        if (out_buffer)                                                                             \
+            *out_buffer = self->array[index];                                                       \
+        return LIST_SUCCESS;                                                                        \
+    }                                                                                               \
+                                                                                                    \
+    static inline bool array_list_##name##_reserve(t_array_list_##name *self, unsigned int count)   \
+    {                                                                                               \
+        if (count <= self->capacity)                                                                \
+            return true;                                                                            \
+        unsigned int capacity = self->capacity;                                                     \
+        while (capacity < count)                                                                    \
+            capacity *= CAPACITY_MULTIPLIER;                                                        \
+        T *array = realloc(self->array, capacity * sizeof(T));                                      \
+        if (!array)                                                                                 \
+            return false;                                                                           \
+        self->array = array;                                                                        \
+        self->capacity = capacity;                                                                  \
+        return true;                                                                                \
+    }                                                                                               \
+                                                                                                    \
+    static inline t_list_error array_list_##name##_add_to_index(t_array_list_##name *self, int index, T data) \
+    {                                                                                               \
+        if (index < 0 || (unsigned int)index > self->element_count)                                 \
+            return LIST_INDEX_OUT_OF_BOUNDS;                                                        \
+        if (!array_list_##name##_reserve(self, self->element_count + 1))                            \
+        {                                                                                           \
+            fprintf(stderr, "Not enough memory for resizing array list %p", (void *)self);          \
+            return LIST_NO_MEMORY;                                                                  \
+        }                                                                                           \
+        memmove(&self->array[index + 1], &self->array[index], (self->element_count - index) * sizeof(T)); \
+        self->array[index] = data;                                                                  \
+        self->element_count++;                                                                      \
+        return LIST_SUCCESS;                                                                        \
+    }                                                                                               \
+                                                                                                    \
+    static inline t_list_error array_list_##name##_add(t_array_list_##name *self, T data)           \
+    {                                                                                               \
+        return array_list_##name##_add_to_index(self, self->element_count, data);                   \
+    }                                                                                               \
+                                                                                                    \
+    static inline t_list_error array_list_##name##_remove(t_array_list_##name *self, int index, T *deleted) \
+    {                                                                                               \
+        if (index < 0 || (unsigned int)index >= self->element_count)                                \
+            return LIST_INDEX_OUT_OF_BOUNDS;                                                        \
+        if (deleted)                                                                                \
+            *deleted = self->array[index];                                                          \
+        self->element_count--;                                                                      \
+        memmove(&self->array[index], &self->array[index + 1], (self->element_count - index) * sizeof(T)); \
+        return LIST_SUCCESS;                                                                        \
+    }
+
+#endif
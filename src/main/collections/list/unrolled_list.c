@@ -0,0 +1,446 @@
+#include "unrolled_list.h"
+
+static t_unrolled_node *create_node(void);
+
+static t_unrolled_node *insert_node_after(t_unrolled_list *list, t_unrolled_node *node);
+
+static void unlink_node(t_unrolled_list *list, t_unrolled_node *node);
+
+static t_unrolled_node *locate(t_unrolled_list *list, int index, int *offset);
+
+static bool insert_at(t_unrolled_list *list, t_unrolled_node *node, int offset, void *elem);
+
+static void *remove_at(t_unrolled_list *list, t_unrolled_node *node, int offset);
+
+static bool index_out_of_bounds(t_unrolled_list *list, int index);
+
+t_unrolled_list *unrolled_list_create(void)
+{
+    t_unrolled_list *list = malloc(sizeof(t_unrolled_list));
+    if (!list)
+        return NULL;
+    list->size = 0;
+    list->head = NULL;
+    list->tail = NULL;
+    return list;
+}
+
+void unrolled_list_destroy(t_unrolled_list *list)
+{
+    unrolled_list_clean(list);
+    free(list);
+}
+
+void unrolled_list_destroy_and_destroy_elements(t_unrolled_list *list, void (*element_destroyer)(void *))
+{
+    unrolled_list_clean_and_destroy_elements(list, element_destroyer);
+    free(list);
+}
+
+void unrolled_list_clean(t_unrolled_list *list)
+{
+    unrolled_list_clean_and_destroy_elements(list, NULL);
+}
+
+void unrolled_list_clean_and_destroy_elements(t_unrolled_list *list, void (*element_destroyer)(void *))
+{
+    t_unrolled_node *node = list->head;
+    while (node)
+    {
+        t_unrolled_node *next = node->next;
+        for (int i = 0; element_destroyer && i < node->count; i++)
+            element_destroyer(node->elements[i]);
+        free(node);
+        node = next;
+    }
+    list->head = NULL;
+    list->tail = NULL;
+    list->size = 0;
+}
+
+int unrolled_list_size(t_unrolled_list *list)
+{
+    return list->size;
+}
+
+bool unrolled_list_is_empty(t_unrolled_list *list)
+{
+    return unrolled_list_size(list) == 0;
+}
+
+void unrolled_list_add(t_unrolled_list *list, void *elem)
+{
+    // appending fills the tail up instead of splitting it, sequential adds leave full nodes
+    if (!list->tail || list->tail->count == UNROLLED_LIST_NODE_CAPACITY)
+    {
+        if (!insert_node_after(list, list->tail))
+        {
+            fprintf(stderr, "Not enough memory for a node of unrolled list %p", (void *)list);
+            return;
+        }
+    }
+    list->tail->elements[list->tail->count++] = elem;
+    list->size++;
+}
+
+void unrolled_list_add_first(t_unrolled_list *list, void *elem)
+{
+    unrolled_list_add_to_index(list, 0, elem);
+}
+
+t_list_error unrolled_list_add_to_index(t_unrolled_list *list, int index, void *elem)
+{
+    if (index < 0 || index > list->size)
+        return LIST_INDEX_OUT_OF_BOUNDS;
+    if (index == list->size)
+    {
+        // unrolled_list_add only reports a failed node allocation on stderr
+        int size = list->size;
+        unrolled_list_add(list, elem);
+        return list->size > size ? LIST_SUCCESS : LIST_NO_MEMORY;
+    }
+    int offset;
+    t_unrolled_node *node = locate(list, index, &offset);
+    return insert_at(list, node, offset, elem) ? LIST_SUCCESS : LIST_NO_MEMORY;
+}
+
+void unrolled_list_add_all(t_unrolled_list *self, t_unrolled_list *other)
+{
+    for (t_unrolled_node *node = self->head; node; node = node->next)
+    {
+        for (int i = 0; i < node->count; i++)
+            unrolled_list_add(other, node->elements[i]);
+    }
+}
+
+t_list_error unrolled_list_get(t_unrolled_list *list, int index, void **buffer)
+{
+    if (index_out_of_bounds(list, index))
+        return LIST_INDEX_OUT_OF_BOUNDS;
+    int offset;
+    t_unrolled_node *node = locate(list, index, &offset);
+    if (buffer)
+        *buffer = node->elements[offset];
+    return LIST_SUCCESS;
+}
+
+t_list_error unrolled_list_set(t_unrolled_list *list, int index, void *new_value, void **old_value)
+{
+    if (index_out_of_bounds(list, index))
+        return LIST_INDEX_OUT_OF_BOUNDS;
+    int offset;
+    t_unrolled_node *node = locate(list, index, &offset);
+    if (old_value)
+        *old_value = node->elements[offset];
+    node->elements[offset] = new_value;
+    return LIST_SUCCESS;
+}
+
+int unrolled_list_index_of(t_unrolled_list *list, void *elem)
+{
+    int index = 0;
+    for (t_unrolled_node *node = list->head; node; node = node->next)
+    {
+        for (int i = 0; i < node->count; i++)
+        {
+            if (node->elements[i] == elem)
+                return index + i;
+        }
+        index += node->count;
+    }
+    return -1;
+}
+
+t_list_error unrolled_list_remove(t_unrolled_list *list, int index, void **buffer)
+{
+    if (index_out_of_bounds(list, index))
+        return LIST_INDEX_OUT_OF_BOUNDS;
+    int offset;
+    t_unrolled_node *node = locate(list, index, &offset);
+    void *removed = remove_at(list, node, offset);
+    if (buffer)
+        *buffer = removed;
+    return LIST_SUCCESS;
+}
+
+t_list_error unrolled_list_remove_and_destroy(t_unrolled_list *list, int index, void (*element_destroyer)(void *))
+{
+    void *removed;
+    t_list_error err = unrolled_list_remove(list, index, &removed);
+    if (err == LIST_SUCCESS)
+        element_destroyer(removed);
+    return err;
+}
+
+t_list_error unrolled_list_remove_by_condition(t_unrolled_list *list, bool (*condition)(void *), void **buffer)
+{
+    for (t_unrolled_node *node = list->head; node; node = node->next)
+    {
+        for (int i = 0; i < node->count; i++)
+        {
+            if (condition(node->elements[i]))
+            {
+                void *removed = remove_at(list, node, i);
+                if (buffer)
+                    *buffer = removed;
+                return LIST_SUCCESS;
+            }
+        }
+    }
+    return LIST_NOT_FOUND;
+}
+
+t_list_error unrolled_list_find(t_unrolled_list *list, bool (*condition)(void *), void **buffer)
+{
+    for (t_unrolled_node *node = list->head; node; node = node->next)
+    {
+        for (int i = 0; i < node->count; i++)
+        {
+            if (condition(node->elements[i]))
+            {
+                if (buffer)
+                    *buffer = node->elements[i];
+                return LIST_SUCCESS;
+            }
+        }
+    }
+    return LIST_NOT_FOUND;
+}
+
+bool unrolled_list_any_satisfy(t_unrolled_list *list, bool (*condition)(void *))
+{
+    return unrolled_list_find(list, condition, NULL) == LIST_SUCCESS;
+}
+
+bool unrolled_list_all_satisfy(t_unrolled_list *list, bool (*condition)(void *))
+{
+    return unrolled_list_count(list, condition) == list->size;
+}
+
+int unrolled_list_count(t_unrolled_list *list, bool (*condition)(void *))
+{
+    int count = 0;
+    for (t_unrolled_node *node = list->head; node; node = node->next)
+    {
+        for (int i = 0; i < node->count; i++)
+            count += condition(node->elements[i]);
+    }
+    return count;
+}
+
+void unrolled_list_foreach(t_unrolled_list *list, void (*closure)(void *))
+{
+    for (t_unrolled_node *node = list->head; node; node = node->next)
+    {
+        for (int i = 0; i < node->count; i++)
+            closure(node->elements[i]);
+    }
+}
+
+t_unrolled_list *unrolled_list_duplicate(t_unrolled_list *list)
+{
+    t_unrolled_list *result = unrolled_list_create();
+    unrolled_list_add_all(list, result);
+    return result;
+}
+
+t_unrolled_list *unrolled_list_filter(t_unrolled_list *list, bool (*condition)(void *))
+{
+    t_unrolled_list *result = unrolled_list_create();
+    for (t_unrolled_node *node = list->head; node; node = node->next)
+    {
+        for (int i = 0; i < node->count; i++)
+        {
+            if (condition(node->elements[i]))
+                unrolled_list_add(result, node->elements[i]);
+        }
+    }
+    return result;
+}
+
+t_unrolled_list *unrolled_list_map(t_unrolled_list *list, void *(*mapper)(void *))
+{
+    t_unrolled_list *result = unrolled_list_create();
+    for (t_unrolled_node *node = list->head; node; node = node->next)
+    {
+        for (int i = 0; i < node->count; i++)
+            unrolled_list_add(result, mapper(node->elements[i]));
+    }
+    return result;
+}
+
+void *unrolled_list_foldl(t_unrolled_list *list, void *seed, void *(*operation)(void *, void *))
+{
+    void *acc = seed;
+    for (t_unrolled_node *node = list->head; node; node = node->next)
+    {
+        for (int i = 0; i < node->count; i++)
+            acc = operation(acc, node->elements[i]);
+    }
+    return acc;
+}
+
+void *unrolled_list_foldl1(t_unrolled_list *list, void *(*operation)(void *, void *))
+{
+    if (unrolled_list_is_empty(list))
+        return NULL;
+    void *acc = list->head->elements[0];
+    for (t_unrolled_node *node = list->head; node; node = node->next)
+    {
+        // the seed is the first element, skip it
+        for (int i = node == list->head ? 1 : 0; i < node->count; i++)
+            acc = operation(acc, node->elements[i]);
+    }
+    return acc;
+}
+
+void *unrolled_list_foldr(t_unrolled_list *list, void *seed, void *(*operation)(void *, void *))
+{
+    void *acc = seed;
+    for (t_unrolled_node *node = list->tail; node; node = node->prev)
+    {
+        for (int i = node->count - 1; i >= 0; i--)
+            acc = operation(node->elements[i], acc);
+    }
+    return acc;
+}
+
+void *unrolled_list_foldr1(t_unrolled_list *list, void *(*operation)(void *, void *))
+{
+    if (unrolled_list_is_empty(list))
+        return NULL;
+    void *acc = list->tail->elements[list->tail->count - 1];
+    for (t_unrolled_node *node = list->tail; node; node = node->prev)
+    {
+        // the seed is the last element, skip it
+        for (int i = node->count - (node == list->tail ? 2 : 1); i >= 0; i--)
+            acc = operation(node->elements[i], acc);
+    }
+    return acc;
+}
+
+static t_unrolled_node *create_node(void)
+{
+    t_unrolled_node *node = malloc(sizeof(t_unrolled_node));
+    if (!node)
+        return NULL;
+    node->next = NULL;
+    node->prev = NULL;
+    node->count = 0;
+    return node;
+}
+
+// an empty node right after node, or at the head when node is NULL
+static t_unrolled_node *insert_node_after(t_unrolled_list *list, t_unrolled_node *node)
+{
+    t_unrolled_node *new_node = create_node();
+    if (!new_node)
+        return NULL;
+    new_node->prev = node;
+    new_node->next = node ? node->next : list->head;
+    if (new_node->next)
+        new_node->next->prev = new_node;
+    else
+        list->tail = new_node;
+    if (node)
+        node->next = new_node;
+    else
+        list->head = new_node;
+    return new_node;
+}
+
+static void unlink_node(t_unrolled_list *list, t_unrolled_node *node)
+{
+    if (node->prev)
+        node->prev->next = node->next;
+    else
+        list->head = node->next;
+    if (node->next)
+        node->next->prev = node->prev;
+    else
+        list->tail = node->prev;
+    free(node);
+}
+
+// the node holding index and where in it, walking from whichever end is closer
+static t_unrolled_node *locate(t_unrolled_list *list, int index, int *offset)
+{
+    t_unrolled_node *node;
+    if (index < list->size / 2)
+    {
+        node = list->head;
+        while (index >= node->count)
+        {
+            index -= node->count;
+            node = node->next;
+        }
+        *offset = index;
+        return node;
+    }
+    int from_end = list->size - 1 - index;
+    node = list->tail;
+    while (from_end >= node->count)
+    {
+        from_end -= node->count;
+        node = node->prev;
+    }
+    *offset = node->count - 1 - from_end;
+    return node;
+}
+
+// false when a full node could not be split, elem is then not added
+static bool insert_at(t_unrolled_list *list, t_unrolled_node *node, int offset, void *elem)
+{
+    if (node->count == UNROLLED_LIST_NODE_CAPACITY)
+    {
+        // split the upper half off into a new node, then insert into whichever half it falls
+        t_unrolled_node *upper = insert_node_after(list, node);
+        if (!upper)
+        {
+            fprintf(stderr, "Not enough memory for a node of unrolled list %p", (void *)list);
+            return false;
+        }
+        int keep = UNROLLED_LIST_NODE_CAPACITY / 2;
+        upper->count = node->count - keep;
+        memcpy(upper->elements, &node->elements[keep], upper->count * sizeof(void *));
+        node->count = keep;
+        if (offset > keep)
+        {
+            node = upper;
+            offset -= keep;
+        }
+    }
+    memmove(&node->elements[offset + 1], &node->elements[offset], (node->count - offset) * sizeof(void *));
+    node->elements[offset] = elem;
+    node->count++;
+    list->size++;
+    return true;
+}
+
+static void *remove_at(t_unrolled_list *list, t_unrolled_node *node, int offset)
+{
+    void *removed = node->elements[offset];
+    node->count--;
+    memmove(&node->elements[offset], &node->elements[offset + 1], (node->count - offset) * sizeof(void *));
+    list->size--;
+
+    if (node->count == 0)
+    {
+        unlink_node(list, node);
+    }
+    else if (node->count < UNROLLED_LIST_NODE_CAPACITY / 2 && node->next
+             && node->count + node->next->count <= UNROLLED_LIST_NODE_CAPACITY)
+    {
+        // keeps nodes at least half full on average, or iteration degrades to a linked list
+        t_unrolled_node *next = node->next;
+        memcpy(&node->elements[node->count], next->elements, next->count * sizeof(void *));
+        node->count += next->count;
+        unlink_node(list, next);
+    }
+    return removed;
+}
+
+static bool index_out_of_bounds(t_unrolled_list *list, int index)
+{
+    return index < 0 || index >= list->size;
+}
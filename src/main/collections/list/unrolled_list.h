@@ -0,0 +1,97 @@
+#ifndef UNROLLED_LIST_H_INCLUDED
+#define UNROLLED_LIST_H_INCLUDED
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+#include "list_error.h"
+
+// elements per node: two links, the count and 13 pointers make a 128 byte node (two cache
+// lines on most machines) on 64 bit targets
+#define UNROLLED_LIST_NODE_CAPACITY 13
+
+typedef struct unrolled_node{
+    struct unrolled_node* next;
+    struct unrolled_node* prev;
+    int count;
+    void* elements[UNROLLED_LIST_NODE_CAPACITY];
+} t_unrolled_node;
+
+// Doubly linked list of small arrays. Walking it touches one node per
+// UNROLLED_LIST_NODE_CAPACITY elements instead of one per element, and inserting in the
+// middle still only moves the elements of a single node. Full nodes split in half,
+// nodes that fall under half full after a removal merge with the next one if they fit
+typedef struct
+{
+    int size;
+    t_unrolled_node* head;
+    t_unrolled_node* tail;
+} t_unrolled_list;
+
+// creation/deletion
+
+t_unrolled_list* unrolled_list_create(void);
+
+void unrolled_list_destroy(t_unrolled_list* list);
+
+void unrolled_list_destroy_and_destroy_elements(t_unrolled_list* list, void (*element_destroyer)(void*));
+
+void unrolled_list_clean(t_unrolled_list* list);
+
+void unrolled_list_clean_and_destroy_elements(t_unrolled_list* list, void (*element_destroyer)(void*));
+
+// list primitives
+
+int unrolled_list_size(t_unrolled_list* list);
+
+bool unrolled_list_is_empty(t_unrolled_list* list);
+
+void unrolled_list_add(t_unrolled_list* list, void* elem);
+
+void unrolled_list_add_first(t_unrolled_list* list, void* elem);
+
+// LIST_NO_MEMORY when no node could be allocated for elem, the list is then unchanged
+t_list_error unrolled_list_add_to_index(t_unrolled_list* list, int index, void* elem);
+
+void unrolled_list_add_all(t_unrolled_list* self, t_unrolled_list* other);
+
+t_list_error unrolled_list_get(t_unrolled_list* list, int index, void** buffer);
+
+t_list_error unrolled_list_set(t_unrolled_list* list, int index, void* new_value, void** old_value);
+
+int unrolled_list_index_of(t_unrolled_list* list, void* elem);
+
+t_list_error unrolled_list_remove(t_unrolled_list* list, int index, void** buffer);
+
+t_list_error unrolled_list_remove_and_destroy(t_unrolled_list* list, int index, void (*element_destroyer)(void*));
+
+t_list_error unrolled_list_remove_by_condition(t_unrolled_list* list, bool (*condition)(void*), void** buffer);
+
+t_list_error unrolled_list_find(t_unrolled_list* list, bool (*condition)(void*), void** buffer);
+
+bool unrolled_list_any_satisfy(t_unrolled_list* list, bool (*condition)(void*));
+
+bool unrolled_list_all_satisfy(t_unrolled_list* list, bool (*condition)(void*));
+
+int unrolled_list_count(t_unrolled_list* list, bool (*condition)(void*));
+
+void unrolled_list_foreach(t_unrolled_list* list, void (*closure)(void*));
+
+// higher order
+
+t_unrolled_list* unrolled_list_duplicate(t_unrolled_list* list);
+
+t_unrolled_list* unrolled_list_filter(t_unrolled_list* list, bool (*condition)(void*));
+
+t_unrolled_list* unrolled_list_map(t_unrolled_list* list, void* (*mapper)(void*));
+
+void* unrolled_list_foldl(t_unrolled_list* list, void* seed, void* (*operation)(void*, void*));
+
+void* unrolled_list_foldl1(t_unrolled_list* list, void* (*operation)(void*, void*));
+
+void* unrolled_list_foldr(t_unrolled_list* list, void* seed, void* (*operation)(void*, void*));
+
+void* unrolled_list_foldr1(t_unrolled_list* list, void* (*operation)(void*, void*));
+
+#endif
@@ -0,0 +1,180 @@
+
+#include "concurrent_hashmap.h"
+#include "hash_map_keys.h"
+#include "../power_of_two.h"
+
+static t_hash_map_stripe *stripe_for(t_concurrent_hash_map *self, unsigned long hash);
+static void destroy_stripes(t_concurrent_hash_map *self, int count, void (*element_destroyer)(void *));
+
+t_concurrent_hash_map *concurrent_hash_map_create(void)
+{
+    return concurrent_hash_map_create_with_options((t_concurrent_hash_map_options){0});
+}
+
+t_concurrent_hash_map *concurrent_hash_map_create_with_options(t_concurrent_hash_map_options options)
+{
+    t_concurrent_hash_map *self = malloc(sizeof(t_concurrent_hash_map));
+    if (!self)
+        return NULL;
+
+    self->stripe_count = (int)round_up_to_power_of_two(options.stripe_count > 0 ? options.stripe_count : CONCURRENT_HASH_MAP_DEFAULT_STRIPES);
+    self->stripes = calloc(self->stripe_count, sizeof(t_hash_map_stripe));
+    if (!self->stripes)
+    {
+        free(self);
+        return NULL;
+    }
+
+    options.map_options.incremental_rehash = false;
+    for (int i = 0; i < self->stripe_count; i++)
+    {
+        self->stripes[i].map = hash_map_create_with_options(options.map_options);
+        if (!self->stripes[i].map || pthread_rwlock_init(&self->stripes[i].lock, NULL) != 0)
+        {
+            if (self->stripes[i].map)
+                hash_map_destroy(self->stripes[i].map);
+            destroy_stripes(self, i, NULL);
+            free(self->stripes);
+            free(self);
+            return NULL;
+        }
+    }
+    return self;
+}
+
+void concurrent_hash_map_destroy(t_concurrent_hash_map *self)
+{
+    concurrent_hash_map_destroy_and_destroy_elements(self, NULL);
+}
+
+void concurrent_hash_map_destroy_and_destroy_elements(t_concurrent_hash_map *self, void (*element_destroyer)(void *))
+{
+    destroy_stripes(self, self->stripe_count, element_destroyer);
+    free(self->stripes);
+    free(self);
+}
+
+void concurrent_hash_map_clean(t_concurrent_hash_map *self)
+{
+    concurrent_hash_map_clean_and_destroy_elements(self, NULL);
+}
+
+void concurrent_hash_map_clean_and_destroy_elements(t_concurrent_hash_map *self, void (*element_destroyer)(void *))
+{
+    for (int i = 0; i < self->stripe_count; i++)
+    {
+        pthread_rwlock_wrlock(&self->stripes[i].lock);
+        hash_map_clean_and_destroy_elements(self->stripes[i].map, element_destroyer);
+        pthread_rwlock_unlock(&self->stripes[i].lock);
+    }
+}
+
+void concurrent_hash_map_put(t_concurrent_hash_map *self, char *key, void *data)
+{
+    size_t length = strlen(key);
+    // every stripe hashes the same way, the first one's function does for all of them
+    unsigned long hash = hash_map_hash_key(self->stripes[0].map, key, length);
+    t_hash_map_stripe *stripe = stripe_for(self, hash);
+    pthread_rwlock_wrlock(&stripe->lock);
+    hash_map_put_hashed(stripe->map, key, length, hash, data);
+    pthread_rwlock_unlock(&stripe->lock);
+}
+
+void *concurrent_hash_map_get(t_concurrent_hash_map *self, char *key)
+{
+    size_t length = strlen(key);
+    unsigned long hash = hash_map_hash_key(self->stripes[0].map, key, length);
+    t_hash_map_stripe *stripe = stripe_for(self, hash);
+    pthread_rwlock_rdlock(&stripe->lock);
+    void *value = hash_map_get_hashed(stripe->map, key, length, hash);
+    pthread_rwlock_unlock(&stripe->lock);
+    return value;
+}
+
+void *concurrent_hash_map_remove(t_concurrent_hash_map *self, char *key)
+{
+    size_t length = strlen(key);
+    unsigned long hash = hash_map_hash_key(self->stripes[0].map, key, length);
+    t_hash_map_stripe *stripe = stripe_for(self, hash);
+    void *value = NULL;
+    pthread_rwlock_wrlock(&stripe->lock);
+    hash_map_remove_hashed(stripe->map, key, length, hash, &value);
+    pthread_rwlock_unlock(&stripe->lock);
+    return value;
+}
+
+void concurrent_hash_map_remove_and_destroy_element(t_concurrent_hash_map *self, char *key, void (*element_destroyer)(void *))
+{
+    size_t length = strlen(key);
+    unsigned long hash = hash_map_hash_key(self->stripes[0].map, key, length);
+    t_hash_map_stripe *stripe = stripe_for(self, hash);
+    void *value;
+    pthread_rwlock_wrlock(&stripe->lock);
+    bool removed = hash_map_remove_hashed(stripe->map, key, length, hash, &value);
+    pthread_rwlock_unlock(&stripe->lock);
+    if (removed && element_destroyer)
+        element_destroyer(value);
+}
+
+void *concurrent_hash_map_compute_if_absent(t_concurrent_hash_map *self, char *key, void *(*factory)(char *))
+{
+    size_t length = strlen(key);
+    unsigned long hash = hash_map_hash_key(self->stripes[0].map, key, length);
+    t_hash_map_stripe *stripe = stripe_for(self, hash);
+
+    // most calls find the key, only take the write lock when it looks missing
+    pthread_rwlock_rdlock(&stripe->lock);
+    void *value = hash_map_get_hashed(stripe->map, key, length, hash);
+    pthread_rwlock_unlock(&stripe->lock);
+    if (value)
+        return value;
+
+    pthread_rwlock_wrlock(&stripe->lock);
+    // another writer may have inserted it between both locks
+    value = hash_map_get_hashed(stripe->map, key, length, hash);
+    if (!value)
+    {
+        value = factory(key);
+        if (value)
+            hash_map_put_hashed(stripe->map, key, length, hash, value);
+    }
+    pthread_rwlock_unlock(&stripe->lock);
+    return value;
+}
+
+void concurrent_hash_map_iterate(t_concurrent_hash_map *self, void (*iterator)(char *, void *))
+{
+    for (int i = 0; i < self->stripe_count; i++)
+    {
+        pthread_rwlock_rdlock(&self->stripes[i].lock);
+        hash_map_iterate(self->stripes[i].map, iterator);
+        pthread_rwlock_unlock(&self->stripes[i].lock);
+    }
+}
+
+int concurrent_hash_map_size(t_concurrent_hash_map *self)
+{
+    int size = 0;
+    for (int i = 0; i < self->stripe_count; i++)
+    {
+        pthread_rwlock_rdlock(&self->stripes[i].lock);
+        size += hash_map_size(self->stripes[i].map);
+        pthread_rwlock_unlock(&self->stripes[i].lock);
+    }
+    return size;
+}
+
+// the middle bits of the spread hash, whatever the width of unsigned long
+static t_hash_map_stripe *stripe_for(t_concurrent_hash_map *self, unsigned long hash)
+{
+    return &self->stripes[(hash >> (sizeof(unsigned long) * 4)) & (self->stripe_count - 1)];
+}
+
+static void destroy_stripes(t_concurrent_hash_map *self, int count, void (*element_destroyer)(void *))
+{
+    for (int i = 0; i < count; i++)
+    {
+        pthread_rwlock_destroy(&self->stripes[i].lock);
+        hash_map_destroy_and_destroy_elements(self->stripes[i].map, element_destroyer);
+    }
+}
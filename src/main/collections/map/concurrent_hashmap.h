@@ -0,0 +1,64 @@
+#ifndef CONCURRENT_HASH_MAP_H_INCLUDED
+#define CONCURRENT_HASH_MAP_H_INCLUDED
+
+#include <pthread.h>
+#include "hashmap.h"
+
+// rounded up to a power of two, the stripe is picked from the middle bits of the spread hash:
+// stripes take the low bits for their index and swiss tables the top ones for their tags.
+// The key is hashed once, the stripe's map is handed the same hash
+#define CONCURRENT_HASH_MAP_DEFAULT_STRIPES 64
+
+// Lock striping: the key space is split into stripes, each one a plain t_hash_map behind
+// its own rwlock. Readers of a stripe run in parallel, writers only block their own stripe
+// and every stripe grows on its own, so a resize never stops the rest of the map.
+
+typedef struct{
+    pthread_rwlock_t lock;
+    t_hash_map* map;
+} t_hash_map_stripe;
+
+// zero initialized options give the default map: default stripes over default t_hash_map
+typedef struct{
+    int stripe_count;
+    // incremental_rehash is ignored, a lookup would have to move buckets under a read lock
+    t_hash_map_options map_options;
+} t_concurrent_hash_map_options;
+
+typedef struct{
+    int stripe_count;
+    t_hash_map_stripe* stripes;
+} t_concurrent_hash_map;
+
+
+t_concurrent_hash_map* concurrent_hash_map_create(void);
+
+t_concurrent_hash_map* concurrent_hash_map_create_with_options(t_concurrent_hash_map_options options);
+
+void concurrent_hash_map_destroy(t_concurrent_hash_map* self);
+
+void concurrent_hash_map_destroy_and_destroy_elements(t_concurrent_hash_map* self, void(*element_destroyer)(void*));
+
+void concurrent_hash_map_clean(t_concurrent_hash_map* self);
+
+void concurrent_hash_map_clean_and_destroy_elements(t_concurrent_hash_map* self, void(*element_destroyer)(void*));
+
+void concurrent_hash_map_put(t_concurrent_hash_map* self, char* key, void* data);
+
+// the map never touches the values: freeing one another thread may have just got is up to the caller
+void* concurrent_hash_map_get(t_concurrent_hash_map* self, char* key);
+
+void* concurrent_hash_map_remove(t_concurrent_hash_map* self, char* key);
+
+void concurrent_hash_map_remove_and_destroy_element(t_concurrent_hash_map* self, char* key, void(*element_destroyer)(void*));
+
+// returns the value of key, creating it with factory(key) first if it is missing. The check and
+// the insert happen under the stripe lock, so factory runs at most once per key
+void* concurrent_hash_map_compute_if_absent(t_concurrent_hash_map* self, char* key, void*(*factory)(char*));
+
+// each stripe is visited under its read lock, so this is a snapshot per stripe, not of the whole map
+void concurrent_hash_map_iterate(t_concurrent_hash_map* self, void(*iterator)(char*,void*));
+
+int concurrent_hash_map_size(t_concurrent_hash_map* self);
+
+#endif
@@ -0,0 +1,159 @@
+#include "hash_functions.h"
+#include <stdint.h>
+#include <string.h>
+
+#define FNV_OFFSET_BASIS 0xcbf29ce484222325ULL
+#define FNV_PRIME 0x100000001b3ULL
+
+static const uint64_t wy_secret[4] = {
+    0xa0761d6478bd642fULL, 0xe7037ed1a0b428dbULL, 0x8ebc6af09c88c6e3ULL, 0x589965cc75374cc3ULL
+};
+
+static uint64_t wy_mix(uint64_t a, uint64_t b);
+static void wy_multiply(uint64_t *a, uint64_t *b);
+static uint64_t read_64(const unsigned char *p);
+static uint64_t read_32(const unsigned char *p);
+static uint64_t read_up_to_3(const unsigned char *p, size_t length);
+
+unsigned long hash_djb2(const char *key)
+{
+    unsigned long hash = 5381;
+    int c;
+
+    while ((c = *key++))
+    {
+        hash = ((hash << 5) + hash) + c; // hash * 33 + c
+    }
+
+    return hash;
+}
+
+unsigned long hash_djb2_n(const char *key, size_t length)
+{
+    unsigned long hash = 5381;
+    for (size_t i = 0; i < length; i++)
+    {
+        hash = ((hash << 5) + hash) + key[i];
+    }
+    return hash;
+}
+
+unsigned long hash_fnv1a(const char *key)
+{
+    return hash_fnv1a_n(key, strlen(key));
+}
+
+unsigned long hash_fnv1a_n(const char *key, size_t length)
+{
+    uint64_t hash = FNV_OFFSET_BASIS;
+    for (size_t i = 0; i < length; i++)
+    {
+        hash ^= (unsigned char)key[i];
+        hash *= FNV_PRIME;
+    }
+    return (unsigned long)hash;
+}
+
+unsigned long hash_wy(const char *key)
+{
+    return hash_wy_n(key, strlen(key));
+}
+
+unsigned long hash_wy_n(const char *key, size_t length)
+{
+    const unsigned char *p = (const unsigned char *)key;
+    uint64_t seed = wy_mix(wy_secret[0], wy_secret[1]);
+    uint64_t a, b;
+
+    if (length <= 16)
+    {
+        if (length >= 4)
+        {
+            // two overlapping 4 byte reads from each end cover every length from 4 to 16
+            size_t shift = (length >> 3) << 2;
+            a = (read_32(p) << 32) | read_32(p + shift);
+            b = (read_32(p + length - 4) << 32) | read_32(p + length - 4 - shift);
+        }
+        else
+        {
+            a = length > 0 ? read_up_to_3(p, length) : 0;
+            b = 0;
+        }
+    }
+    else
+    {
+        size_t remaining = length;
+        if (remaining > 48)
+        {
+            // three independent lanes keep the multipliers busy
+            uint64_t seed1 = seed, seed2 = seed;
+            do
+            {
+                seed = wy_mix(read_64(p) ^ wy_secret[1], read_64(p + 8) ^ seed);
+                seed1 = wy_mix(read_64(p + 16) ^ wy_secret[2], read_64(p + 24) ^ seed1);
+                seed2 = wy_mix(read_64(p + 32) ^ wy_secret[3], read_64(p + 40) ^ seed2);
+                p += 48;
+                remaining -= 48;
+            } while (remaining > 48);
+            seed ^= seed1 ^ seed2;
+        }
+        while (remaining > 16)
+        {
+            seed = wy_mix(read_64(p) ^ wy_secret[1], read_64(p + 8) ^ seed);
+            p += 16;
+            remaining -= 16;
+        }
+        a = read_64(p + remaining - 16);
+        b = read_64(p + remaining - 8);
+    }
+
+    a ^= wy_secret[1];
+    b ^= seed;
+    wy_multiply(&a, &b);
+    return (unsigned long)wy_mix(a ^ wy_secret[0] ^ length, b ^ wy_secret[1]);
+}
+
+t_hash_function_n hash_function_with_length(t_hash_function hash_function)
+{
+    if (hash_function == hash_djb2)
+        return hash_djb2_n;
+    if (hash_function == hash_fnv1a)
+        return hash_fnv1a_n;
+    if (hash_function == hash_wy)
+        return hash_wy_n;
+    return NULL;
+}
+
+static void wy_multiply(uint64_t *a, uint64_t *b)
+{
+    __extension__ typedef unsigned __int128 t_uint128;
+    t_uint128 product = (t_uint128)*a * *b;
+    *a = (uint64_t)product;
+    *b = (uint64_t)(product >> 64);
+}
+
+static uint64_t wy_mix(uint64_t a, uint64_t b)
+{
+    wy_multiply(&a, &b);
+    return a ^ b;
+}
+
+// memcpy keeps unaligned reads legal, compilers turn it into a single load
+static uint64_t read_64(const unsigned char *p)
+{
+    uint64_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static uint64_t read_32(const unsigned char *p)
+{
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static uint64_t read_up_to_3(const unsigned char *p, size_t length)
+{
+    return ((uint64_t)p[0] << 16) | ((uint64_t)p[length >> 1] << 8) | p[length - 1];
+}
@@ -0,0 +1,30 @@
+#ifndef HASH_FUNCTIONS_H_INCLUDED
+#define HASH_FUNCTIONS_H_INCLUDED
+
+#include <stddef.h>
+
+// null terminated keys, the shape hash_map_create_with_hash_function expects
+typedef unsigned long (*t_hash_function)(const char*);
+
+// keys with a known length, no strlen and no terminator needed
+typedef unsigned long (*t_hash_function_n)(const char*, size_t);
+
+// classic hash * 33 + c, one byte per iteration (default)
+unsigned long hash_djb2(const char* key);
+
+unsigned long hash_djb2_n(const char* key, size_t length);
+
+// 64 bit FNV-1a, one byte per iteration but a much better avalanche than djb2
+unsigned long hash_fnv1a(const char* key);
+
+unsigned long hash_fnv1a_n(const char* key, size_t length);
+
+// wyhash style: 8 to 48 bytes per iteration folded with 64x64->128 bit multiplies
+unsigned long hash_wy(const char* key);
+
+unsigned long hash_wy_n(const char* key, size_t length);
+
+// the length aware twin of a built-in t_hash_function, NULL for user functions
+t_hash_function_n hash_function_with_length(t_hash_function hash_function);
+
+#endif
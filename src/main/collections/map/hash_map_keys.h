@@ -0,0 +1,29 @@
+#ifndef HASH_MAP_KEYS_H_INCLUDED
+#define HASH_MAP_KEYS_H_INCLUDED
+
+#include "hashmap.h"
+
+// Key storage shared by every t_hash_map backend, according to map->key_storage
+
+char *hash_map_store_key(t_hash_map *map, char *key, size_t length);
+
+void hash_map_release_key(t_hash_map *map, char *key, size_t length);
+
+// the user hash of key, already spread, as every backend expects it. The _hashed entry points
+// skip hashing for callers that needed the hash first, like t_concurrent_hash_map picking a stripe
+
+unsigned long hash_map_hash_key(t_hash_map *map, char *key, size_t length);
+
+void hash_map_put_hashed(t_hash_map *self, char *key, size_t length, unsigned long hash, void *data);
+
+void* hash_map_get_hashed(t_hash_map* self, char* key, size_t length, unsigned long hash);
+
+bool hash_map_remove_hashed(t_hash_map* self, char* key, size_t length, unsigned long hash, void** out_value);
+
+// callers compare the cached hashes first, this only runs on a probable match
+static inline bool hash_map_key_equals(const char *stored, size_t stored_length, const char *key, size_t length)
+{
+    return stored_length == length && memcmp(stored, key, length) == 0;
+}
+
+#endif
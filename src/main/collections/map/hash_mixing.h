@@ -0,0 +1,16 @@
+#ifndef HASH_MIXING_H_INCLUDED
+#define HASH_MIXING_H_INCLUDED
+
+// Probing tables index with hash & mask (and swiss tables also take a tag from the top bits),
+// so fold every bit of the user hash into the whole word first (murmur3 finalizer).
+// Otherwise hashes like djb2 of sequential keys land in one long cluster.
+static inline unsigned long spread_hash(unsigned long hash)
+{
+    unsigned long long h = hash;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return (unsigned long)h;
+}
+
+#endif
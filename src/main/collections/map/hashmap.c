@@ -1,48 +1,106 @@
-#include "hashmap.h"
 
-static t_hash_node *create_node(char *key, void *data, unsigned long hash);
-static unsigned long hash_djb2(const char *str);
-static t_hash_node *find_node(t_hash_map *map, char *key, unsigned long *out_hash, int *out_index, t_hash_node **out_prev);
+#include "hashmap.h"
+#include "open_addressing.h"
+#include "swiss_table.h"
+#include "hash_map_keys.h"
+#include "hash_mixing.h"
+
+static t_hash_node *create_node(t_hash_map *map, char *key, size_t length, void *data, unsigned long hash);
+static t_hash_node *find_node(t_hash_map *map, char *key, size_t length, unsigned long hash, t_hash_node ***out_bucket, t_hash_node **out_prev);
+static t_hash_node *find_in_bucket(t_hash_node *node, char *key, size_t length, unsigned long hash, t_hash_node **out_prev);
+static void hash_window(t_hash_map *map, char **keys, int count, size_t *lengths, unsigned long *hashes);
+static void prefetch_hash(t_hash_map *map, unsigned long hash);
 static double calc_load_factor(t_hash_map *map);
 static void resize(t_hash_map *map, int new_capacity);
-static void destroy_node(t_hash_node *node, void(*element_destroyer)(void*));
-static void* remove_element(t_hash_map* map, char* key);
-static void remove_and_destroy_element(t_hash_map* map, char* key,  void(*element_destroyer)(void*));
+static void move_chain(t_hash_node *node, t_hash_node **buckets, int capacity);
+static bool is_rehashing(t_hash_map *map);
+static void start_incremental_resize(t_hash_map *map, int new_capacity);
+static void rehash_step(t_hash_map *map, int bucket_count);
+static void finish_rehash(t_hash_map *map);
+static void destroy_node(t_hash_map *map, t_hash_node *node, void(*element_destroyer)(void*));
+static void clean_buckets(t_hash_map* map, void(*element_destroyer)(void*));
+static bool needs_key_compaction(t_hash_map *map);
+static void compact_keys(t_hash_map *map);
+static bool relocate_keys(t_hash_map *map, t_key_arena *arena, char **copies, bool commit);
+static bool relocate_key(char **key, size_t length, t_key_arena *arena, char **copies, int index, bool commit);
+static void put_element(t_hash_map *map, char *key, size_t length, unsigned long hash, void *data);
+static bool remove_element(t_hash_map* map, char* key, size_t length, unsigned long hash, void** out_value);
+static bool internal_hash_map_remove(t_hash_map* self, char* key, size_t length, void** out_value);
 static void internal_hash_map_clean_and_destroy_elements(t_hash_map* self,void(*element_destroyer)(void*));
 static void increment_map_size(t_hash_map* self);
 static void decrement_map_size(t_hash_map* self);
 
 t_hash_map *hash_map_create(void)
 {
+    return hash_map_create_with_options((t_hash_map_options){0});
+}
+
+t_hash_map* hash_map_create_with_hash_function(t_hash_function hash_function){
+    return hash_map_create_with_options((t_hash_map_options){.hash_function = hash_function});
+}
+
+t_hash_map* hash_map_create_with_options(t_hash_map_options options){
     t_hash_map *map = malloc(sizeof(t_hash_map));
     if (!map)
         return NULL;
 
-    map->capacity = MAP_INITIAL_CAPACITY;
+    map->type = options.type;
     map->load_factor = 0;
     map->size = 0;
-    map->buckets = calloc(map->capacity, sizeof(t_hash_node*));
-    map->hash_function = hash_djb2;
-    return map;
-}
+    map->buckets = NULL;
+    map->incremental_rehash = options.incremental_rehash;
+    map->old_buckets = NULL;
+    map->old_capacity = 0;
+    map->rehash_index = 0;
+    map->slots = NULL;
+    map->control_bytes = NULL;
+    map->growth_left = 0;
+    map->hash_function = options.hash_function ? options.hash_function : hash_djb2;
+    map->hash_function_n = options.hash_function_n ? options.hash_function_n : hash_function_with_length(map->hash_function);
+    map->key_storage = options.key_storage;
+    map->key_arena = NULL;
+
+    if (map->key_storage == HASH_MAP_KEYS_ARENA) {
+        map->key_arena = key_arena_create();
+        if (!map->key_arena) {
+            free(map);
+            return NULL;
+        }
+    }
 
-t_hash_map* hash_map_create_with_hash_function(t_hash_function hash_function){
-    t_hash_map* map = hash_map_create();
-    if(!map) return NULL;
-    map->hash_function = hash_function;
+    bool initialized;
+    switch (map->type) {
+    case HASH_MAP_OPEN_ADDRESSING:
+        initialized = open_addressing_init(map);
+        break;
+    case HASH_MAP_SWISS_TABLE:
+        initialized = swiss_table_init(map);
+        break;
+    default:
+        map->capacity = MAP_INITIAL_CAPACITY;
+        map->buckets = calloc(map->capacity, sizeof(t_hash_node*));
+        initialized = map->buckets != NULL;
+    }
+
+    if (!initialized) {
+        if (map->key_arena) key_arena_destroy(map->key_arena);
+        free(map);
+        return NULL;
+    }
     return map;
 }
 
 void hash_map_destroy(t_hash_map *self)
 {
-    hash_map_clean(self);
-    free(self->buckets);
-    free(self);
+    hash_map_destroy_and_destroy_elements(self,NULL);
 }
 
 void hash_map_destroy_and_destroy_elements(t_hash_map *self, void(*element_destroyer)(void*))
 {
     hash_map_clean_and_destroy_elements(self,element_destroyer);
+    open_addressing_destroy(self);
+    swiss_table_destroy(self);
+    if (self->key_arena) key_arena_destroy(self->key_arena);
     free(self->buckets);
     free(self);
 }
@@ -53,47 +111,84 @@ int hash_map_size(t_hash_map* self){
 
 void hash_map_put(t_hash_map *self, char *key, void *data)
 {
-    unsigned long hash;
-    int index;
-    
-    t_hash_node *existing_node = find_node(self, key, &hash, &index,NULL);
-
-    if (existing_node)
-    {
-        existing_node->value = data;
-        return;
-    }
+    hash_map_put_n(self, key, strlen(key), data);
+}
 
-    // Key not found, create new node
-    t_hash_node *new = create_node(key, data, hash);
-    new->next = self->buckets[index];
-    self->buckets[index] = new;
-    
-    increment_map_size(self);
+void hash_map_put_n(t_hash_map *self, char *key, size_t length, void *data)
+{
+    hash_map_put_hashed(self, key, length, hash_map_hash_key(self, key, length), data);
+}
 
-    // Resize if necessary
-    if (self->load_factor > DEFAULT_LOAD_FACTOR) {
-        resize(self, self->capacity * DEFAULT_CAPACITY_MULTIPLIER);
-        self->load_factor = calc_load_factor(self);
+void hash_map_put_batch(t_hash_map *self, char **keys, int count, void **values)
+{
+    size_t lengths[HASH_MAP_BATCH_WINDOW];
+    unsigned long hashes[HASH_MAP_BATCH_WINDOW];
+
+    for (int start = 0; start < count; start += HASH_MAP_BATCH_WINDOW) {
+        int window = count - start < HASH_MAP_BATCH_WINDOW ? count - start : HASH_MAP_BATCH_WINDOW;
+        hash_window(self, keys + start, window, lengths, hashes);
+        // a resize halfway through only makes the remaining prefetches useless, never wrong
+        for (int i = 0; i < window; i++)
+            hash_map_put_hashed(self, keys[start + i], lengths[i], hashes[i], values[start + i]);
     }
 }
 
 void* hash_map_get(t_hash_map* self, char* key){
-    t_hash_node* node = find_node(self,key,NULL,NULL,NULL);
-    return node ? node->value : NULL;
+    return hash_map_get_n(self,key,strlen(key));
+}
+
+void* hash_map_get_n(t_hash_map* self, char* key, size_t length){
+    return hash_map_get_hashed(self,key,length,hash_map_hash_key(self,key,length));
+}
+
+void hash_map_get_batch(t_hash_map* self, char** keys, int count, void** out_values){
+    size_t lengths[HASH_MAP_BATCH_WINDOW];
+    unsigned long hashes[HASH_MAP_BATCH_WINDOW];
+
+    for(int start = 0; start < count; start += HASH_MAP_BATCH_WINDOW){
+        int window = count - start < HASH_MAP_BATCH_WINDOW ? count - start : HASH_MAP_BATCH_WINDOW;
+        hash_window(self,keys + start,window,lengths,hashes);
+        for(int i = 0; i < window; i++)
+            out_values[start + i] = hash_map_get_hashed(self,keys[start + i],lengths[i],hashes[i]);
+    }
 }
 
 void* hash_map_remove(t_hash_map* self, char* key){
-    return remove_element(self,key);
+    return hash_map_remove_n(self,key,strlen(key));
+}
+
+void* hash_map_remove_n(t_hash_map* self, char* key, size_t length){
+    void* data = NULL;
+    internal_hash_map_remove(self,key,length,&data);
+    return data;
 }
 
 void hash_map_remove_and_destroy_element(t_hash_map* self, char* key, void(*element_destroyer)(void*)){
-     remove_and_destroy_element(self,key,element_destroyer);
+    void* data;
+    if(internal_hash_map_remove(self,key,strlen(key),&data) && element_destroyer) element_destroyer(data);
 }
 
 
 void hash_map_iterate(t_hash_map* map, void(*iterator)(char*,void*)){
+    switch(map->type){
+    case HASH_MAP_OPEN_ADDRESSING:
+        open_addressing_iterate(map,iterator);
+        return;
+    case HASH_MAP_SWISS_TABLE:
+        swiss_table_iterate(map,iterator);
+        return;
+    default:
+        break;
+    }
     t_hash_node* node = NULL;
+    // mid rehash every node lives in exactly one of the two tables
+    for(int i =0; i< map->old_capacity; i++){
+        node = map->old_buckets[i];
+        while(node){
+            iterator(node->key,node->value);
+            node = node->next;
+        }
+    }
     for(int i =0; i< map->capacity; i++){
         node = map->buckets[i];
         while(node){
@@ -103,6 +198,54 @@ void hash_map_iterate(t_hash_map* map, void(*iterator)(char*,void*)){
     }
 }
 
+void hash_map_iterator_init(t_hash_map_iterator* iterator, t_hash_map* map){
+    iterator->map = map;
+    iterator->index = 0;
+    iterator->in_old_buckets = map->old_capacity > 0;
+    iterator->node = NULL;
+}
+
+bool hash_map_iterator_next(t_hash_map_iterator* iterator, char** key, void** value){
+    t_hash_map* map = iterator->map;
+    int slot;
+    switch(map->type){
+    case HASH_MAP_OPEN_ADDRESSING:
+        slot = open_addressing_next_slot(map, iterator->index);
+        break;
+    case HASH_MAP_SWISS_TABLE:
+        slot = swiss_table_next_slot(map, iterator->index);
+        break;
+    default:
+        while(!iterator->node){
+            int capacity = iterator->in_old_buckets ? map->old_capacity : map->capacity;
+            if(iterator->index < capacity){
+                iterator->node = (iterator->in_old_buckets ? map->old_buckets : map->buckets)[iterator->index++];
+            }
+            else if(iterator->in_old_buckets){
+                iterator->in_old_buckets = false;
+                iterator->index = 0;
+            }
+            else{
+                return false;
+            }
+        }
+        if(key)
+            *key = iterator->node->key;
+        if(value)
+            *value = iterator->node->value;
+        iterator->node = iterator->node->next;
+        return true;
+    }
+    if(slot < 0)
+        return false;
+    if(key)
+        *key = map->slots[slot].key;
+    if(value)
+        *value = map->slots[slot].value;
+    iterator->index = slot + 1;
+    return true;
+}
+
 void hash_map_clean(t_hash_map* self){
     internal_hash_map_clean_and_destroy_elements(self,NULL);
 }
@@ -111,26 +254,143 @@ void hash_map_clean_and_destroy_elements(t_hash_map* self, void(*element_destroy
     internal_hash_map_clean_and_destroy_elements(self,element_destroyer);
 }
 
+// the only place the user hash runs: every backend gets the key already hashed and spread,
+// and caches it in the node/slot so resizing and mismatches never hash again
+unsigned long hash_map_hash_key(t_hash_map *map, char *key, size_t length)
+{
+    unsigned long hash = map->hash_function_n ? map->hash_function_n(key, length) : map->hash_function(key);
+    return spread_hash(hash);
+}
+
+void hash_map_put_hashed(t_hash_map *self, char *key, size_t length, unsigned long hash, void *data)
+{
+    if (needs_key_compaction(self))
+        compact_keys(self);
+
+    switch (self->type) {
+    case HASH_MAP_OPEN_ADDRESSING:
+        open_addressing_put(self, key, length, hash, data);
+        return;
+    case HASH_MAP_SWISS_TABLE:
+        swiss_table_put(self, key, length, hash, data);
+        return;
+    default:
+        put_element(self, key, length, hash, data);
+    }
+}
+
+void* hash_map_get_hashed(t_hash_map* self, char* key, size_t length, unsigned long hash){
+    switch(self->type){
+    case HASH_MAP_OPEN_ADDRESSING:
+        return open_addressing_get(self,key,length,hash);
+    case HASH_MAP_SWISS_TABLE:
+        return swiss_table_get(self,key,length,hash);
+    default:
+        break;
+    }
+    if(is_rehashing(self)) rehash_step(self,REHASH_BUCKETS_PER_OPERATION);
+    t_hash_node* node = find_node(self,key,length,hash,NULL,NULL);
+    return node ? node->value : NULL;
+}
+
+// first pass of a batch: hash every key of the window and prefetch where it lives, so the
+// cache misses of the whole window overlap instead of being paid one lookup at a time
+static void hash_window(t_hash_map *map, char **keys, int count, size_t *lengths, unsigned long *hashes)
+{
+    for (int i = 0; i < count; i++) {
+        lengths[i] = strlen(keys[i]);
+        hashes[i] = hash_map_hash_key(map, keys[i], lengths[i]);
+        prefetch_hash(map, hashes[i]);
+    }
+
+    if (map->type != HASH_MAP_CHAINING)
+        return;
+    // chains need a second hop: the bucket heads are (hopefully) in cache by now
+    for (int i = 0; i < count; i++)
+        __builtin_prefetch(map->buckets[hashes[i] & (map->capacity - 1)]);
+}
+
+static void prefetch_hash(t_hash_map *map, unsigned long hash)
+{
+    switch (map->type) {
+    case HASH_MAP_OPEN_ADDRESSING:
+        open_addressing_prefetch(map, hash);
+        return;
+    case HASH_MAP_SWISS_TABLE:
+        swiss_table_prefetch(map, hash);
+        return;
+    default:
+        break;
+    }
+    if (is_rehashing(map))
+        __builtin_prefetch(&map->old_buckets[hash & (map->old_capacity - 1)]);
+    __builtin_prefetch(&map->buckets[hash & (map->capacity - 1)]);
+}
 
 static double calc_load_factor(t_hash_map *map)
 {
     return (double)map->size / (double)map->capacity;
 }
 
-static t_hash_node *find_node(t_hash_map *map, char *key, unsigned long *out_hash, int *out_index, t_hash_node **out_prev)
+static void put_element(t_hash_map *map, char *key, size_t length, unsigned long hash, void *data)
+{
+    if (is_rehashing(map))
+        rehash_step(map, REHASH_BUCKETS_PER_OPERATION);
+
+    t_hash_node **bucket;
+
+    t_hash_node *existing_node = find_node(map, key, length, hash, &bucket,NULL);
+
+    if (existing_node)
+    {
+        existing_node->value = data;
+        return;
+    }
+
+    // Key not found, create new node (always in the newest table)
+    t_hash_node *new = create_node(map, key, length, data, hash);
+    new->next = *bucket;
+    *bucket = new;
+
+    increment_map_size(map);
+
+    // Resize if necessary
+    if (map->load_factor > DEFAULT_LOAD_FACTOR) {
+        if (map->incremental_rehash) {
+            finish_rehash(map);
+            start_incremental_resize(map, map->capacity * DEFAULT_CAPACITY_MULTIPLIER);
+        }
+        else {
+            resize(map, map->capacity * DEFAULT_CAPACITY_MULTIPLIER);
+        }
+        map->load_factor = calc_load_factor(map);
+    }
+}
+
+// out_bucket gets the head of the chain holding the node, or the bucket a new node should go to
+static t_hash_node *find_node(t_hash_map *map, char *key, size_t length, unsigned long hash, t_hash_node ***out_bucket, t_hash_node **out_prev)
 {
-    unsigned long hash = map->hash_function(key);
-    int index = hash % map->capacity;
+    if (is_rehashing(map)) {
+        t_hash_node **old_bucket = &map->old_buckets[hash & (map->old_capacity - 1)];
+        t_hash_node *node = find_in_bucket(*old_bucket, key, length, hash, out_prev);
+        if (node) {
+            if (out_bucket) *out_bucket = old_bucket;
+            return node;
+        }
+    }
 
-    if (out_hash) *out_hash = hash;
-    if (out_index) *out_index = index;
+    t_hash_node **bucket = &map->buckets[hash & (map->capacity - 1)];
+    if (out_bucket) *out_bucket = bucket;
+    return find_in_bucket(*bucket, key, length, hash, out_prev);
+}
 
-    t_hash_node *node = map->buckets[index];
+static t_hash_node *find_in_bucket(t_hash_node *node, char *key, size_t length, unsigned long hash, t_hash_node **out_prev)
+{
     t_hash_node *prev = NULL;
 
     while (node)
     {
-        if (node->hash == hash && strcmp(node->key, key) == 0) {
+        if (node->hash == hash && hash_map_key_equals(node->key, node->key_length, key, length)) {
             if (out_prev) *out_prev = prev;
             return node;
         }
@@ -148,73 +408,143 @@ static void resize(t_hash_map *map, int new_capacity)
     t_hash_node** old_buckets = map->buckets;
 
     for (int i = 0; i < map->capacity; i++) {
-        t_hash_node* old = old_buckets[i];
-        t_hash_node* next;
+        move_chain(old_buckets[i], new_buckets, new_capacity);
+    }
 
-        while (old) {
-            next = old->next; 
-            int new_index = old->hash % new_capacity;
+    map->buckets = new_buckets;
+    map->capacity = new_capacity;
+    free(old_buckets);
+}
 
-            old->next = new_buckets[new_index]; 
-            new_buckets[new_index] = old;
+static void move_chain(t_hash_node *node, t_hash_node **buckets, int capacity)
+{
+    t_hash_node* next;
 
-            old = next;
-        }
+    while (node) {
+        next = node->next;
+        int new_index = node->hash & (capacity - 1);
+
+        node->next = buckets[new_index];
+        buckets[new_index] = node;
+
+        node = next;
     }
+}
 
+static bool is_rehashing(t_hash_map *map)
+{
+    return map->old_buckets != NULL;
+}
+
+static void start_incremental_resize(t_hash_map *map, int new_capacity)
+{
+    t_hash_node** new_buckets = calloc(new_capacity, sizeof(t_hash_node*));
+    if (!new_buckets) {
+        fprintf(stderr, "Not enough memory for resizing hash map %p", (void *)map);
+        return;
+    }
+
+    map->old_buckets = map->buckets;
+    map->old_capacity = map->capacity;
+    map->rehash_index = 0;
     map->buckets = new_buckets;
     map->capacity = new_capacity;
-    free(old_buckets);
 }
 
+// moves up to bucket_count chains, giving up after ten empty buckets per chain so a sparse
+// old table can't turn a single operation into a full scan
+static void rehash_step(t_hash_map *map, int bucket_count)
+{
+    int empty_visits = bucket_count * 10;
 
-static void* remove_element(t_hash_map* map, char* key){
-    int bucket_index;
-    t_hash_node* prev = NULL;
-    t_hash_node* to_delete = find_node(map,key,NULL,&bucket_index,&prev);
-    if(!to_delete) return NULL;
+    while (bucket_count > 0 && map->rehash_index < map->old_capacity) {
+        t_hash_node *chain = map->old_buckets[map->rehash_index];
+        map->old_buckets[map->rehash_index] = NULL;
+        map->rehash_index++;
 
-    
-    void* data = to_delete->value;
+        if (chain) {
+            move_chain(chain, map->buckets, map->capacity);
+            bucket_count--;
+        }
+        else if (--empty_visits == 0) {
+            break;
+        }
+    }
 
-    if (!prev) {
-        map->buckets[bucket_index] = to_delete->next;
+    if (map->rehash_index >= map->old_capacity) {
+        free(map->old_buckets);
+        map->old_buckets = NULL;
+        map->old_capacity = 0;
+        map->rehash_index = 0;
     }
-    else {
-        prev->next = to_delete->next; 
+}
+
+static void finish_rehash(t_hash_map *map)
+{
+    while (is_rehashing(map))
+        rehash_step(map, map->old_capacity);
+}
+
+static bool internal_hash_map_remove(t_hash_map* self, char* key, size_t length, void** out_value){
+    return hash_map_remove_hashed(self,key,length,hash_map_hash_key(self,key,length),out_value);
+}
+
+bool hash_map_remove_hashed(t_hash_map* self, char* key, size_t length, unsigned long hash, void** out_value){
+    switch(self->type){
+    case HASH_MAP_OPEN_ADDRESSING:
+        return open_addressing_remove(self,key,length,hash,out_value);
+    case HASH_MAP_SWISS_TABLE:
+        return swiss_table_remove(self,key,length,hash,out_value);
+    default:
+        return remove_element(self,key,length,hash,out_value);
     }
-    
-    decrement_map_size(map);
-    destroy_node(to_delete,NULL);
-    return data;
 }
 
-static void remove_and_destroy_element(t_hash_map* map, char* key,  void(*element_destroyer)(void*)){
-    int bucket_index;
+static bool remove_element(t_hash_map* map, char* key, size_t length, unsigned long hash, void** out_value){
+    t_hash_node** bucket;
     t_hash_node* prev = NULL;
-    t_hash_node* to_delete = find_node(map,key,NULL,&bucket_index,&prev);
+    if(is_rehashing(map)) rehash_step(map,REHASH_BUCKETS_PER_OPERATION);
+    t_hash_node* to_delete = find_node(map,key,length,hash,&bucket,&prev);
+    if(!to_delete) return false;
 
-    if(!to_delete) return;
+    if(out_value) *out_value = to_delete->value;
 
     if (!prev) {
-        map->buckets[bucket_index] = to_delete->next;
+        *bucket = to_delete->next;
     }
     else {
-        prev->next = to_delete->next; 
+        prev->next = to_delete->next;
     }
-    
-    decrement_map_size(map);
-    destroy_node(to_delete,element_destroyer);
 
+    decrement_map_size(map);
+    destroy_node(map,to_delete,NULL);
+    return true;
 }
 
 static void internal_hash_map_clean_and_destroy_elements(t_hash_map* self,void(*element_destroyer)(void*)){
+    switch(self->type){
+    case HASH_MAP_OPEN_ADDRESSING:
+        open_addressing_clean(self,element_destroyer);
+        break;
+    case HASH_MAP_SWISS_TABLE:
+        swiss_table_clean(self,element_destroyer);
+        break;
+    default:
+        clean_buckets(self,element_destroyer);
+    }
+    // every key is gone, the arena can start over from a single chunk
+    if(self->key_arena) key_arena_reset(self->key_arena);
+}
+
+static void clean_buckets(t_hash_map* self, void(*element_destroyer)(void*)){
+    // a running rehash has nothing left to move once the map is empty
+    finish_rehash(self);
     for(int i =0; i< self->capacity; i++){
         t_hash_node* node = self->buckets[i];
         t_hash_node* next = NULL;
         while(node){
             next = node->next;
-            destroy_node(node,element_destroyer);
+            destroy_node(self,node,element_destroyer);
             node = next;
         }
         self->buckets[i] = NULL;
@@ -223,39 +553,120 @@ static void internal_hash_map_clean_and_destroy_elements(t_hash_map* self,void(*
     self->load_factor = 0;
 }
 
-static unsigned long hash_djb2(const char *str)
-{
-    unsigned long hash = 5381;
-    int c;
-
-    while ((c = *str++))
-    {
-        hash = ((hash << 5) + hash) + c; // hash * 33 + c
-    }
-
-    return hash;
-}
-
-static t_hash_node *create_node(char *key, void *data, unsigned long hash)
+static t_hash_node *create_node(t_hash_map *map, char *key, size_t length, void *data, unsigned long hash)
 {
     t_hash_node *node = malloc(sizeof(t_hash_node));
     if (!node)
         return NULL;
 
-    node->key = strdup(key);
+    node->key = hash_map_store_key(map, key, length);
+    node->key_length = length;
     node->value = data;
     node->next = NULL;
     node->hash = !key ? 0l : hash;
     return node;
 }
 
-static void destroy_node(t_hash_node *node, void(*element_destroyer)(void*))
+static void destroy_node(t_hash_map *map, t_hash_node *node, void(*element_destroyer)(void*))
 {
     if(element_destroyer) element_destroyer(node->value);
-    free(node->key);
+    hash_map_release_key(map, node->key, node->key_length);
     free(node);
 }
 
+// copied keys always get a terminator, so iterators can treat them as strings
+char *hash_map_store_key(t_hash_map *map, char *key, size_t length)
+{
+    switch (map->key_storage) {
+    case HASH_MAP_KEYS_ARENA:
+        return key_arena_copy(map->key_arena, key, length);
+    case HASH_MAP_KEYS_BORROWED:
+        return key;
+    default:
+        break;
+    }
+
+    char *copy = malloc(length + 1);
+    if (!copy)
+        return NULL;
+    memcpy(copy, key, length);
+    copy[length] = '\0';
+    return copy;
+}
+
+void hash_map_release_key(t_hash_map *map, char *key, size_t length)
+{
+    switch (map->key_storage) {
+    case HASH_MAP_KEYS_ARENA:
+        key_arena_release(map->key_arena, length);
+        break;
+    case HASH_MAP_KEYS_BORROWED:
+        break;
+    default:
+        free(key);
+    }
+}
+
+// removed keys stay in the arena until it is rebuilt, do it once they outweigh the live ones
+static bool needs_key_compaction(t_hash_map *map)
+{
+    return map->key_arena
+        && map->key_arena->wasted_bytes > KEY_ARENA_CHUNK_SIZE
+        && map->key_arena->wasted_bytes > map->key_arena->live_bytes;
+}
+
+// every key is copied before any entry is pointed at its copy: when the new arena runs out of
+// memory halfway, it is dropped and the map goes on with the old one, to compact another time
+static void compact_keys(t_hash_map *map)
+{
+    t_key_arena *compacted = key_arena_create();
+    char **copies = malloc((map->size + 1) * sizeof(char *));
+    if (!compacted || !copies || !relocate_keys(map, compacted, copies, false)) {
+        if (compacted)
+            key_arena_destroy(compacted);
+        free(copies);
+        return;
+    }
+    relocate_keys(map, compacted, copies, true);
+    free(copies);
+
+    key_arena_destroy(map->key_arena);
+    map->key_arena = compacted;
+}
+
+// visits the key of every entry in a fixed order, chains first, then slots
+static bool relocate_keys(t_hash_map *map, t_key_arena *arena, char **copies, bool commit)
+{
+    int count = 0;
+    t_hash_node **tables[] = {map->old_buckets, map->buckets};
+    int capacities[] = {map->old_capacity, map->capacity};
+    for (int table = 0; table < 2; table++) {
+        for (int i = 0; tables[table] && i < capacities[table]; i++) {
+            for (t_hash_node *node = tables[table][i]; node; node = node->next) {
+                if (!relocate_key(&node->key, node->key_length, arena, copies, count++, commit))
+                    return false;
+            }
+        }
+    }
+
+    // empty open addressing and swiss slots always have a NULL key
+    for (int i = 0; map->slots && i < map->capacity; i++) {
+        if (map->slots[i].key && !relocate_key(&map->slots[i].key, map->slots[i].key_length, arena, copies, count++, commit))
+            return false;
+    }
+    return true;
+}
+
+// copies the key into arena, or once every copy exists, points the entry at its copy
+static bool relocate_key(char **key, size_t length, t_key_arena *arena, char **copies, int index, bool commit)
+{
+    if (commit)
+        *key = copies[index];
+    else
+        copies[index] = key_arena_copy(arena, *key, length);
+    return copies[index] != NULL;
+}
+
 static void increment_map_size(t_hash_map* self){
     self->size++;
     self->load_factor = calc_load_factor(self);
@@ -265,4 +676,3 @@ static void decrement_map_size(t_hash_map* self){
     self->size--;
     self->load_factor = calc_load_factor(self);
 }
-
@@ -4,20 +4,73 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <stdbool.h>
 #include "../node.h"
+#include "key_arena.h"
+#include "hash_functions.h"
 
-#define MAP_INITIAL_CAPACITY 10
+// every table keeps a power of two capacity so the index is hash & (capacity - 1)
+#define MAP_INITIAL_CAPACITY 16
 #define DEFAULT_LOAD_FACTOR 0.7
 #define DEFAULT_CAPACITY_MULTIPLIER 2
 
-typedef  unsigned long (*t_hash_function)(const char*);
+// non empty buckets moved from the old to the new table by every put/get/remove while an incremental rehash is running
+#define REHASH_BUCKETS_PER_OPERATION 2
+
+// batches are resolved in windows of this many keys, all hashed and prefetched before the first lookup
+#define HASH_MAP_BATCH_WINDOW 16
+
+#define OPEN_ADDRESSING_INITIAL_CAPACITY 16
+#define OPEN_ADDRESSING_LOAD_FACTOR 0.85
+
+typedef enum{
+    // one malloc'd node per entry, linked in per bucket chains
+    HASH_MAP_CHAINING = 0,
+    // flat slot array with robin hood linear probing, no per entry node
+    HASH_MAP_OPEN_ADDRESSING,
+    // flat slot array plus one control byte (7 bit tag) per slot, probed 16 tags at a time
+    HASH_MAP_SWISS_TABLE
+} t_hash_map_type;
+
+typedef enum{
+    // every key is strdup'd and freed with its entry
+    HASH_MAP_KEYS_COPY = 0,
+    // keys are copied into a bump allocated arena owned by the map, reclaimed on clean
+    // or by compacting once most of the arena belongs to removed keys
+    HASH_MAP_KEYS_ARENA,
+    // the caller's pointer is stored as is, the key must outlive its entry and never change
+    HASH_MAP_KEYS_BORROWED
+} t_hash_map_key_storage;
+
+// zero initialized options give the default map (chaining + djb2 + copied keys)
+typedef struct{
+    t_hash_map_type type;
+    // used only when hash_function_n is NULL, built-ins (hash_djb2, hash_wy...) get their length aware twin
+    t_hash_function hash_function;
+    t_hash_function_n hash_function_n;
+    // chaining only: grow by migrating a few buckets per operation instead of all at once
+    bool incremental_rehash;
+    t_hash_map_key_storage key_storage;
+} t_hash_map_options;
 
 typedef struct{
     int size;
     int capacity;
     double load_factor;
+    t_hash_map_type type;
     t_hash_function hash_function;
+    t_hash_function_n hash_function_n;
+    t_hash_map_key_storage key_storage;
+    t_key_arena* key_arena;
     t_hash_node** buckets;
+    // incremental rehash: buckets below rehash_index were already moved, old_buckets is NULL when idle
+    bool incremental_rehash;
+    t_hash_node** old_buckets;
+    int old_capacity;
+    int rehash_index;
+    t_hash_slot* slots;
+    signed char* control_bytes;
+    int growth_left;
 } t_hash_map;
 
 
@@ -25,6 +78,8 @@ t_hash_map* hash_map_create(void);
 
 t_hash_map* hash_map_create_with_hash_function(t_hash_function hash_function);
 
+t_hash_map* hash_map_create_with_options(t_hash_map_options options);
+
 void hash_map_destroy(t_hash_map *self);
 
 void hash_map_destroy_and_destroy_elements(t_hash_map *self, void(*element_destroyer)(void*));
@@ -39,8 +94,42 @@ void* hash_map_get(t_hash_map* self, char* key);
 
 void* hash_map_remove(t_hash_map* self, char* key);
 
+// _n variants take the key length, so the key needs no terminator as long as the map
+// hashes with a t_hash_function_n (the default does)
+
+void hash_map_put_n(t_hash_map *self, char *key, size_t length, void *data);
+
+void* hash_map_get_n(t_hash_map* self, char* key, size_t length);
+
+void* hash_map_remove_n(t_hash_map* self, char* key, size_t length);
+
+// same as calling put/get once per key, but the bucket or slot of every key in a window is
+// prefetched before any of them is touched. out_values[i] is NULL for missing keys
+
+void hash_map_put_batch(t_hash_map *self, char **keys, int count, void **values);
+
+void hash_map_get_batch(t_hash_map* self, char** keys, int count, void** out_values);
+
 void hash_map_iterate(t_hash_map* map, void(*iterator)(char*,void*));
 
+// external iteration, for when a callback per entry does not fit. Same order as
+// hash_map_iterate, any put or remove on the map invalidates the iterator. With
+// incremental_rehash, lookups (hash_map_get and the calls built on it) move buckets
+// while a resize is in progress, so they invalidate it as well
+typedef struct{
+    t_hash_map* map;
+    // bucket or slot the next entry is searched from
+    int index;
+    // chaining mid rehash: old_buckets are walked before buckets
+    bool in_old_buckets;
+    t_hash_node* node;
+} t_hash_map_iterator;
+
+void hash_map_iterator_init(t_hash_map_iterator* iterator, t_hash_map* map);
+
+// false once every entry was returned. key or value may be NULL when not needed
+bool hash_map_iterator_next(t_hash_map_iterator* iterator, char** key, void** value);
+
 void hash_map_remove_and_destroy_element(t_hash_map* self, char* key, void(*element_destroyer)(void*));
 
 int hash_map_size(t_hash_map* self);
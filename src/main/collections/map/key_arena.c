@@ -0,0 +1,71 @@
+#include "key_arena.h"
+
+static t_key_arena_chunk* create_chunk(size_t capacity, t_key_arena_chunk* next);
+static void destroy_chunks(t_key_arena_chunk* chunk);
+
+t_key_arena* key_arena_create(void){
+    t_key_arena* arena = malloc(sizeof(t_key_arena));
+    if(!arena) return NULL;
+    arena->chunks = NULL;
+    arena->live_bytes = 0;
+    arena->wasted_bytes = 0;
+    return arena;
+}
+
+// length excludes the terminator, the copy is always null terminated
+char* key_arena_copy(t_key_arena* arena, const char* key, size_t length){
+    size_t needed = length + 1;
+    t_key_arena_chunk* chunk = arena->chunks;
+
+    if(!chunk || chunk->capacity - chunk->used < needed){
+        size_t capacity = needed > KEY_ARENA_CHUNK_SIZE ? needed : KEY_ARENA_CHUNK_SIZE;
+        chunk = create_chunk(capacity, arena->chunks);
+        if(!chunk) return NULL;
+        arena->chunks = chunk;
+    }
+
+    char* copy = &chunk->data[chunk->used];
+    memcpy(copy, key, length);
+    copy[length] = '\0';
+    chunk->used += needed;
+    arena->live_bytes += needed;
+    return copy;
+}
+
+void key_arena_release(t_key_arena* arena, size_t length){
+    arena->live_bytes -= length + 1;
+    arena->wasted_bytes += length + 1;
+}
+
+// keeps the newest chunk around so a cleaned map refills without allocating
+void key_arena_reset(t_key_arena* arena){
+    if(arena->chunks){
+        destroy_chunks(arena->chunks->next);
+        arena->chunks->next = NULL;
+        arena->chunks->used = 0;
+    }
+    arena->live_bytes = 0;
+    arena->wasted_bytes = 0;
+}
+
+void key_arena_destroy(t_key_arena* arena){
+    destroy_chunks(arena->chunks);
+    free(arena);
+}
+
+static t_key_arena_chunk* create_chunk(size_t capacity, t_key_arena_chunk* next){
+    t_key_arena_chunk* chunk = malloc(sizeof(t_key_arena_chunk) + capacity);
+    if(!chunk) return NULL;
+    chunk->next = next;
+    chunk->used = 0;
+    chunk->capacity = capacity;
+    return chunk;
+}
+
+static void destroy_chunks(t_key_arena_chunk* chunk){
+    while(chunk){
+        t_key_arena_chunk* next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+}
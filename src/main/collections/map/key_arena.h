@@ -0,0 +1,35 @@
+#ifndef KEY_ARENA_H_INCLUDED
+#define KEY_ARENA_H_INCLUDED
+
+#include <stdlib.h>
+#include <string.h>
+
+// bytes per chunk, longer keys get a chunk of their own
+#define KEY_ARENA_CHUNK_SIZE 65536
+
+typedef struct key_arena_chunk{
+    struct key_arena_chunk* next;
+    size_t used;
+    size_t capacity;
+    char data[];
+} t_key_arena_chunk;
+
+// Bump allocator for strings: copies are never freed one by one, only counted as wasted
+// until the whole arena is reset or destroyed
+typedef struct{
+    t_key_arena_chunk* chunks;
+    size_t live_bytes;
+    size_t wasted_bytes;
+} t_key_arena;
+
+t_key_arena* key_arena_create(void);
+
+char* key_arena_copy(t_key_arena* arena, const char* key, size_t length);
+
+void key_arena_release(t_key_arena* arena, size_t length);
+
+void key_arena_reset(t_key_arena* arena);
+
+void key_arena_destroy(t_key_arena* arena);
+
+#endif
@@ -0,0 +1,204 @@
+
+#include "open_addressing.h"
+#include "hash_map_keys.h"
+
+static t_hash_slot *find_slot(t_hash_map *map, char *key, size_t length, unsigned long hash);
+static void insert_slot(t_hash_slot *slots, unsigned long mask, t_hash_slot entry);
+static void delete_slot(t_hash_map *map, t_hash_slot *slot);
+static unsigned long probe_distance(unsigned long hash, unsigned long index, unsigned long mask);
+static bool needs_resizing(t_hash_map *map);
+static void resize(t_hash_map *map, int new_capacity);
+static void update_load_factor(t_hash_map *map);
+
+bool open_addressing_init(t_hash_map *map)
+{
+    map->capacity = OPEN_ADDRESSING_INITIAL_CAPACITY;
+    map->slots = calloc(map->capacity, sizeof(t_hash_slot));
+    return map->slots != NULL;
+}
+
+void open_addressing_put(t_hash_map *map, char *key, size_t length, unsigned long hash, void *data)
+{
+    t_hash_slot *existing = find_slot(map, key, length, hash);
+
+    if (existing)
+    {
+        existing->value = data;
+        return;
+    }
+
+    // grow before inserting so the probe never runs on a full table
+    if (needs_resizing(map))
+        resize(map, map->capacity * DEFAULT_CAPACITY_MULTIPLIER);
+
+    t_hash_slot entry = {.hash = hash, .key = hash_map_store_key(map, key, length), .value = data, .key_length = length};
+    insert_slot(map->slots, map->capacity - 1, entry);
+    map->size++;
+    update_load_factor(map);
+}
+
+void *open_addressing_get(t_hash_map *map, char *key, size_t length, unsigned long hash)
+{
+    t_hash_slot *slot = find_slot(map, key, length, hash);
+    return slot ? slot->value : NULL;
+}
+
+bool open_addressing_remove(t_hash_map *map, char *key, size_t length, unsigned long hash, void **out_value)
+{
+    t_hash_slot *slot = find_slot(map, key, length, hash);
+    if (!slot)
+        return false;
+
+    if (out_value)
+        *out_value = slot->value;
+    hash_map_release_key(map, slot->key, slot->key_length);
+    delete_slot(map, slot);
+    map->size--;
+    update_load_factor(map);
+    return true;
+}
+
+void open_addressing_prefetch(t_hash_map *map, unsigned long hash)
+{
+    __builtin_prefetch(&map->slots[hash & (map->capacity - 1)]);
+}
+
+void open_addressing_iterate(t_hash_map *map, void (*iterator)(char *, void *))
+{
+    for (int i = 0; i < map->capacity; i++)
+    {
+        if (map->slots[i].key)
+            iterator(map->slots[i].key, map->slots[i].value);
+    }
+}
+
+int open_addressing_next_slot(t_hash_map *map, int index)
+{
+    for (; index < map->capacity; index++)
+    {
+        if (map->slots[index].key)
+            return index;
+    }
+    return -1;
+}
+
+void open_addressing_clean(t_hash_map *map, void (*element_destroyer)(void *))
+{
+    for (int i = 0; i < map->capacity; i++)
+    {
+        t_hash_slot *slot = &map->slots[i];
+        if (!slot->key)
+            continue;
+        if (element_destroyer)
+            element_destroyer(slot->value);
+        hash_map_release_key(map, slot->key, slot->key_length);
+        slot->key = NULL;
+        slot->value = NULL;
+    }
+    map->size = 0;
+    map->load_factor = 0;
+}
+
+void open_addressing_destroy(t_hash_map *map)
+{
+    free(map->slots);
+    map->slots = NULL;
+}
+
+static unsigned long probe_distance(unsigned long hash, unsigned long index, unsigned long mask)
+{
+    return (index - (hash & mask)) & mask;
+}
+
+static t_hash_slot *find_slot(t_hash_map *map, char *key, size_t length, unsigned long hash)
+{
+    unsigned long mask = map->capacity - 1;
+    unsigned long index = hash & mask;
+    unsigned long distance = 0;
+
+    while (map->slots[index].key)
+    {
+        t_hash_slot *slot = &map->slots[index];
+
+        // robin hood invariant: a richer slot means the key would have been placed before it
+        if (probe_distance(slot->hash, index, mask) < distance)
+            return NULL;
+
+        if (slot->hash == hash && hash_map_key_equals(slot->key, slot->key_length, key, length))
+            return slot;
+
+        index = (index + 1) & mask;
+        distance++;
+    }
+    return NULL;
+}
+
+static void insert_slot(t_hash_slot *slots, unsigned long mask, t_hash_slot entry)
+{
+    unsigned long index = entry.hash & mask;
+    unsigned long distance = 0;
+
+    while (slots[index].key)
+    {
+        unsigned long existing_distance = probe_distance(slots[index].hash, index, mask);
+        if (existing_distance < distance)
+        {
+            // take from the rich: the entry further from home keeps the slot
+            t_hash_slot displaced = slots[index];
+            slots[index] = entry;
+            entry = displaced;
+            distance = existing_distance;
+        }
+        index = (index + 1) & mask;
+        distance++;
+    }
+    slots[index] = entry;
+}
+
+static void delete_slot(t_hash_map *map, t_hash_slot *slot)
+{
+    // backward shift deletion, no tombstones needed
+    unsigned long mask = map->capacity - 1;
+    unsigned long hole = slot - map->slots;
+    unsigned long next = (hole + 1) & mask;
+
+    while (map->slots[next].key && probe_distance(map->slots[next].hash, next, mask) > 0)
+    {
+        map->slots[hole] = map->slots[next];
+        hole = next;
+        next = (next + 1) & mask;
+    }
+    map->slots[hole].key = NULL;
+    map->slots[hole].value = NULL;
+}
+
+static bool needs_resizing(t_hash_map *map)
+{
+    return (double)(map->size + 1) / (double)map->capacity > OPEN_ADDRESSING_LOAD_FACTOR;
+}
+
+static void resize(t_hash_map *map, int new_capacity)
+{
+    t_hash_slot *new_slots = calloc(new_capacity, sizeof(t_hash_slot));
+    if (!new_slots)
+    {
+        fprintf(stderr, "Not enough memory for resizing hash map %p", (void *)map);
+        return;
+    }
+
+    for (int i = 0; i < map->capacity; i++)
+    {
+        if (map->slots[i].key)
+            insert_slot(new_slots, new_capacity - 1, map->slots[i]);
+    }
+
+    free(map->slots);
+    map->slots = new_slots;
+    map->capacity = new_capacity;
+    update_load_factor(map);
+}
+
+static void update_load_factor(t_hash_map *map)
+{
+    map->load_factor = (double)map->size / (double)map->capacity;
+}
@@ -0,0 +1,30 @@
+#ifndef OPEN_ADDRESSING_H_INCLUDED
+#define OPEN_ADDRESSING_H_INCLUDED
+
+#include <stdbool.h>
+#include "hashmap.h"
+
+// Robin hood open addressing backend of t_hash_map, only meant to be called from hashmap.c
+// Keys arrive already hashed and spread by the dispatcher
+
+bool open_addressing_init(t_hash_map *map);
+
+void open_addressing_put(t_hash_map *map, char *key, size_t length, unsigned long hash, void *data);
+
+void *open_addressing_get(t_hash_map *map, char *key, size_t length, unsigned long hash);
+
+bool open_addressing_remove(t_hash_map *map, char *key, size_t length, unsigned long hash, void **out_value);
+
+// hint only: touches nothing but the cache lines the lookup of hash will start from
+void open_addressing_prefetch(t_hash_map *map, unsigned long hash);
+
+void open_addressing_iterate(t_hash_map *map, void (*iterator)(char *, void *));
+
+// first occupied slot from index on, -1 when there is none
+int open_addressing_next_slot(t_hash_map *map, int index);
+
+void open_addressing_clean(t_hash_map *map, void (*element_destroyer)(void *));
+
+void open_addressing_destroy(t_hash_map *map);
+
+#endif
@@ -0,0 +1,300 @@
+
+#include "swiss_table.h"
+#include "hash_map_keys.h"
+
+#if defined(__SSE2__) && !defined(HASH_MAP_NO_SIMD)
+#include <emmintrin.h>
+#define SWISS_TABLE_SSE2
+#endif
+
+// control byte states: a full slot holds its 7 bit tag (0..127), the others have the high bit set
+#define CTRL_EMPTY ((signed char)-128)
+#define CTRL_DELETED ((signed char)-2)
+
+// slots are probed in aligned groups of 16 control bytes, one SSE2 register
+#define GROUP_WIDTH 16
+
+// bit i is set when control byte i of the group matches
+typedef unsigned int t_group_mask;
+
+static t_group_mask match_tag(const signed char *group, signed char tag);
+static t_group_mask match_empty_or_deleted(const signed char *group);
+static signed char hash_tag(unsigned long hash);
+static t_hash_slot *find_slot(t_hash_map *map, char *key, size_t length, unsigned long hash, unsigned long *out_index);
+static unsigned long find_insert_index(t_hash_map *map, unsigned long hash);
+static bool allocate_table(t_hash_map *map, int capacity);
+static void rehash(t_hash_map *map, int new_capacity);
+static int max_size(int capacity);
+static void update_load_factor(t_hash_map *map);
+
+bool swiss_table_init(t_hash_map *map)
+{
+    return allocate_table(map, OPEN_ADDRESSING_INITIAL_CAPACITY);
+}
+
+void swiss_table_put(t_hash_map *map, char *key, size_t length, unsigned long hash, void *data)
+{
+    t_hash_slot *existing = find_slot(map, key, length, hash, NULL);
+
+    if (existing)
+    {
+        existing->value = data;
+        return;
+    }
+
+    if (map->growth_left <= 0)
+    {
+        // mostly tombstones: rehashing in place is enough to reclaim them
+        bool is_crowded = map->size + 1 > max_size(map->capacity) / 2;
+        rehash(map, is_crowded ? map->capacity * DEFAULT_CAPACITY_MULTIPLIER : map->capacity);
+    }
+
+    unsigned long index = find_insert_index(map, hash);
+    if (map->control_bytes[index] == CTRL_EMPTY)
+        map->growth_left--;
+
+    map->control_bytes[index] = hash_tag(hash);
+    map->slots[index] = (t_hash_slot){.hash = hash, .key = hash_map_store_key(map, key, length), .value = data, .key_length = length};
+    map->size++;
+    update_load_factor(map);
+}
+
+void *swiss_table_get(t_hash_map *map, char *key, size_t length, unsigned long hash)
+{
+    t_hash_slot *slot = find_slot(map, key, length, hash, NULL);
+    return slot ? slot->value : NULL;
+}
+
+bool swiss_table_remove(t_hash_map *map, char *key, size_t length, unsigned long hash, void **out_value)
+{
+    unsigned long index;
+    t_hash_slot *slot = find_slot(map, key, length, hash, &index);
+    if (!slot)
+        return false;
+
+    if (out_value)
+        *out_value = slot->value;
+    hash_map_release_key(map, slot->key, slot->key_length);
+    slot->key = NULL;
+    slot->value = NULL;
+
+    // a group with an empty byte already stops every probe, so no tombstone is needed
+    const signed char *group = &map->control_bytes[index - index % GROUP_WIDTH];
+    if (match_tag(group, CTRL_EMPTY))
+    {
+        map->control_bytes[index] = CTRL_EMPTY;
+        map->growth_left++;
+    }
+    else
+    {
+        map->control_bytes[index] = CTRL_DELETED;
+    }
+
+    map->size--;
+    update_load_factor(map);
+    return true;
+}
+
+void swiss_table_prefetch(t_hash_map *map, unsigned long hash)
+{
+    unsigned long group = hash & (map->capacity / GROUP_WIDTH - 1);
+    __builtin_prefetch(&map->control_bytes[group * GROUP_WIDTH]);
+    // the first tag match usually lands in the group's first slots
+    __builtin_prefetch(&map->slots[group * GROUP_WIDTH]);
+}
+
+void swiss_table_iterate(t_hash_map *map, void (*iterator)(char *, void *))
+{
+    for (int i = 0; i < map->capacity; i++)
+    {
+        if (map->control_bytes[i] >= 0)
+            iterator(map->slots[i].key, map->slots[i].value);
+    }
+}
+
+int swiss_table_next_slot(t_hash_map *map, int index)
+{
+    for (; index < map->capacity; index++)
+    {
+        if (map->control_bytes[index] >= 0)
+            return index;
+    }
+    return -1;
+}
+
+void swiss_table_clean(t_hash_map *map, void (*element_destroyer)(void *))
+{
+    for (int i = 0; i < map->capacity; i++)
+    {
+        if (map->control_bytes[i] < 0)
+            continue;
+        if (element_destroyer)
+            element_destroyer(map->slots[i].value);
+        hash_map_release_key(map, map->slots[i].key, map->slots[i].key_length);
+        map->slots[i].key = NULL;
+        map->slots[i].value = NULL;
+    }
+    memset(map->control_bytes, CTRL_EMPTY, map->capacity);
+    map->size = 0;
+    map->load_factor = 0;
+    map->growth_left = max_size(map->capacity);
+}
+
+void swiss_table_destroy(t_hash_map *map)
+{
+    free(map->control_bytes);
+    free(map->slots);
+    map->control_bytes = NULL;
+    map->slots = NULL;
+}
+
+#ifdef SWISS_TABLE_SSE2
+
+static t_group_mask match_tag(const signed char *group, signed char tag)
+{
+    __m128i ctrl = _mm_load_si128((const __m128i *)group);
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(tag), ctrl));
+}
+
+static t_group_mask match_empty_or_deleted(const signed char *group)
+{
+    // empty and deleted are the only states with the sign bit set
+    return _mm_movemask_epi8(_mm_load_si128((const __m128i *)group));
+}
+
+#else
+
+static t_group_mask match_tag(const signed char *group, signed char tag)
+{
+    t_group_mask mask = 0;
+    for (int i = 0; i < GROUP_WIDTH; i++)
+    {
+        if (group[i] == tag)
+            mask |= 1u << i;
+    }
+    return mask;
+}
+
+static t_group_mask match_empty_or_deleted(const signed char *group)
+{
+    t_group_mask mask = 0;
+    for (int i = 0; i < GROUP_WIDTH; i++)
+    {
+        if (group[i] < 0)
+            mask |= 1u << i;
+    }
+    return mask;
+}
+
+#endif
+
+static signed char hash_tag(unsigned long hash)
+{
+    // top 7 bits, the low bits already pick the group
+    return (signed char)(hash >> (sizeof(unsigned long) * 8 - 7));
+}
+
+// groups are visited with triangular steps (1, 2, 3...), which covers every group
+// when the group count is a power of two
+static t_hash_slot *find_slot(t_hash_map *map, char *key, size_t length, unsigned long hash, unsigned long *out_index)
+{
+    unsigned long groups_mask = map->capacity / GROUP_WIDTH - 1;
+    unsigned long group = hash & groups_mask;
+    signed char tag = hash_tag(hash);
+
+    for (unsigned long step = 1; step <= groups_mask + 1; step++)
+    {
+        const signed char *ctrl = &map->control_bytes[group * GROUP_WIDTH];
+        t_group_mask matches = match_tag(ctrl, tag);
+
+        while (matches)
+        {
+            unsigned long index = group * GROUP_WIDTH + __builtin_ctz(matches);
+            t_hash_slot *slot = &map->slots[index];
+            if (slot->hash == hash && hash_map_key_equals(slot->key, slot->key_length, key, length))
+            {
+                if (out_index)
+                    *out_index = index;
+                return slot;
+            }
+            matches &= matches - 1;
+        }
+
+        if (match_tag(ctrl, CTRL_EMPTY))
+            return NULL;
+
+        group = (group + step) & groups_mask;
+    }
+    return NULL;
+}
+
+static unsigned long find_insert_index(t_hash_map *map, unsigned long hash)
+{
+    unsigned long groups_mask = map->capacity / GROUP_WIDTH - 1;
+    unsigned long group = hash & groups_mask;
+
+    for (unsigned long step = 1;; step++)
+    {
+        t_group_mask available = match_empty_or_deleted(&map->control_bytes[group * GROUP_WIDTH]);
+        if (available)
+            return group * GROUP_WIDTH + __builtin_ctz(available);
+        group = (group + step) & groups_mask;
+    }
+}
+
+static bool allocate_table(t_hash_map *map, int capacity)
+{
+    // aligned so every group can be loaded with a single aligned SSE2 load
+    signed char *control_bytes = aligned_alloc(GROUP_WIDTH, capacity);
+    t_hash_slot *slots = calloc(capacity, sizeof(t_hash_slot));
+    if (!control_bytes || !slots)
+    {
+        free(control_bytes);
+        free(slots);
+        return false;
+    }
+
+    memset(control_bytes, CTRL_EMPTY, capacity);
+    map->control_bytes = control_bytes;
+    map->slots = slots;
+    map->capacity = capacity;
+    map->growth_left = max_size(capacity) - map->size;
+    return true;
+}
+
+static void rehash(t_hash_map *map, int new_capacity)
+{
+    signed char *old_control_bytes = map->control_bytes;
+    t_hash_slot *old_slots = map->slots;
+    int old_capacity = map->capacity;
+
+    if (!allocate_table(map, new_capacity))
+    {
+        fprintf(stderr, "Not enough memory for resizing hash map %p", (void *)map);
+        return;
+    }
+
+    for (int i = 0; i < old_capacity; i++)
+    {
+        if (old_control_bytes[i] < 0)
+            continue;
+        unsigned long index = find_insert_index(map, old_slots[i].hash);
+        map->control_bytes[index] = old_control_bytes[i];
+        map->slots[index] = old_slots[i];
+    }
+
+    free(old_control_bytes);
+    free(old_slots);
+    update_load_factor(map);
+}
+
+static int max_size(int capacity)
+{
+    // 7/8 load, the probe always finds an empty byte before wrapping around
+    return capacity - capacity / 8;
+}
+
+static void update_load_factor(t_hash_map *map)
+{
+    map->load_factor = (double)map->size / (double)map->capacity;
+}
@@ -0,0 +1,31 @@
+#ifndef SWISS_TABLE_H_INCLUDED
+#define SWISS_TABLE_H_INCLUDED
+
+#include <stdbool.h>
+#include "hashmap.h"
+
+// Swiss table backend of t_hash_map, only meant to be called from hashmap.c
+// Keys arrive already hashed and spread by the dispatcher
+// Define HASH_MAP_NO_SIMD to force the scalar group matching on SSE2 targets
+
+bool swiss_table_init(t_hash_map *map);
+
+void swiss_table_put(t_hash_map *map, char *key, size_t length, unsigned long hash, void *data);
+
+void *swiss_table_get(t_hash_map *map, char *key, size_t length, unsigned long hash);
+
+bool swiss_table_remove(t_hash_map *map, char *key, size_t length, unsigned long hash, void **out_value);
+
+// hint only: touches nothing but the cache lines the lookup of hash will start from
+void swiss_table_prefetch(t_hash_map *map, unsigned long hash);
+
+void swiss_table_iterate(t_hash_map *map, void (*iterator)(char *, void *));
+
+// first occupied slot from index on, -1 when there is none
+int swiss_table_next_slot(t_hash_map *map, int index);
+
+void swiss_table_clean(t_hash_map *map, void (*element_destroyer)(void *));
+
+void swiss_table_destroy(t_hash_map *map);
+
+#endif
@@ -0,0 +1,211 @@
+#ifndef TYPED_HASH_MAP_H_INCLUDED
+#define TYPED_HASH_MAP_H_INCLUDED
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include "hashmap.h"
+#include "hash_mixing.h"
+
+// DEFINE_HASH_MAP(K, V, name) generates t_hash_map_<name> and hash_map_<name>_* functions
+// with the same shape as t_hash_map, but keys and values live inline in the slots of a
+// robin hood table (the HASH_MAP_OPEN_ADDRESSING layout): no key copy, no boxed value.
+//
+//     DEFINE_HASH_MAP(uint64_t, struct foo, u64_foo)
+//     t_hash_map_u64_foo *map = hash_map_u64_foo_create();
+//     hash_map_u64_foo_put(map, 42, (struct foo){...});
+//     struct foo *found = hash_map_u64_foo_get(map, 42);
+//
+// DEFINE_HASH_MAP hashes and compares the bytes of the key, fine for integers and structs
+// without padding. Anything else (strings, padded structs) goes through
+// DEFINE_HASH_MAP_WITH_FUNCTIONS with unsigned long hash(K const *) and bool equals(K const *, K const *).
+// Pointers returned by get stay valid until the next put or remove.
+
+// stored hashes always have the top bit set, a zero hash marks an empty slot
+#define TYPED_HASH_MAP_USED_BIT (~(~0UL >> 1))
+
+#define DEFINE_HASH_MAP(K, V, name)                                                                 \
+    static inline unsigned long hash_map_##name##_hash_bytes(K const *key)                          \
+    {                                                                                               \
+        return hash_wy_n((const char *)key, sizeof(K));                                             \
+    }                                                                                               \
+                                                                                                    \
+    static inline bool hash_map_##name##_equal_bytes(K const *a, K const *b)                        \
+    {                                                                                               \
+        return memcmp(a, b, sizeof(K)) == 0;                                                        \
+    }                                                                                               \
+                                                                                                    \
+    DEFINE_HASH_MAP_WITH_FUNCTIONS(K, V, name, hash_map_##name##_hash_bytes, hash_map_##name##_equal_bytes)
+
+#define DEFINE_HASH_MAP_WITH_FUNCTIONS(K, V, name, hash_function, equals_function)                  \
+                                                                                                    \
+    typedef struct                                                                                  \
+    {                                                                                               \
+        unsigned long hash;                                                                         \
+        K key;                                                                                      \
+        V value;                                                                                    \
+    } t_hash_slot_##name;                                                                           \
+                                                                                                    \
+    typedef struct                                                                                  \
+    {                                                                                               \
+        int size;                                                                                   \
+        int capacity;                                                                               \
+        t_hash_slot_##name *slots;                                                                  \
+    } t_hash_map_##name;                                                                            \
+                                                                                                    \
+    static inline t_hash_map_##name *hash_map_##name##_create(void)                                 \
+    {                                                                                               \
+        t_hash_map_##name *self = malloc(sizeof(t_hash_map_##name));                                \
+        if (!self)                                                                                  \
+            return NULL;                                                                            \
+        self->size = 0;                                                                             \
+        self->capacity = OPEN_ADDRESSING_INITIAL_CAPACITY;                                          \
+        self->slots = calloc(self->capacity, sizeof(t_hash_slot_##name));                           \
+        if (!self->slots)                                                                           \
+        {                                                                                           \
+            free(self);                                                                             \
+            return NULL;                                                                            \
+        }                                                                                           \
+        return self;                                                                                \
+    }                                                                                               \
+                                                                                                    \
+    static inline void hash_map_##name##_destroy(t_hash_map_##name *self)                           \
+    {                                                                                               \
+        free(self->slots);                                                                          \
+        free(self);                                                                                 \
+    }                                                                                               \
+                                                                                                    \
+    static inline void hash_map_##name##_clean(t_hash_map_##name *self)                             \
+    {                                                                                               \
+        memset(self->slots, 0, self->capacity * sizeof(t_hash_slot_##name));                       \
+        self->size = 0;                                                                             \
+    }                                                                                               \
+                                                                                                    \
+    static inline int hash_map_##name##_size(t_hash_map_##name *self)                               \
+    {                                                                                               \
+        return self->size;                                                                          \
+    }                                                                                               \
+                                                                                                    \
+    static inline unsigned long hash_map_##name##_hash_key(K const *key)                            \
+    {                                                                                               \
+        return spread_hash(hash_function(key)) | TYPED_HASH_MAP_USED_BIT;                           \
+    }                                                                                               \
+                                                                                                    \
+    static inline unsigned long hash_map_##name##_probe_distance(unsigned long hash, unsigned long index, unsigned long mask) \
+    {                                                                                               \
+        return (index - (hash & mask)) & mask;                                                      \
+    }                                                                                               \
+                                                                                                    \
+    static inline t_hash_slot_##name *hash_map_##name##_find_slot(t_hash_map_##name *self, K const *key, unsigned long hash) \
+    {                                                                                               \
+        unsigned long mask = self->capacity - 1;                                                    \
+        unsigned long index = hash & mask;                                                          \
+        unsigned long distance = 0;                                                                 \
+        while (self->slots[index].hash)                                                             \
+        {                                                                                           \
+            t_hash_slot_##name *slot = &self->slots[index];                                         \
+            if (hash_map_##name##_probe_distance(slot->hash, index, mask) < distance)               \
+                return NULL;                                                                        \
+            if (slot->hash == hash && equals_function(&slot->key, key))                             \
+                return slot;                                                                        \
+            index = (index + 1) & mask;                                                             \
+            distance++;                                                                             \
+        }                                                                                           \
+        return NULL;                                                                                \
+    }                                                                                               \
+                                                                                                    \
+    static inline void hash_map_##name##_insert_slot(t_hash_slot_##name *slots, unsigned long mask, t_hash_slot_##name entry) \
+    {                                                                                               \
+        unsigned long index = entry.hash & mask;                                                    \
+        unsigned long distance = 0;                                                                 \
+        while (slots[index].hash)                                                                   \
+        {                                                                                           \
+            unsigned long existing_distance = hash_map_##name##_probe_distance(slots[index].hash, index, mask); \
+            if (existing_distance < distance)                                                       \
+            {                                                                                       \
+                t_hash_slot_##name displaced = slots[index];                                        \
+                slots[index] = entry;                                                               \
+                entry = displaced;                                                                  \
+                distance = existing_distance;                                                       \
+            }                                                                                       \
+            index = (index + 1) & mask;                                                             \
+            distance++;                                                                             \
+        }                                                                                           \
+        slots[index] = entry;                                                                       \
+    }                                                                                               \
+                                                                                                    \
+    static inline bool hash_map_##name##_resize(t_hash_map_##name *self, int new_capacity)          \
+    {                                                                                               \
+        t_hash_slot_##name *new_slots = calloc(new_capacity, sizeof(t_hash_slot_##name));           \
+        if (!new_slots)                                                                             \
+            return false;                                                                           \
+        for (int i = 0; i < self->capacity; i++)                                                    \
+        {                                                                                           \
+            if (self->slots[i].hash)                                                                \
+                hash_map_##name##_insert_slot(new_slots, new_capacity - 1, self->slots[i]);         \
+        }                                                                                           \
+        free(self->slots);                                                                          \
+        self->slots = new_slots;                                                                    \
+        self->capacity = new_capacity;                                                              \
+        return true;                                                                                \
+    }                                                                                               \
+                                                                                                    \
+    static inline void hash_map_##name##_put(t_hash_map_##name *self, K key, V value)               \
+    {                                                                                               \
+        unsigned long hash = hash_map_##name##_hash_key(&key);                                      \
+        t_hash_slot_##name *existing = hash_map_##name##_find_slot(self, &key, hash);               \
+        if (existing)                                                                               \
+        {                                                                                           \
+            existing->value = value;                                                                \
+            return;                                                                                 \
+        }                                                                                           \
+        if ((double)(self->size + 1) / (double)self->capacity > OPEN_ADDRESSING_LOAD_FACTOR         \
+            && !hash_map_##name##_resize(self, self->capacity * DEFAULT_CAPACITY_MULTIPLIER))       \
+        {                                                                                           \
+            fprintf(stderr, "Not enough memory for resizing hash map %p", (void *)self);            \
+            return;                                                                                 \
+        }                                                                                           \
+        hash_map_##name##_insert_slot(self->slots, self->capacity - 1,                              \
+                                      (t_hash_slot_##name){.hash = hash, .key = key, .value = value}); \
+        self->size++;                                                                               \
+    }                                                                                               \
+                                                                                                    \
+    static inline V *hash_map_##name##_get(t_hash_map_##name *self, K key)                          \
+    {                                                                                               \
+        t_hash_slot_##name *slot = hash_map_##name##_find_slot(self, &key, hash_map_##name##_hash_key(&key)); \
+        return slot ? &slot->value : NULL;                                                          \
+    }                                                                                               \
+                                                                                                    \
+    static inline bool hash_map_##name##_remove(t_hash_map_##name *self, K key, V *out_value)       \
+    {                                                                                               \
+        t_hash_slot_##name *slot = hash_map_##name##_find_slot(self, &key, hash_map_##name##_hash_key(&key)); \
+        if (!slot)                                                                                  \
+            return false;                                                                           \
+        if (out_value)                                                                              \
+            *out_value = slot->value;                                                               \
+        /* backward shift deletion, no tombstones needed */                                         \
+        unsigned long mask = self->capacity - 1;                                                    \
+        unsigned long hole = slot - self->slots;                                                    \
+        unsigned long next = (hole + 1) & mask;                                                     \
+        while (self->slots[next].hash && hash_map_##name##_probe_distance(self->slots[next].hash, next, mask) > 0) \
+        {                                                                                           \
+            self->slots[hole] = self->slots[next];                                                  \
+            hole = next;                                                                            \
+            next = (next + 1) & mask;                                                               \
+        }                                                                                           \
+        self->slots[hole].hash = 0;                                                                 \
+        self->size--;                                                                               \
+        return true;                                                                                \
+    }                                                                                               \
+                                                                                                    \
+    static inline void hash_map_##name##_iterate(t_hash_map_##name *self, void (*iterator)(K *, V *)) \
+    {                                                                                               \
+        for (int i = 0; i < self->capacity; i++)                                                    \
+        {                                                                                           \
+            if (self->slots[i].hash)                                                                \
+                iterator(&self->slots[i].key, &self->slots[i].value);                               \
+        }                                                                                           \
+    }
+
+#endif
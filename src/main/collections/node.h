@@ -1,6 +1,8 @@
 #ifndef NODE_H_INCLUDED
 #define NODE_H_INCLUDED
 
+#include <stddef.h>
+
 typedef struct double_l_node{
     void* data;
     struct double_l_node* next;
@@ -12,8 +14,18 @@ typedef struct hash_element{
     char* key;
     void* value;
     struct hash_element* next;
+    // size_t like the length the _n functions take. On 64 bit it fills the padding an int left
+    size_t key_length;
 } t_hash_node;
 
+// open addressing slot, an empty slot has a NULL key
+typedef struct hash_slot{
+    unsigned long hash;
+    char* key;
+    void* value;
+    size_t key_length;
+} t_hash_slot;
+
 
 
 #endif
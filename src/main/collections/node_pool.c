@@ -0,0 +1,67 @@
+#include "node_pool.h"
+
+static t_node_pool_slab* create_slab(int capacity, t_node_pool_slab* next);
+static void destroy_slabs(t_node_pool_slab* slab);
+
+t_node_pool* node_pool_create(void){
+    t_node_pool* pool = malloc(sizeof(t_node_pool));
+    if(!pool) return NULL;
+    pool->slabs = NULL;
+    pool->free_nodes = NULL;
+    return pool;
+}
+
+t_double_l_node* node_pool_acquire(t_node_pool* pool){
+    if(pool->free_nodes){
+        t_double_l_node* node = pool->free_nodes;
+        pool->free_nodes = node->next;
+        return node;
+    }
+
+    t_node_pool_slab* slab = pool->slabs;
+    if(!slab || slab->used == slab->capacity){
+        int capacity = !slab ? NODE_POOL_FIRST_SLAB_NODES : slab->capacity * 2;
+        if(capacity > NODE_POOL_MAX_SLAB_NODES) capacity = NODE_POOL_MAX_SLAB_NODES;
+        slab = create_slab(capacity, pool->slabs);
+        if(!slab) return NULL;
+        pool->slabs = slab;
+    }
+    return &slab->nodes[slab->used++];
+}
+
+void node_pool_release(t_node_pool* pool, t_double_l_node* node){
+    node->next = pool->free_nodes;
+    pool->free_nodes = node;
+}
+
+// keeps the newest (biggest) slab so a cleaned list refills without allocating
+void node_pool_reset(t_node_pool* pool){
+    if(pool->slabs){
+        destroy_slabs(pool->slabs->next);
+        pool->slabs->next = NULL;
+        pool->slabs->used = 0;
+    }
+    pool->free_nodes = NULL;
+}
+
+void node_pool_destroy(t_node_pool* pool){
+    destroy_slabs(pool->slabs);
+    free(pool);
+}
+
+static t_node_pool_slab* create_slab(int capacity, t_node_pool_slab* next){
+    t_node_pool_slab* slab = malloc(sizeof(t_node_pool_slab) + capacity * sizeof(t_double_l_node));
+    if(!slab) return NULL;
+    slab->next = next;
+    slab->used = 0;
+    slab->capacity = capacity;
+    return slab;
+}
+
+static void destroy_slabs(t_node_pool_slab* slab){
+    while(slab){
+        t_node_pool_slab* next = slab->next;
+        free(slab);
+        slab = next;
+    }
+}
@@ -0,0 +1,37 @@
+#ifndef NODE_POOL_H_INCLUDED
+#define NODE_POOL_H_INCLUDED
+
+#include <stdlib.h>
+#include "node.h"
+
+// nodes in the first slab, every new slab doubles up to the max
+#define NODE_POOL_FIRST_SLAB_NODES 16
+#define NODE_POOL_MAX_SLAB_NODES 4096
+
+typedef struct node_pool_slab{
+    struct node_pool_slab* next;
+    int used;
+    int capacity;
+    t_double_l_node nodes[];
+} t_node_pool_slab;
+
+// Slab allocator for list nodes: nodes are bump allocated from slabs, released ones go to a
+// free list (linked through next) and are reused before the slab grows. Slabs are only
+// given back to malloc on reset or destroy
+typedef struct{
+    t_node_pool_slab* slabs;
+    t_double_l_node* free_nodes;
+} t_node_pool;
+
+t_node_pool* node_pool_create(void);
+
+t_double_l_node* node_pool_acquire(t_node_pool* pool);
+
+void node_pool_release(t_node_pool* pool, t_double_l_node* node);
+
+// every node goes back to the pool at once, only safe when nothing still links them
+void node_pool_reset(t_node_pool* pool);
+
+void node_pool_destroy(t_node_pool* pool);
+
+#endif
@@ -0,0 +1,16 @@
+#ifndef POWER_OF_TWO_H_INCLUDED
+#define POWER_OF_TWO_H_INCLUDED
+
+#include <stddef.h>
+
+// Rings and stripe tables index with value & (capacity - 1), so their sizes are rounded up
+// to the next power of two. 0 and 1 both give 1
+static inline size_t round_up_to_power_of_two(size_t value)
+{
+    size_t power = 1;
+    while (power < value)
+        power <<= 1;
+    return power;
+}
+
+#endif
@@ -0,0 +1,185 @@
+#include <time.h>
+#include <errno.h>
+#include <unistd.h>
+#include "blocking_queue.h"
+
+// timeouts are measured on the monotonic clock, immune to wall clock changes, where condition
+// variables can be told to use it. macOS can't, its deadlines stay on the wall clock
+#if defined(_POSIX_CLOCK_SELECTION) && _POSIX_CLOCK_SELECTION > 0
+#define HAS_CONDATTR_SETCLOCK 1
+#define DEADLINE_CLOCK CLOCK_MONOTONIC
+#else
+#define DEADLINE_CLOCK CLOCK_REALTIME
+#endif
+
+static void deadline_after(struct timespec *deadline, long timeout_ms);
+static t_queue_error push_counted(t_blocking_queue *queue, void *elem);
+
+t_blocking_queue *blocking_queue_create(void)
+{
+    t_blocking_queue *queue = malloc(sizeof(t_blocking_queue));
+    if (!queue)
+        return NULL;
+    queue->elements = queue_create();
+    if (!queue->elements)
+    {
+        free(queue);
+        return NULL;
+    }
+
+#ifdef HAS_CONDATTR_SETCLOCK
+    pthread_condattr_t attributes;
+    pthread_condattr_init(&attributes);
+    pthread_condattr_setclock(&attributes, DEADLINE_CLOCK);
+    pthread_cond_init(&queue->not_empty, &attributes);
+    pthread_condattr_destroy(&attributes);
+#else
+    pthread_cond_init(&queue->not_empty, NULL);
+#endif
+    pthread_mutex_init(&queue->lock, NULL);
+    queue->closed = false;
+    return queue;
+}
+
+t_queue_error blocking_queue_push(t_blocking_queue *queue, void *elem)
+{
+    pthread_mutex_lock(&queue->lock);
+    t_queue_error result = QUEUE_CLOSED;
+    if (!queue->closed)
+    {
+        result = push_counted(queue, elem);
+        if (result == QUEUE_SUCCESS)
+            pthread_cond_signal(&queue->not_empty);
+    }
+    pthread_mutex_unlock(&queue->lock);
+    return result;
+}
+
+t_queue_error blocking_queue_push_batch(t_blocking_queue *queue, void **elems, int count)
+{
+    pthread_mutex_lock(&queue->lock);
+    t_queue_error result = queue->closed ? QUEUE_CLOSED : QUEUE_SUCCESS;
+    int pushed = 0;
+    while (result == QUEUE_SUCCESS && pushed < count)
+    {
+        result = push_counted(queue, elems[pushed]);
+        if (result == QUEUE_SUCCESS)
+            pushed++;
+    }
+    // a single consumer may take everything, but batch poppers may want only part of it
+    if (pushed == 1)
+        pthread_cond_signal(&queue->not_empty);
+    else if (pushed > 1)
+        pthread_cond_broadcast(&queue->not_empty);
+    pthread_mutex_unlock(&queue->lock);
+    return result;
+}
+
+t_queue_error blocking_queue_pop(t_blocking_queue *queue, void **out_buffer)
+{
+    pthread_mutex_lock(&queue->lock);
+    while (queue_is_empty(queue->elements) && !queue->closed)
+        pthread_cond_wait(&queue->not_empty, &queue->lock);
+    t_queue_error result = queue_pop(queue->elements, out_buffer);
+    pthread_mutex_unlock(&queue->lock);
+    return result;
+}
+
+t_queue_error blocking_queue_try_pop(t_blocking_queue *queue, void **out_buffer)
+{
+    pthread_mutex_lock(&queue->lock);
+    t_queue_error result = queue_pop(queue->elements, out_buffer);
+    pthread_mutex_unlock(&queue->lock);
+    return result;
+}
+
+t_queue_error blocking_queue_pop_timeout(t_blocking_queue *queue, void **out_buffer, long timeout_ms)
+{
+    struct timespec deadline;
+    deadline_after(&deadline, timeout_ms);
+
+    pthread_mutex_lock(&queue->lock);
+    while (queue_is_empty(queue->elements) && !queue->closed)
+    {
+        if (pthread_cond_timedwait(&queue->not_empty, &queue->lock, &deadline) == ETIMEDOUT)
+        {
+            // an element may have slipped in right at the deadline
+            t_queue_error result = queue_pop(queue->elements, out_buffer);
+            pthread_mutex_unlock(&queue->lock);
+            return result == QUEUE_SUCCESS ? QUEUE_SUCCESS : QUEUE_TIMEOUT;
+        }
+    }
+    t_queue_error result = queue_pop(queue->elements, out_buffer);
+    pthread_mutex_unlock(&queue->lock);
+    return result;
+}
+
+int blocking_queue_pop_batch(t_blocking_queue *queue, void **out_buffer, int max)
+{
+    int taken = 0;
+
+    pthread_mutex_lock(&queue->lock);
+    while (queue_is_empty(queue->elements) && !queue->closed)
+        pthread_cond_wait(&queue->not_empty, &queue->lock);
+    while (taken < max && queue_pop(queue->elements, &out_buffer[taken]) == QUEUE_SUCCESS)
+        taken++;
+    pthread_mutex_unlock(&queue->lock);
+    return taken;
+}
+
+void blocking_queue_close(t_blocking_queue *queue)
+{
+    pthread_mutex_lock(&queue->lock);
+    queue->closed = true;
+    pthread_cond_broadcast(&queue->not_empty);
+    pthread_mutex_unlock(&queue->lock);
+}
+
+int blocking_queue_size(t_blocking_queue *queue)
+{
+    pthread_mutex_lock(&queue->lock);
+    int size = queue_size(queue->elements);
+    pthread_mutex_unlock(&queue->lock);
+    return size;
+}
+
+bool blocking_queue_is_empty(t_blocking_queue *queue)
+{
+    return blocking_queue_size(queue) == 0;
+}
+
+void blocking_queue_destroy(t_blocking_queue *queue)
+{
+    blocking_queue_destroy_and_destroy_elements(queue, NULL);
+}
+
+void blocking_queue_destroy_and_destroy_elements(t_blocking_queue *queue, void (*element_destroyer)(void *))
+{
+    queue_destroy_and_destroy_elements(queue->elements, element_destroyer);
+    pthread_cond_destroy(&queue->not_empty);
+    pthread_mutex_destroy(&queue->lock);
+    free(queue);
+}
+
+static void deadline_after(struct timespec *deadline, long timeout_ms)
+{
+    clock_gettime(DEADLINE_CLOCK, deadline);
+    // a negative remainder would give a negative tv_nsec, which timedwait rejects with EINVAL
+    if (timeout_ms < 0)
+        timeout_ms = 0;
+    deadline->tv_sec += timeout_ms / 1000;
+    deadline->tv_nsec += (timeout_ms % 1000) * 1000000;
+    if (deadline->tv_nsec >= 1000000000)
+    {
+        deadline->tv_sec++;
+        deadline->tv_nsec -= 1000000000;
+    }
+}
+
+// queue_push only reports a failed grow on stderr, so the size tells whether elem got in
+static t_queue_error push_counted(t_blocking_queue *queue, void *elem)
+{
+    int size = queue_size(queue->elements);
+    queue_push(queue->elements, elem);
+    return queue_size(queue->elements) > size ? QUEUE_SUCCESS : QUEUE_NO_MEMORY;
+}
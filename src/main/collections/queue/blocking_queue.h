@@ -0,0 +1,51 @@
+#ifndef BLOCKING_QUEUE_H_INCLUDED
+#define BLOCKING_QUEUE_H_INCLUDED
+
+#include <pthread.h>
+#include "queue.h"
+
+// Thread safe t_queue: every call takes the lock, pops wait on a condition variable until
+// something arrives. Once closed, pushes are dropped and pops drain what is left, then
+// return QUEUE_EMPTY instead of waiting, which is how consumers learn to stop
+typedef struct{
+    t_queue* elements;
+    pthread_mutex_t lock;
+    pthread_cond_t not_empty;
+    bool closed;
+} t_blocking_queue;
+
+t_blocking_queue* blocking_queue_create(void);
+
+// QUEUE_CLOSED or QUEUE_NO_MEMORY when elem was dropped
+t_queue_error blocking_queue_push(t_blocking_queue* queue, void* elem);
+
+// a single lock and wakeup for the whole batch. On QUEUE_CLOSED or QUEUE_NO_MEMORY
+// only the elements before the first dropped one were added
+t_queue_error blocking_queue_push_batch(t_blocking_queue* queue, void** elems, int count);
+
+// waits until there is an element, QUEUE_EMPTY only when closed and drained
+t_queue_error blocking_queue_pop(t_blocking_queue* queue, void** out_buffer);
+
+// QUEUE_EMPTY instead of waiting
+t_queue_error blocking_queue_try_pop(t_blocking_queue* queue, void** out_buffer);
+
+// QUEUE_TIMEOUT when nothing arrived within timeout_ms milliseconds, negative timeouts count as 0
+t_queue_error blocking_queue_pop_timeout(t_blocking_queue* queue, void** out_buffer, long timeout_ms);
+
+// waits like blocking_queue_pop, then takes up to max elements under the same lock.
+// Returns how many were stored in out_buffer, 0 only when closed and drained
+int blocking_queue_pop_batch(t_blocking_queue* queue, void** out_buffer, int max);
+
+// wakes every waiting consumer, no more pushes are accepted
+void blocking_queue_close(t_blocking_queue* queue);
+
+int blocking_queue_size(t_blocking_queue* queue);
+
+bool blocking_queue_is_empty(t_blocking_queue* queue);
+
+// no thread may be using or waiting on the queue anymore
+void blocking_queue_destroy(t_blocking_queue* queue);
+
+void blocking_queue_destroy_and_destroy_elements(t_blocking_queue* queue, void(*element_destroyer)(void*));
+
+#endif
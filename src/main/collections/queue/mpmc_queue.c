@@ -0,0 +1,132 @@
+#include "mpmc_queue.h"
+#include "../power_of_two.h"
+
+t_mpmc_queue *mpmc_queue_create(int capacity)
+{
+    // sizeof is already a multiple of the alignment, as aligned_alloc wants
+    t_mpmc_queue *queue = aligned_alloc(QUEUE_CACHE_LINE_SIZE, sizeof(t_mpmc_queue));
+    if (!queue)
+        return NULL;
+
+    // a single cell could not tell "free for the next lap" from "full" apart
+    size_t rounded = round_up_to_power_of_two(capacity > 2 ? capacity : 2);
+    queue->cells = malloc(rounded * sizeof(t_mpmc_cell));
+    if (!queue->cells)
+    {
+        free(queue);
+        return NULL;
+    }
+    for (size_t i = 0; i < rounded; i++)
+        atomic_init(&queue->cells[i].sequence, i);
+    queue->mask = rounded - 1;
+    atomic_init(&queue->enqueue_position, 0);
+    atomic_init(&queue->dequeue_position, 0);
+    return queue;
+}
+
+t_queue_error mpmc_queue_push(t_mpmc_queue *queue, void *elem)
+{
+    size_t position = atomic_load_explicit(&queue->enqueue_position, memory_order_relaxed);
+    t_mpmc_cell *cell;
+
+    for (;;)
+    {
+        cell = &queue->cells[position & queue->mask];
+        size_t sequence = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        intptr_t difference = (intptr_t)sequence - (intptr_t)position;
+
+        if (difference == 0)
+        {
+            // the cell is free for this lap, try to claim the position
+            if (atomic_compare_exchange_weak_explicit(&queue->enqueue_position, &position, position + 1,
+                                                      memory_order_relaxed, memory_order_relaxed))
+                break;
+        }
+        else if (difference < 0)
+        {
+            // the consumer of the previous lap has not taken it yet
+            return QUEUE_FULL;
+        }
+        else
+        {
+            // another producer got it first
+            position = atomic_load_explicit(&queue->enqueue_position, memory_order_relaxed);
+        }
+    }
+
+    cell->data = elem;
+    atomic_store_explicit(&cell->sequence, position + 1, memory_order_release);
+    return QUEUE_SUCCESS;
+}
+
+t_queue_error mpmc_queue_pop(t_mpmc_queue *queue, void **out_buffer)
+{
+    size_t position = atomic_load_explicit(&queue->dequeue_position, memory_order_relaxed);
+    t_mpmc_cell *cell;
+
+    for (;;)
+    {
+        cell = &queue->cells[position & queue->mask];
+        size_t sequence = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        intptr_t difference = (intptr_t)sequence - (intptr_t)(position + 1);
+
+        if (difference == 0)
+        {
+            if (atomic_compare_exchange_weak_explicit(&queue->dequeue_position, &position, position + 1,
+                                                      memory_order_relaxed, memory_order_relaxed))
+                break;
+        }
+        else if (difference < 0)
+        {
+            // no producer has filled this position yet
+            return QUEUE_EMPTY;
+        }
+        else
+        {
+            position = atomic_load_explicit(&queue->dequeue_position, memory_order_relaxed);
+        }
+    }
+
+    if (out_buffer)
+        *out_buffer = cell->data;
+    // frees the cell for the producer of the next lap
+    atomic_store_explicit(&cell->sequence, position + queue->mask + 1, memory_order_release);
+    return QUEUE_SUCCESS;
+}
+
+int mpmc_queue_size(t_mpmc_queue *queue)
+{
+    size_t dequeue_position = atomic_load_explicit(&queue->dequeue_position, memory_order_acquire);
+    size_t enqueue_position = atomic_load_explicit(&queue->enqueue_position, memory_order_acquire);
+    // both are read at different times, clamp what can't be a real size
+    intptr_t size = (intptr_t)(enqueue_position - dequeue_position);
+    if (size < 0)
+        return 0;
+    if ((size_t)size > queue->mask + 1)
+        return (int)(queue->mask + 1);
+    return (int)size;
+}
+
+bool mpmc_queue_is_empty(t_mpmc_queue *queue)
+{
+    return mpmc_queue_size(queue) == 0;
+}
+
+int mpmc_queue_capacity(t_mpmc_queue *queue)
+{
+    return (int)(queue->mask + 1);
+}
+
+void mpmc_queue_destroy(t_mpmc_queue *queue)
+{
+    mpmc_queue_destroy_and_destroy_elements(queue, NULL);
+}
+
+void mpmc_queue_destroy_and_destroy_elements(t_mpmc_queue *queue, void (*element_destroyer)(void *))
+{
+    void *elem;
+    while (element_destroyer && mpmc_queue_pop(queue, &elem) == QUEUE_SUCCESS)
+        element_destroyer(elem);
+    free(queue->cells);
+    free(queue);
+}
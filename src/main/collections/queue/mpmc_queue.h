@@ -0,0 +1,46 @@
+#ifndef MPMC_QUEUE_H_INCLUDED
+#define MPMC_QUEUE_H_INCLUDED
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include "queue.h"
+
+// Bounded lock free queue for any number of producers and consumers (Vyukov's design).
+// Every cell carries a sequence number telling whose turn it is: position p is free for the
+// producer of lap p when sequence == p, and holds data for its consumer when sequence == p + 1.
+// Threads claim positions with a CAS on enqueue_position / dequeue_position, never a lock
+typedef struct{
+    atomic_size_t sequence;
+    void* data;
+} t_mpmc_cell;
+
+typedef struct{
+    _Alignas(QUEUE_CACHE_LINE_SIZE) atomic_size_t enqueue_position;
+    _Alignas(QUEUE_CACHE_LINE_SIZE) atomic_size_t dequeue_position;
+    // read only after creation
+    _Alignas(QUEUE_CACHE_LINE_SIZE) size_t mask;
+    t_mpmc_cell* cells;
+} t_mpmc_queue;
+
+// capacity is rounded up to a power of two, at least 2
+t_mpmc_queue* mpmc_queue_create(int capacity);
+
+// QUEUE_FULL when there is no room
+t_queue_error mpmc_queue_push(t_mpmc_queue* queue, void* elem);
+
+// QUEUE_EMPTY when there is nothing to take
+t_queue_error mpmc_queue_pop(t_mpmc_queue* queue, void** out_buffer);
+
+// a snapshot, other threads may change it right away
+int mpmc_queue_size(t_mpmc_queue* queue);
+
+bool mpmc_queue_is_empty(t_mpmc_queue* queue);
+
+int mpmc_queue_capacity(t_mpmc_queue* queue);
+
+// no thread may be using the queue anymore
+void mpmc_queue_destroy(t_mpmc_queue* queue);
+
+void mpmc_queue_destroy_and_destroy_elements(t_mpmc_queue* queue, void(*element_destroyer)(void*));
+
+#endif
@@ -0,0 +1,232 @@
+#include "priority_queue.h"
+
+static t_priority_queue *create_with_capacity(int capacity, bool (*comparator)(void *, void *));
+static bool grow(t_priority_queue *queue);
+static void sift_up(t_priority_queue *queue, int index);
+static void sift_down(t_priority_queue *queue, int index);
+static void remove_at(t_priority_queue *queue, int index);
+static bool is_valid_handle(t_priority_queue *queue, t_priority_queue_handle handle);
+
+t_priority_queue *priority_queue_create(bool (*comparator)(void *, void *))
+{
+    return create_with_capacity(PRIORITY_QUEUE_INITIAL_CAPACITY, comparator);
+}
+
+t_priority_queue *priority_queue_create_from_array_list(t_array_list *list, bool (*comparator)(void *, void *))
+{
+    int count = array_list_size(list);
+    t_priority_queue *queue = create_with_capacity(count > PRIORITY_QUEUE_INITIAL_CAPACITY ? count : PRIORITY_QUEUE_INITIAL_CAPACITY, comparator);
+    if (!queue)
+        return NULL;
+    for (int i = 0; i < count; i++)
+    {
+        queue->entries[i] = (t_priority_queue_entry){list->array[i], i};
+        queue->positions[i] = i;
+    }
+    queue->size = count;
+    queue->handle_count = count;
+    // leaves have nothing to sift, start at the parent of the last entry. With fewer than
+    // two entries there is no parent, and (count - 2) / arity would truncate to 0
+    if (count > 1)
+        for (int i = (count - 2) / PRIORITY_QUEUE_ARITY; i >= 0; i--)
+            sift_down(queue, i);
+    return queue;
+}
+
+t_priority_queue_handle priority_queue_push(t_priority_queue *queue, void *elem)
+{
+    if (queue->size == queue->capacity && !grow(queue))
+    {
+        fprintf(stderr, "Not enough memory for resizing priority queue %p", (void *)queue);
+        return -1;
+    }
+    // a handle is only ever new when every existing one is in use, so handle_count <= capacity
+    t_priority_queue_handle handle = queue->free_count > 0 ? queue->free_handles[--queue->free_count] : queue->handle_count++;
+    queue->entries[queue->size] = (t_priority_queue_entry){elem, handle};
+    queue->positions[handle] = queue->size;
+    queue->size++;
+    sift_up(queue, queue->size - 1);
+    return handle;
+}
+
+t_queue_error priority_queue_pop(t_priority_queue *queue, void **out_buffer)
+{
+    if (priority_queue_is_empty(queue))
+        return QUEUE_EMPTY;
+    if (out_buffer)
+        *out_buffer = queue->entries[0].data;
+    remove_at(queue, 0);
+    return QUEUE_SUCCESS;
+}
+
+t_queue_error priority_queue_peek(t_priority_queue *queue, void **out_buffer)
+{
+    if (priority_queue_is_empty(queue))
+        return QUEUE_EMPTY;
+    if (out_buffer)
+        *out_buffer = queue->entries[0].data;
+    return QUEUE_SUCCESS;
+}
+
+t_queue_error priority_queue_decrease_key(t_priority_queue *queue, t_priority_queue_handle handle)
+{
+    if (!is_valid_handle(queue, handle))
+        return QUEUE_INVALID_HANDLE;
+    sift_up(queue, queue->positions[handle]);
+    return QUEUE_SUCCESS;
+}
+
+t_queue_error priority_queue_remove(t_priority_queue *queue, t_priority_queue_handle handle, void **out_buffer)
+{
+    if (!is_valid_handle(queue, handle))
+        return QUEUE_INVALID_HANDLE;
+    int index = queue->positions[handle];
+    if (out_buffer)
+        *out_buffer = queue->entries[index].data;
+    remove_at(queue, index);
+    return QUEUE_SUCCESS;
+}
+
+int priority_queue_size(t_priority_queue *queue)
+{
+    return queue->size;
+}
+
+bool priority_queue_is_empty(t_priority_queue *queue)
+{
+    return priority_queue_size(queue) == 0;
+}
+
+void priority_queue_clean(t_priority_queue *queue)
+{
+    queue->size = 0;
+    queue->handle_count = 0;
+    queue->free_count = 0;
+}
+
+void priority_queue_clean_and_destroy_elements(t_priority_queue *queue, void (*element_destroyer)(void *))
+{
+    for (int i = 0; i < queue->size; i++)
+        element_destroyer(queue->entries[i].data);
+    priority_queue_clean(queue);
+}
+
+void priority_queue_destroy(t_priority_queue *queue)
+{
+    free(queue->entries);
+    free(queue->positions);
+    free(queue->free_handles);
+    free(queue);
+}
+
+void priority_queue_destroy_and_destroy_elements(t_priority_queue *queue, void (*element_destroyer)(void *))
+{
+    priority_queue_clean_and_destroy_elements(queue, element_destroyer);
+    priority_queue_destroy(queue);
+}
+
+static t_priority_queue *create_with_capacity(int capacity, bool (*comparator)(void *, void *))
+{
+    t_priority_queue *queue = malloc(sizeof(t_priority_queue));
+    if (!queue)
+        return NULL;
+    queue->entries = malloc(capacity * sizeof(t_priority_queue_entry));
+    queue->positions = malloc(capacity * sizeof(int));
+    queue->free_handles = malloc(capacity * sizeof(t_priority_queue_handle));
+    if (!queue->entries || !queue->positions || !queue->free_handles)
+    {
+        priority_queue_destroy(queue);
+        return NULL;
+    }
+    queue->capacity = capacity;
+    queue->size = 0;
+    queue->handle_count = 0;
+    queue->free_count = 0;
+    queue->comparator = comparator;
+    return queue;
+}
+
+static bool grow(t_priority_queue *queue)
+{
+    int capacity = queue->capacity * 2;
+    t_priority_queue_entry *entries = realloc(queue->entries, capacity * sizeof(t_priority_queue_entry));
+    if (!entries)
+        return false;
+    queue->entries = entries;
+    int *positions = realloc(queue->positions, capacity * sizeof(int));
+    if (!positions)
+        return false;
+    queue->positions = positions;
+    t_priority_queue_handle *free_handles = realloc(queue->free_handles, capacity * sizeof(t_priority_queue_handle));
+    if (!free_handles)
+        return false;
+    queue->free_handles = free_handles;
+    queue->capacity = capacity;
+    return true;
+}
+
+// moves parents down into the hole instead of swapping, the entry is written once at the end
+static void sift_up(t_priority_queue *queue, int index)
+{
+    t_priority_queue_entry entry = queue->entries[index];
+    while (index > 0)
+    {
+        int parent = (index - 1) / PRIORITY_QUEUE_ARITY;
+        if (!queue->comparator(entry.data, queue->entries[parent].data))
+            break;
+        queue->entries[index] = queue->entries[parent];
+        queue->positions[queue->entries[index].handle] = index;
+        index = parent;
+    }
+    queue->entries[index] = entry;
+    queue->positions[entry.handle] = index;
+}
+
+static void sift_down(t_priority_queue *queue, int index)
+{
+    t_priority_queue_entry entry = queue->entries[index];
+    for (;;)
+    {
+        int first_child = PRIORITY_QUEUE_ARITY * index + 1;
+        if (first_child >= queue->size)
+            break;
+        int last_child = first_child + PRIORITY_QUEUE_ARITY < queue->size ? first_child + PRIORITY_QUEUE_ARITY : queue->size;
+        int best = first_child;
+        for (int child = first_child + 1; child < last_child; child++)
+        {
+            if (queue->comparator(queue->entries[child].data, queue->entries[best].data))
+                best = child;
+        }
+        if (!queue->comparator(queue->entries[best].data, entry.data))
+            break;
+        queue->entries[index] = queue->entries[best];
+        queue->positions[queue->entries[index].handle] = index;
+        index = best;
+    }
+    queue->entries[index] = entry;
+    queue->positions[entry.handle] = index;
+}
+
+// fills the hole with the last entry, which may belong above or below it
+static void remove_at(t_priority_queue *queue, int index)
+{
+    t_priority_queue_handle handle = queue->entries[index].handle;
+    queue->positions[handle] = -1;
+    queue->free_handles[queue->free_count++] = handle;
+    queue->size--;
+    if (index == queue->size)
+        return;
+
+    queue->entries[index] = queue->entries[queue->size];
+    queue->positions[queue->entries[index].handle] = index;
+    int parent = (index - 1) / PRIORITY_QUEUE_ARITY;
+    if (index > 0 && queue->comparator(queue->entries[index].data, queue->entries[parent].data))
+        sift_up(queue, index);
+    else
+        sift_down(queue, index);
+}
+
+static bool is_valid_handle(t_priority_queue *queue, t_priority_queue_handle handle)
+{
+    return handle >= 0 && handle < queue->handle_count && queue->positions[handle] >= 0;
+}
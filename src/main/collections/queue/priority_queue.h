@@ -0,0 +1,67 @@
+#ifndef PRIORITY_QUEUE_H_INCLUDED
+#define PRIORITY_QUEUE_H_INCLUDED
+
+#include "queue.h"
+#include "../list/array_list.h"
+
+// children of entry i are ARITY * i + 1 ... ARITY * i + ARITY. Four children of pointer
+// and handle pairs fill one cache line and halve the depth of a binary heap
+#define PRIORITY_QUEUE_ARITY 4
+
+#define PRIORITY_QUEUE_INITIAL_CAPACITY 16
+
+// identifies an element for as long as it is in the queue, reused once it leaves
+typedef int t_priority_queue_handle;
+
+typedef struct{
+    void* data;
+    t_priority_queue_handle handle;
+} t_priority_queue_entry;
+
+// d-ary min heap in one array, comparator(a, b) is true when a must come out before b
+// (the same comparator linked_list_add_sorted takes). positions maps every handle to the
+// index of its entry, -1 for handles nobody holds
+typedef struct{
+    t_priority_queue_entry* entries;
+    int size;
+    int capacity;
+    int* positions;
+    // handles handed out so far, the size of positions and free_handles
+    int handle_count;
+    t_priority_queue_handle* free_handles;
+    int free_count;
+    bool (*comparator)(void*, void*);
+} t_priority_queue;
+
+t_priority_queue* priority_queue_create(bool (*comparator)(void*, void*));
+
+// heapifies a copy of the list's elements in O(n), the list is left untouched.
+// The element at index i of the list gets handle i
+t_priority_queue* priority_queue_create_from_array_list(t_array_list* list, bool (*comparator)(void*, void*));
+
+// -1 when there was no memory to grow
+t_priority_queue_handle priority_queue_push(t_priority_queue* queue, void* elem);
+
+t_queue_error priority_queue_pop(t_priority_queue* queue, void** out_buffer);
+
+t_queue_error priority_queue_peek(t_priority_queue* queue, void** out_buffer);
+
+// the element of handle was just changed to come out earlier, restores the heap in O(log n).
+// QUEUE_INVALID_HANDLE when handle is not in the queue
+t_queue_error priority_queue_decrease_key(t_priority_queue* queue, t_priority_queue_handle handle);
+
+t_queue_error priority_queue_remove(t_priority_queue* queue, t_priority_queue_handle handle, void** out_buffer);
+
+int priority_queue_size(t_priority_queue* queue);
+
+bool priority_queue_is_empty(t_priority_queue* queue);
+
+void priority_queue_clean(t_priority_queue* queue);
+
+void priority_queue_clean_and_destroy_elements(t_priority_queue* queue, void(*element_destroyer)(void*));
+
+void priority_queue_destroy(t_priority_queue* queue);
+
+void priority_queue_destroy_and_destroy_elements(t_priority_queue* queue, void(*element_destroyer)(void*));
+
+#endif
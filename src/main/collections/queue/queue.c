@@ -1,22 +1,43 @@
 #include "queue.h"
 
+static bool grow(t_queue *queue);
+
 t_queue *queue_create(void)
 {
     t_queue *queue = malloc(sizeof(t_queue));
-    queue->elements = linked_list_create();
+    if (!queue)
+        return NULL;
+    queue->elements = malloc(QUEUE_INITIAL_CAPACITY * sizeof(void *));
+    if (!queue->elements)
+    {
+        free(queue);
+        return NULL;
+    }
+    queue->capacity = QUEUE_INITIAL_CAPACITY;
+    queue->head = 0;
+    queue->size = 0;
     return queue;
 }
 
 void queue_push(t_queue *queue, void *elem)
 {
-    linked_list_add(queue->elements, elem);
+    if (queue->size == queue->capacity && !grow(queue))
+    {
+        fprintf(stderr, "Not enough memory for resizing queue %p", (void *)queue);
+        return;
+    }
+    queue->elements[(queue->head + queue->size) & (queue->capacity - 1)] = elem;
+    queue->size++;
 }
 
 t_queue_error queue_pop(t_queue *queue, void **out_buffer)
 {
     if (queue_is_empty(queue))
         return QUEUE_EMPTY;
-    linked_list_remove(queue->elements, 0, out_buffer);
+    if (out_buffer)
+        *out_buffer = queue->elements[queue->head];
+    queue->head = (queue->head + 1) & (queue->capacity - 1);
+    queue->size--;
     return QUEUE_SUCCESS;
 }
 
@@ -24,13 +45,14 @@ t_queue_error queue_peek(t_queue *queue, void **out_buffer)
 {
     if (queue_is_empty(queue))
         return QUEUE_EMPTY;
-    linked_list_get(queue->elements, 0, out_buffer);
+    if (out_buffer)
+        *out_buffer = queue->elements[queue->head];
     return QUEUE_SUCCESS;
 }
 
 int queue_size(t_queue *queue)
 {
-    return linked_list_size(queue->elements);
+    return queue->size;
 }
 
 bool queue_is_empty(t_queue *queue)
@@ -40,22 +62,46 @@ bool queue_is_empty(t_queue *queue)
 
 void queue_clean(t_queue *queue)
 {
-    linked_list_clean(queue->elements);
+    queue_clean_and_destroy_elements(queue, NULL);
 }
 
 void queue_clean_and_destroy_elements(t_queue *queue, void (*element_destroyer)(void *))
 {
-    linked_list_clean_and_destroy_elements(queue->elements, element_destroyer);
+    for (int i = 0; element_destroyer && i < queue->size; i++)
+        element_destroyer(queue->elements[(queue->head + i) & (queue->capacity - 1)]);
+    queue->head = 0;
+    queue->size = 0;
 }
 
 void queue_destroy(t_queue *queue)
 {
-    linked_list_destroy(queue->elements);
-    free(queue);
+    queue_destroy_and_destroy_elements(queue, NULL);
 }
 
 void queue_destroy_and_destroy_elements(t_queue *queue, void (*element_destroyer)(void *))
 {
-    linked_list_destroy_and_destroy_elements(queue->elements, element_destroyer);
+    queue_clean_and_destroy_elements(queue, element_destroyer);
+    free(queue->elements);
     free(queue);
 }
+
+// doubles the ring and unwraps it, the oldest element ends up at index 0
+static bool grow(t_queue *queue)
+{
+    int capacity = queue->capacity * 2;
+    void **elements = malloc(capacity * sizeof(void *));
+    if (!elements)
+        return false;
+
+    int first_part = queue->capacity - queue->head;
+    if (first_part > queue->size)
+        first_part = queue->size;
+    memcpy(elements, &queue->elements[queue->head], first_part * sizeof(void *));
+    memcpy(&elements[first_part], queue->elements, (queue->size - first_part) * sizeof(void *));
+
+    free(queue->elements);
+    queue->elements = elements;
+    queue->capacity = capacity;
+    queue->head = 0;
+    return true;
+}
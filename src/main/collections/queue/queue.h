@@ -1,16 +1,38 @@
 #ifndef QUEUE_H_INCLUDED
 #define QUEUE_H_INCLUDED
 
-#include "../list/linked_list.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+
+// ring capacity, always a power of two so wrapping is index & (capacity - 1)
+#define QUEUE_INITIAL_CAPACITY 16
+
+// keeps the indexes written by different threads of the concurrent queues apart
+#define QUEUE_CACHE_LINE_SIZE 64
 
 typedef enum{
     QUEUE_SUCCESS = 0,
-    QUEUE_EMPTY
+    QUEUE_EMPTY,
+    // only bounded queues (t_spsc_queue, t_mpmc_queue) ever report it
+    QUEUE_FULL,
+    // t_blocking_queue waits that ran out of time
+    QUEUE_TIMEOUT,
+    // t_priority_queue handles that are not in the queue
+    QUEUE_INVALID_HANDLE,
+    // a t_blocking_queue push found no memory to grow into, the element was not added
+    QUEUE_NO_MEMORY,
+    // pushes into a closed t_blocking_queue, the element was not added
+    QUEUE_CLOSED
 } t_queue_error;
 
-
+// growable circular buffer: elements live in [head, head + size) modulo capacity
 typedef struct {
-    t_linked_list* elements;
+    void** elements;
+    int capacity;
+    int head;
+    int size;
 } t_queue;
 
 t_queue* queue_create(void);
@@ -36,4 +58,3 @@ void queue_destroy_and_destroy_elements(t_queue* queue, void(*element_destroyer)
 
 
 #endif
-
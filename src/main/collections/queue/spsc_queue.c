@@ -0,0 +1,88 @@
+#include "spsc_queue.h"
+#include "../power_of_two.h"
+
+t_spsc_queue *spsc_queue_create(int capacity)
+{
+    // sizeof is already a multiple of the alignment, as aligned_alloc wants
+    t_spsc_queue *queue = aligned_alloc(QUEUE_CACHE_LINE_SIZE, sizeof(t_spsc_queue));
+    if (!queue)
+        return NULL;
+
+    size_t rounded = round_up_to_power_of_two(capacity > 0 ? capacity : 1);
+    queue->elements = malloc(rounded * sizeof(void *));
+    if (!queue->elements)
+    {
+        free(queue);
+        return NULL;
+    }
+    queue->mask = rounded - 1;
+    atomic_init(&queue->head, 0);
+    atomic_init(&queue->tail, 0);
+    queue->cached_head = 0;
+    queue->cached_tail = 0;
+    return queue;
+}
+
+t_queue_error spsc_queue_push(t_spsc_queue *queue, void *elem)
+{
+    size_t tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+    if (tail - queue->cached_head > queue->mask)
+    {
+        queue->cached_head = atomic_load_explicit(&queue->head, memory_order_acquire);
+        if (tail - queue->cached_head > queue->mask)
+            return QUEUE_FULL;
+    }
+
+    queue->elements[tail & queue->mask] = elem;
+    // publishes the element together with the new tail
+    atomic_store_explicit(&queue->tail, tail + 1, memory_order_release);
+    return QUEUE_SUCCESS;
+}
+
+t_queue_error spsc_queue_pop(t_spsc_queue *queue, void **out_buffer)
+{
+    size_t head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    if (head == queue->cached_tail)
+    {
+        queue->cached_tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+        if (head == queue->cached_tail)
+            return QUEUE_EMPTY;
+    }
+
+    if (out_buffer)
+        *out_buffer = queue->elements[head & queue->mask];
+    // hands the slot back to the producer only after it was read
+    atomic_store_explicit(&queue->head, head + 1, memory_order_release);
+    return QUEUE_SUCCESS;
+}
+
+int spsc_queue_size(t_spsc_queue *queue)
+{
+    size_t head = atomic_load_explicit(&queue->head, memory_order_acquire);
+    size_t tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+    return (int)(tail - head);
+}
+
+bool spsc_queue_is_empty(t_spsc_queue *queue)
+{
+    return spsc_queue_size(queue) == 0;
+}
+
+int spsc_queue_capacity(t_spsc_queue *queue)
+{
+    return (int)(queue->mask + 1);
+}
+
+void spsc_queue_destroy(t_spsc_queue *queue)
+{
+    spsc_queue_destroy_and_destroy_elements(queue, NULL);
+}
+
+void spsc_queue_destroy_and_destroy_elements(t_spsc_queue *queue, void (*element_destroyer)(void *))
+{
+    void *elem;
+    while (element_destroyer && spsc_queue_pop(queue, &elem) == QUEUE_SUCCESS)
+        element_destroyer(elem);
+    free(queue->elements);
+    free(queue);
+}
@@ -0,0 +1,43 @@
+#ifndef SPSC_QUEUE_H_INCLUDED
+#define SPSC_QUEUE_H_INCLUDED
+
+#include <stdatomic.h>
+#include "queue.h"
+
+// Bounded lock free queue for exactly one producer thread and one consumer thread.
+// Each side owns one index and keeps a cached copy of the other's, so the shared cache
+// lines are only touched when the cached view says the queue looks full (or empty)
+typedef struct{
+    // consumer side
+    _Alignas(QUEUE_CACHE_LINE_SIZE) atomic_size_t head;
+    size_t cached_tail;
+    // producer side
+    _Alignas(QUEUE_CACHE_LINE_SIZE) atomic_size_t tail;
+    size_t cached_head;
+    // read only after creation
+    _Alignas(QUEUE_CACHE_LINE_SIZE) size_t mask;
+    void** elements;
+} t_spsc_queue;
+
+// capacity is rounded up to a power of two
+t_spsc_queue* spsc_queue_create(int capacity);
+
+// producer only, QUEUE_FULL when there is no room
+t_queue_error spsc_queue_push(t_spsc_queue* queue, void* elem);
+
+// consumer only, QUEUE_EMPTY when there is nothing to take
+t_queue_error spsc_queue_pop(t_spsc_queue* queue, void** out_buffer);
+
+// exact from either side while the other one is idle, a snapshot otherwise
+int spsc_queue_size(t_spsc_queue* queue);
+
+bool spsc_queue_is_empty(t_spsc_queue* queue);
+
+int spsc_queue_capacity(t_spsc_queue* queue);
+
+// neither thread may be using the queue anymore
+void spsc_queue_destroy(t_spsc_queue* queue);
+
+void spsc_queue_destroy_and_destroy_elements(t_spsc_queue* queue, void(*element_destroyer)(void*));
+
+#endif
@@ -0,0 +1,153 @@
+#include "work_stealing_deque.h"
+#include "../power_of_two.h"
+
+static t_ws_deque_array *create_array(long capacity);
+static t_ws_deque_array *grow(t_work_stealing_deque *deque, t_ws_deque_array *array, long top, long bottom);
+
+t_work_stealing_deque *work_stealing_deque_create(int capacity)
+{
+    // sizeof is already a multiple of the alignment, as aligned_alloc wants
+    t_work_stealing_deque *deque = aligned_alloc(QUEUE_CACHE_LINE_SIZE, sizeof(t_work_stealing_deque));
+    if (!deque)
+        return NULL;
+
+    t_ws_deque_array *array = create_array((long)round_up_to_power_of_two(capacity > 0 ? capacity : 1));
+    if (!array)
+    {
+        free(deque);
+        return NULL;
+    }
+    atomic_init(&deque->top, 0);
+    atomic_init(&deque->bottom, 0);
+    atomic_init(&deque->array, array);
+    return deque;
+}
+
+t_queue_error work_stealing_deque_push(t_work_stealing_deque *deque, void *elem)
+{
+    long bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed);
+    long top = atomic_load_explicit(&deque->top, memory_order_acquire);
+    t_ws_deque_array *array = atomic_load_explicit(&deque->array, memory_order_relaxed);
+
+    if (bottom - top > array->capacity - 1)
+    {
+        array = grow(deque, array, top, bottom);
+        if (!array)
+        {
+            fprintf(stderr, "Not enough memory for resizing work stealing deque %p", (void *)deque);
+            return QUEUE_NO_MEMORY;
+        }
+    }
+    atomic_store_explicit(&array->elements[bottom & (array->capacity - 1)], elem, memory_order_relaxed);
+    // publishes the element to thieves reading bottom with acquire
+    atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_release);
+    return QUEUE_SUCCESS;
+}
+
+t_queue_error work_stealing_deque_pop(t_work_stealing_deque *deque, void **out_buffer)
+{
+    long bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed) - 1;
+    t_ws_deque_array *array = atomic_load_explicit(&deque->array, memory_order_relaxed);
+    // reserve the bottom element before looking at top, both seq_cst so a thief can't
+    // read the old bottom while this reads the old top
+    atomic_store_explicit(&deque->bottom, bottom, memory_order_seq_cst);
+    long top = atomic_load_explicit(&deque->top, memory_order_seq_cst);
+
+    if (top > bottom)
+    {
+        // it was already empty
+        atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+        return QUEUE_EMPTY;
+    }
+
+    void *elem = atomic_load_explicit(&array->elements[bottom & (array->capacity - 1)], memory_order_relaxed);
+    if (top == bottom)
+    {
+        // the last element, thieves may be after it too: whoever moves top first gets it
+        bool won = atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1,
+                                                           memory_order_seq_cst, memory_order_relaxed);
+        atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+        if (!won)
+            return QUEUE_EMPTY;
+    }
+    if (out_buffer)
+        *out_buffer = elem;
+    return QUEUE_SUCCESS;
+}
+
+t_queue_error work_stealing_deque_steal(t_work_stealing_deque *deque, void **out_buffer)
+{
+    long top = atomic_load_explicit(&deque->top, memory_order_seq_cst);
+    long bottom = atomic_load_explicit(&deque->bottom, memory_order_seq_cst);
+    if (top >= bottom)
+        return QUEUE_EMPTY;
+
+    t_ws_deque_array *array = atomic_load_explicit(&deque->array, memory_order_acquire);
+    void *elem = atomic_load_explicit(&array->elements[top & (array->capacity - 1)], memory_order_relaxed);
+    // if top moved meanwhile the element may be stale, it is dropped along with the race
+    if (!atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1,
+                                                 memory_order_seq_cst, memory_order_relaxed))
+        return QUEUE_EMPTY;
+    if (out_buffer)
+        *out_buffer = elem;
+    return QUEUE_SUCCESS;
+}
+
+int work_stealing_deque_size(t_work_stealing_deque *deque)
+{
+    long top = atomic_load_explicit(&deque->top, memory_order_acquire);
+    long bottom = atomic_load_explicit(&deque->bottom, memory_order_acquire);
+    // both are read at different times, a pop in progress can make it look negative
+    return bottom > top ? (int)(bottom - top) : 0;
+}
+
+bool work_stealing_deque_is_empty(t_work_stealing_deque *deque)
+{
+    return work_stealing_deque_size(deque) == 0;
+}
+
+void work_stealing_deque_destroy(t_work_stealing_deque *deque)
+{
+    work_stealing_deque_destroy_and_destroy_elements(deque, NULL);
+}
+
+void work_stealing_deque_destroy_and_destroy_elements(t_work_stealing_deque *deque, void (*element_destroyer)(void *))
+{
+    void *elem;
+    while (element_destroyer && work_stealing_deque_pop(deque, &elem) == QUEUE_SUCCESS)
+        element_destroyer(elem);
+    t_ws_deque_array *array = atomic_load_explicit(&deque->array, memory_order_relaxed);
+    while (array)
+    {
+        t_ws_deque_array *previous = array->previous;
+        free(array);
+        array = previous;
+    }
+    free(deque);
+}
+
+static t_ws_deque_array *create_array(long capacity)
+{
+    t_ws_deque_array *array = malloc(sizeof(t_ws_deque_array) + capacity * sizeof(_Atomic(void *)));
+    if (!array)
+        return NULL;
+    array->capacity = capacity;
+    array->previous = NULL;
+    return array;
+}
+
+static t_ws_deque_array *grow(t_work_stealing_deque *deque, t_ws_deque_array *array, long top, long bottom)
+{
+    t_ws_deque_array *bigger = create_array(array->capacity * 2);
+    if (!bigger)
+        return NULL;
+    // positions don't change, only where they land in the bigger array
+    for (long i = top; i < bottom; i++)
+    {
+        void *elem = atomic_load_explicit(&array->elements[i & (array->capacity - 1)], memory_order_relaxed);
+        atomic_store_explicit(&bigger->elements[i & (bigger->capacity - 1)], elem, memory_order_relaxed);
+    }
+    bigger->previous = array;
+    atomic_store_explicit(&deque->array, bigger, memory_order_release);
+    return bigger;
+}
@@ -0,0 +1,49 @@
+#ifndef WORK_STEALING_DEQUE_H_INCLUDED
+#define WORK_STEALING_DEQUE_H_INCLUDED
+
+#include <stdatomic.h>
+#include "queue.h"
+
+// circular array of a deque, replaced by one twice as big when the owner runs out of room.
+// Thieves may still be reading an old one, so it is only freed with the deque
+typedef struct ws_deque_array{
+    long capacity;
+    struct ws_deque_array* previous;
+    _Atomic(void*) elements[];
+} t_ws_deque_array;
+
+// Chase-Lev work stealing deque. One owner thread pushes and pops at the bottom (LIFO, no
+// CAS unless a single element is left), any number of thieves steal from the top (FIFO, one
+// CAS each). Elements live in [top, bottom) modulo the array capacity
+typedef struct{
+    // thieves' side
+    _Alignas(QUEUE_CACHE_LINE_SIZE) atomic_long top;
+    // owner's side
+    _Alignas(QUEUE_CACHE_LINE_SIZE) atomic_long bottom;
+    _Atomic(t_ws_deque_array*) array;
+} t_work_stealing_deque;
+
+// capacity is rounded up to a power of two, it grows as needed
+t_work_stealing_deque* work_stealing_deque_create(int capacity);
+
+// owner only. QUEUE_NO_MEMORY when the deque was full and could not grow, elem is then dropped
+t_queue_error work_stealing_deque_push(t_work_stealing_deque* deque, void* elem);
+
+// owner only, takes the newest element. QUEUE_EMPTY when there is nothing left
+t_queue_error work_stealing_deque_pop(t_work_stealing_deque* deque, void** out_buffer);
+
+// any thread, takes the oldest element. QUEUE_EMPTY when there is nothing to take or
+// another thread won the race for it, thieves usually move on to another victim
+t_queue_error work_stealing_deque_steal(t_work_stealing_deque* deque, void** out_buffer);
+
+// a snapshot, other threads may change it right away
+int work_stealing_deque_size(t_work_stealing_deque* deque);
+
+bool work_stealing_deque_is_empty(t_work_stealing_deque* deque);
+
+// no thread may be using the deque anymore
+void work_stealing_deque_destroy(t_work_stealing_deque* deque);
+
+void work_stealing_deque_destroy_and_destroy_elements(t_work_stealing_deque* deque, void(*element_destroyer)(void*));
+
+#endif
@@ -3,13 +3,33 @@
 t_stack *stack_create(void)
 {
     t_stack *stack = malloc(sizeof(t_stack));
-    stack->elements = linked_list_create();
+    if (!stack)
+        return NULL;
+    stack->elements = malloc(STACK_INITIAL_CAPACITY * sizeof(void *));
+    if (!stack->elements)
+    {
+        free(stack);
+        return NULL;
+    }
+    stack->capacity = STACK_INITIAL_CAPACITY;
+    stack->size = 0;
     return stack;
 }
 
 void stack_push(t_stack *stack, void *elem)
 {
-    linked_list_add_first(stack->elements, elem);
+    if (stack->size == stack->capacity)
+    {
+        void **elements = realloc(stack->elements, stack->capacity * 2 * sizeof(void *));
+        if (!elements)
+        {
+            fprintf(stderr, "Not enough memory for resizing stack %p", (void *)stack);
+            return;
+        }
+        stack->elements = elements;
+        stack->capacity *= 2;
+    }
+    stack->elements[stack->size++] = elem;
 }
 
 t_stack_error stack_pop(t_stack *stack, void **out_buffer)
@@ -17,7 +37,9 @@ t_stack_error stack_pop(t_stack *stack, void **out_buffer)
     if (stack_is_empty(stack))
         return STACK_EMPTY;
 
-    linked_list_remove(stack->elements, 0, out_buffer);
+    stack->size--;
+    if (out_buffer)
+        *out_buffer = stack->elements[stack->size];
 
     return STACK_SUCCESS;
 }
@@ -26,17 +48,24 @@ t_stack_error stack_peek(t_stack *stack, void **out_buffer)
 {
     if (stack_is_empty(stack))
         return STACK_EMPTY;
-    linked_list_get(stack->elements, 0, out_buffer);
+    if (out_buffer)
+        *out_buffer = stack->elements[stack->size - 1];
     return STACK_SUCCESS;
 }
 
-// int stack_search(t_stack* stack, void* elem){
-//     linked_list_find
-// }
+int stack_search(t_stack *stack, void *elem)
+{
+    for (int i = stack->size - 1; i >= 0; i--)
+    {
+        if (stack->elements[i] == elem)
+            return stack->size - i;
+    }
+    return -1;
+}
 
 int stack_size(t_stack *stack)
 {
-    return linked_list_size(stack->elements);
+    return stack->size;
 }
 
 bool stack_is_empty(t_stack *stack)
@@ -46,22 +75,24 @@ bool stack_is_empty(t_stack *stack)
 
 void stack_clean(t_stack *stack)
 {
-    linked_list_clean(stack->elements);
+    stack_clean_and_destroy_elements(stack, NULL);
 }
 
 void stack_clean_and_destroy_elements(t_stack *stack, void (*element_destroyer)(void *))
 {
-    linked_list_clean_and_destroy_elements(stack->elements, element_destroyer);
+    for (int i = 0; element_destroyer && i < stack->size; i++)
+        element_destroyer(stack->elements[i]);
+    stack->size = 0;
 }
 
 void stack_destroy(t_stack *stack)
 {
-    linked_list_destroy(stack->elements);
-    free(stack);
+    stack_destroy_and_destroy_elements(stack, NULL);
 }
 
 void stack_destroy_and_destroy_elements(t_stack *stack, void (*element_destroyer)(void *))
 {
-    linked_list_destroy_and_destroy_elements(stack->elements, element_destroyer);
+    stack_clean_and_destroy_elements(stack, element_destroyer);
+    free(stack->elements);
     free(stack);
 }
@@ -1,7 +1,11 @@
 #ifndef STACK_H_INCLUDED
 #define STACK_H_INCLUDED
 
-#include "../list/linked_list.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+
+#define STACK_INITIAL_CAPACITY 16
 
 typedef enum
 {
@@ -9,9 +13,12 @@ typedef enum
     STACK_EMPTY
 } t_stack_error;
 
+// contiguous array, the top is elements[size - 1]
 typedef struct
 {
-    t_linked_list *elements;
+    void **elements;
+    int capacity;
+    int size;
 } t_stack;
 
 t_stack *stack_create(void);
@@ -22,6 +29,7 @@ t_stack_error stack_pop(t_stack *stack, void **out_buffer);
 
 t_stack_error stack_peek(t_stack *stack, void **out_buffer);
 
+// 1 based distance from the top (the top itself is 1), -1 when elem is not in the stack
 int stack_search(t_stack *stack, void *elem);
 
 int stack_size(t_stack *stack);
@@ -0,0 +1,216 @@
+#include "stream.h"
+
+static t_stream *create_stream(t_stream_source source);
+static t_stream *add_stage(t_stream *stream, t_stream_stage stage);
+static bool next_from_source(t_stream *stream, void **element);
+
+t_stream *stream_from_linked_list(t_linked_list *list)
+{
+    t_stream *stream = create_stream(STREAM_FROM_LINKED_LIST);
+    if (stream)
+        stream->cursor.node = list->head;
+    return stream;
+}
+
+t_stream *stream_from_array_list(t_array_list *list)
+{
+    t_stream *stream = create_stream(STREAM_FROM_ARRAY_LIST);
+    if (stream)
+    {
+        stream->cursor.array.list = list;
+        stream->cursor.array.index = 0;
+    }
+    return stream;
+}
+
+t_stream *stream_from_hash_map(t_hash_map *map)
+{
+    t_stream *stream = create_stream(STREAM_FROM_HASH_MAP_VALUES);
+    if (stream)
+        hash_map_iterator_init(&stream->cursor.map, map);
+    return stream;
+}
+
+t_stream *stream_from_hash_map_keys(t_hash_map *map)
+{
+    t_stream *stream = create_stream(STREAM_FROM_HASH_MAP_KEYS);
+    if (stream)
+        hash_map_iterator_init(&stream->cursor.map, map);
+    return stream;
+}
+
+t_stream *stream_filter(t_stream *stream, bool (*condition)(void *))
+{
+    return add_stage(stream, (t_stream_stage){.kind = STREAM_FILTER, .condition = condition});
+}
+
+t_stream *stream_map(t_stream *stream, void *(*mapper)(void *))
+{
+    return add_stage(stream, (t_stream_stage){.kind = STREAM_MAP, .mapper = mapper});
+}
+
+t_stream *stream_take(t_stream *stream, int count)
+{
+    stream = add_stage(stream, (t_stream_stage){.kind = STREAM_TAKE, .remaining = count});
+    // nothing gets past a take of nothing, the source needs no reading at all
+    if (stream && count <= 0)
+        stream->exhausted = true;
+    return stream;
+}
+
+t_stream *stream_drop(t_stream *stream, int count)
+{
+    return add_stage(stream, (t_stream_stage){.kind = STREAM_DROP, .remaining = count});
+}
+
+bool stream_next(t_stream *stream, void **buffer)
+{
+    void *element;
+    while (stream && !stream->exhausted && next_from_source(stream, &element))
+    {
+        bool keep = true;
+        for (int i = 0; keep && i < stream->stage_count; i++)
+        {
+            t_stream_stage *stage = &stream->stages[i];
+            switch (stage->kind)
+            {
+            case STREAM_FILTER:
+                keep = stage->condition(element);
+                break;
+            case STREAM_MAP:
+                element = stage->mapper(element);
+                break;
+            case STREAM_TAKE:
+                // ends the stream with its last element, so nothing past it is ever read
+                if (--stage->remaining == 0)
+                    stream->exhausted = true;
+                break;
+            case STREAM_DROP:
+                if (stage->remaining > 0)
+                {
+                    stage->remaining--;
+                    keep = false;
+                }
+                break;
+            }
+        }
+        if (keep)
+        {
+            *buffer = element;
+            return true;
+        }
+    }
+    return false;
+}
+
+void stream_destroy(t_stream *stream)
+{
+    free(stream);
+}
+
+void stream_foreach(t_stream *stream, void (*closure)(void *))
+{
+    void *element;
+    while (stream_next(stream, &element))
+        closure(element);
+    stream_destroy(stream);
+}
+
+void *stream_foldl(t_stream *stream, void *seed, void *(*operation)(void *, void *))
+{
+    void *acc = seed;
+    void *element;
+    while (stream_next(stream, &element))
+        acc = operation(acc, element);
+    stream_destroy(stream);
+    return acc;
+}
+
+int stream_count(t_stream *stream)
+{
+    int count = 0;
+    void *element;
+    while (stream_next(stream, &element))
+        count++;
+    stream_destroy(stream);
+    return count;
+}
+
+bool stream_any_satisfy(t_stream *stream, bool (*condition)(void *))
+{
+    bool found = false;
+    void *element;
+    while (!found && stream_next(stream, &element))
+        found = condition(element);
+    stream_destroy(stream);
+    return found;
+}
+
+t_linked_list *stream_to_linked_list(t_stream *stream)
+{
+    t_linked_list *result = linked_list_create();
+    void *element;
+    while (result && stream_next(stream, &element))
+        linked_list_add(result, element);
+    stream_destroy(stream);
+    return result;
+}
+
+t_array_list *stream_to_array_list(t_stream *stream)
+{
+    t_array_list *result = array_list_create();
+    void *element;
+    while (result && stream_next(stream, &element))
+        array_list_add(result, element);
+    stream_destroy(stream);
+    return result;
+}
+
+static t_stream *create_stream(t_stream_source source)
+{
+    t_stream *stream = malloc(sizeof(t_stream));
+    if (!stream)
+        return NULL;
+    stream->source = source;
+    stream->stage_count = 0;
+    stream->exhausted = false;
+    return stream;
+}
+
+static t_stream *add_stage(t_stream *stream, t_stream_stage stage)
+{
+    if (!stream)
+        return NULL;
+    if (stream->stage_count == STREAM_MAX_STAGES)
+    {
+        fprintf(stderr, "Stream %p already has %d stages", (void *)stream, STREAM_MAX_STAGES);
+        stream_destroy(stream);
+        return NULL;
+    }
+    stream->stages[stream->stage_count++] = stage;
+    return stream;
+}
+
+// a switch rather than a function pointer per source, the compiler can inline every case
+static bool next_from_source(t_stream *stream, void **element)
+{
+    switch (stream->source)
+    {
+    case STREAM_FROM_LINKED_LIST:
+        if (!stream->cursor.node)
+            return false;
+        *element = stream->cursor.node->data;
+        stream->cursor.node = stream->cursor.node->next;
+        return true;
+    case STREAM_FROM_ARRAY_LIST:
+        if (stream->cursor.array.index >= array_list_size(stream->cursor.array.list))
+            return false;
+        *element = stream->cursor.array.list->array[stream->cursor.array.index++];
+        return true;
+    case STREAM_FROM_HASH_MAP_VALUES:
+        return hash_map_iterator_next(&stream->cursor.map, NULL, element);
+    case STREAM_FROM_HASH_MAP_KEYS:
+        return hash_map_iterator_next(&stream->cursor.map, (char **)element, NULL);
+    }
+    return false;
+}
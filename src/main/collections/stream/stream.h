@@ -0,0 +1,97 @@
+#ifndef STREAM_H_INCLUDED
+#define STREAM_H_INCLUDED
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include "../list/linked_list.h"
+#include "../list/array_list.h"
+#include "../map/hashmap.h"
+
+// filters, maps, takes and drops one stream can chain
+#define STREAM_MAX_STAGES 8
+
+typedef enum{
+    STREAM_FROM_LINKED_LIST,
+    STREAM_FROM_ARRAY_LIST,
+    STREAM_FROM_HASH_MAP_VALUES,
+    STREAM_FROM_HASH_MAP_KEYS
+} t_stream_source;
+
+typedef enum{
+    STREAM_FILTER,
+    STREAM_MAP,
+    STREAM_TAKE,
+    STREAM_DROP
+} t_stream_stage_kind;
+
+typedef struct{
+    t_stream_stage_kind kind;
+    bool (*condition)(void*);
+    void* (*mapper)(void*);
+    // elements a take still lets through or a drop still swallows
+    int remaining;
+} t_stream_stage;
+
+// Lazy pipeline over a collection. Stages only record what to do, nothing runs until a
+// terminal operation pulls the elements one by one from the source through every stage,
+// so filter, map and take chained together are a single pass with no list in between.
+// Terminal operations destroy the stream. The source must not change while it is in use
+typedef struct{
+    t_stream_source source;
+    union{
+        t_double_l_node* node;
+        struct{
+            t_array_list* list;
+            unsigned int index;
+        } array;
+        t_hash_map_iterator map;
+    } cursor;
+    t_stream_stage stages[STREAM_MAX_STAGES];
+    int stage_count;
+    // a take ran out, no element can get through anymore
+    bool exhausted;
+} t_stream;
+
+// sources, NULL when there was no memory
+
+t_stream* stream_from_linked_list(t_linked_list* list);
+
+t_stream* stream_from_array_list(t_array_list* list);
+
+t_stream* stream_from_hash_map(t_hash_map* map);
+
+t_stream* stream_from_hash_map_keys(t_hash_map* map);
+
+// stages return the stream they were given. With STREAM_MAX_STAGES stages already in place
+// the stream is destroyed and NULL returned, which every stream function accepts
+
+t_stream* stream_filter(t_stream* stream, bool (*condition)(void*));
+
+t_stream* stream_map(t_stream* stream, void* (*mapper)(void*));
+
+t_stream* stream_take(t_stream* stream, int count);
+
+t_stream* stream_drop(t_stream* stream, int count);
+
+// pulling one element at a time, the stream stays alive
+
+bool stream_next(t_stream* stream, void** buffer);
+
+void stream_destroy(t_stream* stream);
+
+// terminal operations
+
+void stream_foreach(t_stream* stream, void (*closure)(void*));
+
+void* stream_foldl(t_stream* stream, void* seed, void* (*operation)(void*, void*));
+
+int stream_count(t_stream* stream);
+
+bool stream_any_satisfy(t_stream* stream, bool (*condition)(void*));
+
+t_linked_list* stream_to_linked_list(t_stream* stream);
+
+t_array_list* stream_to_array_list(t_stream* stream);
+
+#endif
@@ -6,17 +6,39 @@
 
 #include "red_black_tree.h"
 
+// nodes placed back to back by the bulk loads, freed all at once with the tree
+struct rbt_block
+{
+    struct rbt_block *next;
+    _Alignas(max_align_t) unsigned char nodes[];
+};
+
 static t_rbt_node *create_node(t_key key, void *value);
 static void destroy_node(t_rbt_node *node);
 
-static bool find_node(t_rbt_node *root, t_comparator comparator, void *key, t_rbt_node **out, t_rbt_node **prev);
+static int compare_keys(t_rb_tree *tree, const void *a, const void *b);
+static bool find_node(t_rb_tree *tree, void *key, t_rbt_node **out, t_rbt_node **prev);
 static t_rbt_node *insert_child(t_rb_tree *tree, t_rbt_node *parent, t_key key, void *value);
 static void fix_insert(t_rb_tree *tree, t_rbt_node *node);
 static void rb_tree_inner_clear_and_destroy_elements(t_rbt_node **node, void (*element_destroyer)(void *));
-static t_rbt_node *rb_tree_delete_node(t_rb_tree *tree, void *key, t_rbt_node **out_replacer);
+static void transplant(t_rb_tree *tree, t_rbt_node *node, t_rbt_node *replacement);
 static void fix_deletion(t_rb_tree *tree, t_rbt_node *node, t_rbt_node *parent);
 static t_rbt_node *rb_tree_delete_and_fix(t_rb_tree *tree, void *key);
 static void rb_tree_inner_iterate_preorder(t_rbt_node *root, void (*iterator)(void *, void *));
+static t_rbt_node *leftmost(t_rbt_node *node);
+static t_rbt_node *rightmost(t_rbt_node *node);
+static t_rbt_node *successor(t_rbt_node *node);
+static t_rbt_node *predecessor(t_rbt_node *node);
+static t_rbt_node *bound(t_rb_tree *tree, void *key, bool strict);
+static int subtree_size(t_rbt_node *node);
+static void recount_subtree(t_rbt_node *node);
+static size_t node_stride(size_t key_size);
+static unsigned char *add_block(t_rb_tree *tree, size_t bytes);
+static void free_blocks(t_rb_tree *tree);
+static t_rbt_node *place_node(unsigned char **memory, t_key key, void *value);
+static void sort_batch(t_rb_tree *tree, t_key *keys, int *order, int *scratch, int n);
+static t_rbt_node *link_balanced(t_rbt_node **nodes, int n, t_rbt_node *parent, int depth, int red_depth);
+static void relink_sorted(t_rb_tree *tree, t_rbt_node **nodes, int n);
 
 t_rb_tree *rbt_tree_create(t_comparator comparator)
 {
@@ -24,11 +46,56 @@ t_rb_tree *rbt_tree_create(t_comparator comparator)
     if (!tree || !comparator)
         return NULL;
     tree->comparator = comparator;
+    tree->compare = NULL;
+    tree->compare_kind = RB_TREE_COMPARE_LESS_THAN;
+    tree->size = 0;
+    tree->root = NULL;
+    tree->blocks = NULL;
+    return tree;
+}
+
+t_rb_tree *rbt_tree_create_with_cmp(t_three_way_comparator compare)
+{
+    if (!compare)
+        return NULL;
+    t_rb_tree *tree = malloc(sizeof(t_rb_tree));
+    if (!tree)
+        return NULL;
+    tree->comparator = NULL;
+    tree->compare = compare;
+    if (compare == rb_tree_compare_int)
+        tree->compare_kind = RB_TREE_COMPARE_INT;
+    else if (compare == rb_tree_compare_int64)
+        tree->compare_kind = RB_TREE_COMPARE_INT64;
+    else if (compare == rb_tree_compare_string)
+        tree->compare_kind = RB_TREE_COMPARE_STRING;
+    else
+        tree->compare_kind = RB_TREE_COMPARE_THREE_WAY;
     tree->size = 0;
     tree->root = NULL;
+    tree->blocks = NULL;
     return tree;
 }
 
+int rb_tree_compare_int(const void *a, const void *b)
+{
+    int x = *(const int *)a;
+    int y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+int rb_tree_compare_int64(const void *a, const void *b)
+{
+    int64_t x = *(const int64_t *)a;
+    int64_t y = *(const int64_t *)b;
+    return (x > y) - (x < y);
+}
+
+int rb_tree_compare_string(const void *a, const void *b)
+{
+    return strcmp(a, b);
+}
+
 void rb_tree_destroy(t_rb_tree *tree)
 {
     rb_tree_clear(tree);
@@ -49,6 +116,7 @@ void rb_tree_clear(t_rb_tree *tree)
 void rb_tree_clear_and_destroy_elements(t_rb_tree *tree, void (*element_destroyer)(void *))
 {
     rb_tree_inner_clear_and_destroy_elements(&tree->root, element_destroyer);
+    free_blocks(tree);
     tree->size = 0;
 }
 
@@ -72,7 +140,7 @@ static void rb_tree_inner_clear_and_destroy_elements(t_rbt_node **node, void (*e
 bool rb_tree_insert(t_rb_tree *tree, t_key key, void *value)
 {
     t_rbt_node *aux, *parent;
-    bool res = find_node(tree->root, tree->comparator, key.data, &aux, &parent);
+    bool res = find_node(tree, key.data, &aux, &parent);
     if (res)
     {
         aux->value = value;
@@ -83,6 +151,8 @@ bool rb_tree_insert(t_rb_tree *tree, t_key key, void *value)
     if (!inserted)
         return false;
     tree->size++;
+    for (t_rbt_node *ancestor = inserted->parent; ancestor; ancestor = ancestor->parent)
+        ancestor->subtree_size++;
 
     if (!inserted->parent || inserted->parent->color == BLACK)
         return true;
@@ -95,7 +165,7 @@ bool rb_tree_insert(t_rb_tree *tree, t_key key, void *value)
 bool rb_tree_find(t_rb_tree *tree, void *key, void **out)
 {
     t_rbt_node *aux;
-    bool res = find_node(tree->root, tree->comparator, key, &aux, NULL);
+    bool res = find_node(tree, key, &aux, NULL);
     if (res)
     {
         if (out)
@@ -136,14 +206,36 @@ bool rb_tree_remove_and_destroy(t_rb_tree *tree, void *key, void (*element_destr
     return true;
 }
 
-static bool find_node(t_rbt_node *root, t_comparator comparator, void *key, t_rbt_node **out, t_rbt_node **parent)
+// the switch is on a field fixed at creation, so the branch predicts perfectly and the
+// built-ins cost no call at all
+static int compare_keys(t_rb_tree *tree, const void *a, const void *b)
 {
-    t_rbt_node *current = root;
+    switch (tree->compare_kind)
+    {
+    case RB_TREE_COMPARE_INT:
+        return rb_tree_compare_int(a, b);
+    case RB_TREE_COMPARE_INT64:
+        return rb_tree_compare_int64(a, b);
+    case RB_TREE_COMPARE_STRING:
+        return strcmp(a, b);
+    case RB_TREE_COMPARE_THREE_WAY:
+        return tree->compare(a, b);
+    default:
+        if (tree->comparator((void *)a, (void *)b))
+            return -1;
+        return tree->comparator((void *)b, (void *)a);
+    }
+}
+
+static bool find_node(t_rb_tree *tree, void *key, t_rbt_node **out, t_rbt_node **parent)
+{
+    t_rbt_node *current = tree->root;
     t_rbt_node *prev = NULL;
 
     while (current)
     {
-        if (!comparator(key, current->key.data) && !comparator(current->key.data, key))
+        int order = compare_keys(tree, key, current->key);
+        if (order == 0)
         {
             if (out)
                 *out = current;
@@ -153,7 +245,7 @@ static bool find_node(t_rbt_node *root, t_comparator comparator, void *key, t_rb
         }
 
         prev = current;
-        if (comparator(key, current->key.data))
+        if (order < 0)
             current = current->left;
         else
             current = current->right;
@@ -175,18 +267,14 @@ bool rb_tree_is_empty(t_rb_tree *tree)
 
 static t_rbt_node *create_node(t_key key, void *value)
 {
-    t_rbt_node *node = malloc(sizeof(t_rbt_node));
+    t_rbt_node *node = malloc(sizeof(t_rbt_node) + key.size);
     if (!node)
         return NULL;
-    node->key.data = malloc(key.size);
-    if (!node->key.data)
-    {
-        free(node);
-        return NULL;
-    }
-    node->key.size = key.size;
-    memcpy(node->key.data, key.data, key.size);
+    node->key_size = key.size;
+    memcpy(node->key, key.data, key.size);
     node->color = RED;
+    node->in_block = false;
+    node->subtree_size = 1;
     node->value = value;
     node->right = node->parent = node->left = NULL;
     return node;
@@ -194,10 +282,8 @@ static t_rbt_node *create_node(t_key key, void *value)
 
 static void destroy_node(t_rbt_node *node)
 {
-    if (!node)
-        return;
-    free(node->key.data);
-    free(node);
+    if (!node->in_block)
+        free(node);
 }
 
 static void right_rotation(t_rb_tree *tree, t_rbt_node *x)
@@ -223,6 +309,9 @@ static void right_rotation(t_rb_tree *tree, t_rbt_node *x)
     }
     x->parent = y;
     y->right = x;
+    // y takes over x's subtree, x lost y and y's right subtree
+    y->subtree_size = x->subtree_size;
+    recount_subtree(x);
     tree->root->color = BLACK;
 }
 
@@ -249,6 +338,9 @@ static void left_rotation(t_rb_tree *tree, t_rbt_node *x)
     }
     y->left = x;
     x->parent = y;
+    // y takes over x's subtree, x lost y and y's left subtree
+    y->subtree_size = x->subtree_size;
+    recount_subtree(x);
     tree->root->color = BLACK;
 }
 
@@ -266,7 +358,7 @@ static t_rbt_node *insert_child(t_rb_tree *tree, t_rbt_node *parent, t_key key,
     }
 
     child->parent = parent;
-    if (tree->comparator(key.data, parent->key.data))
+    if (compare_keys(tree, key.data, parent->key) < 0)
     {
         parent->left = child;
     }
@@ -341,65 +433,17 @@ static void fix_insert(t_rb_tree *tree, t_rbt_node *node)
     tree->root->color = BLACK;
 }
 
-static t_rbt_node *rb_tree_delete_node(t_rb_tree *tree, void *key, t_rbt_node **out_replacer)
+// puts replacement, which may be NULL, where node hangs from its parent
+static void transplant(t_rb_tree *tree, t_rbt_node *node, t_rbt_node *replacement)
 {
-    t_rbt_node *node;
-    t_rbt_node *parent;
-    bool found = find_node(tree->root, tree->comparator, key, &node, &parent);
-    if (!found)
-        return NULL;
-
-    // case 1: node at most one child
-    if (!node->left || !node->right)
-    {
-        t_rbt_node *child = node->left ? node->left : node->right;
-        if (parent)
-        {
-            if (parent->right == node)
-                parent->right = child;
-            else
-                parent->left = child;
-        }
-        else
-        {
-            tree->root = child;
-        }
-        if (child)
-            child->parent = parent;
-        if (out_replacer)
-            *out_replacer = child;
-        return node;
-    }
-    // node has two children
+    if (!node->parent)
+        tree->root = replacement;
+    else if (node == node->parent->left)
+        node->parent->left = replacement;
     else
-    {
-        // Replace nodes key and content with its in-order successor
-
-        t_rbt_node *aux_parent = NULL;
-        t_rbt_node *r_sub_tree = node->right;
-        while (r_sub_tree->left)
-        {
-            aux_parent = r_sub_tree;
-            r_sub_tree = r_sub_tree->left;
-        }
-        if (aux_parent)
-            aux_parent->left = r_sub_tree->right;
-        else
-            node->right = r_sub_tree->right;
-
-        if (r_sub_tree->right)
-        {
-            r_sub_tree->right->parent = aux_parent ? aux_parent : node;
-        }
-        free(node->key.data);
-        node->key.size = r_sub_tree->key.size;
-        node->key.data = malloc(r_sub_tree->key.size);
-        memcpy(node->key.data, r_sub_tree->key.data, r_sub_tree->key.size);
-        node->value = r_sub_tree->value;
-        if (out_replacer)
-            *out_replacer = NULL;
-        return r_sub_tree;
-    }
+        node->parent->right = replacement;
+    if (replacement)
+        replacement->parent = node->parent;
 }
 
 static void fix_deletion(t_rb_tree *tree, t_rbt_node *node, t_rbt_node *parent)
@@ -490,24 +534,58 @@ static void fix_deletion(t_rb_tree *tree, t_rbt_node *node, t_rbt_node *parent)
         node->color = BLACK;
 }
 
+// unlinks the node of key and returns it. With two children its in-order successor is
+// relinked in its place: keys live inside their nodes and differ in size, so they never move
 static t_rbt_node *rb_tree_delete_and_fix(t_rb_tree *tree, void *key)
 {
-    t_rbt_node *replacer = NULL;
-    t_rbt_node *to_delete = rb_tree_delete_node(tree, key, &replacer);
-
-    if (!to_delete)
+    t_rbt_node *node;
+    if (!find_node(tree, key, &node, NULL))
         return NULL;
 
-    
-    if (to_delete->color == BLACK)
+    // the color leaving its place in the tree, and what takes that place
+    node_color removed_color = node->color;
+    t_rbt_node *replacer;
+    t_rbt_node *replacer_parent;
+    if (!node->left || !node->right)
     {
-        t_rbt_node *fix_parent = replacer ? replacer->parent : to_delete->parent;
-        fix_deletion(tree, replacer, fix_parent);
+        replacer = node->left ? node->left : node->right;
+        replacer_parent = node->parent;
+        transplant(tree, node, replacer);
+    }
+    else
+    {
+        t_rbt_node *successor = node->right;
+        while (successor->left)
+            successor = successor->left;
+        removed_color = successor->color;
+        replacer = successor->right;
+        if (successor->parent == node)
+        {
+            replacer_parent = successor;
+        }
+        else
+        {
+            replacer_parent = successor->parent;
+            transplant(tree, successor, successor->right);
+            successor->right = node->right;
+            successor->right->parent = successor;
+        }
+        transplant(tree, node, successor);
+        successor->left = node->left;
+        successor->left->parent = successor;
+        successor->color = node->color;
     }
 
+    // every subtree that lost a node hangs on the path from where the tree changed to the root
+    for (t_rbt_node *ancestor = replacer_parent; ancestor; ancestor = ancestor->parent)
+        recount_subtree(ancestor);
+
+    if (removed_color == BLACK)
+        fix_deletion(tree, replacer, replacer_parent);
+
     tree->size--;
 
-    return to_delete;
+    return node;
 }
 
 void rb_tree_iterate_preorder(t_rb_tree *tree, void (*iterator)(void *key, void *value))
@@ -521,7 +599,400 @@ static void rb_tree_inner_iterate_preorder(t_rbt_node *root, void (*iterator)(vo
 {
     if (!root)
         return;
-    iterator(root->key.data, root->value);
+    iterator(root->key, root->value);
     rb_tree_inner_iterate_preorder(root->left, iterator);
     rb_tree_inner_iterate_preorder(root->right, iterator);
 }
+
+void rb_tree_iterate_inorder(t_rb_tree *tree, void (*iterator)(void *key, void *value))
+{
+    for (t_rbt_node *node = leftmost(tree->root); node; node = successor(node))
+        iterator(node->key, node->value);
+}
+
+void rb_tree_range(t_rb_tree *tree, void *lo, void *hi, void (*iterator)(void *key, void *value))
+{
+    for (t_rbt_node *node = bound(tree, lo, false); node && compare_keys(tree, node->key, hi) <= 0; node = successor(node))
+        iterator(node->key, node->value);
+}
+
+t_rb_tree_cursor rb_tree_first(t_rb_tree *tree)
+{
+    return (t_rb_tree_cursor){tree, leftmost(tree->root)};
+}
+
+t_rb_tree_cursor rb_tree_last(t_rb_tree *tree)
+{
+    return (t_rb_tree_cursor){tree, rightmost(tree->root)};
+}
+
+t_rb_tree_cursor rb_tree_lower_bound(t_rb_tree *tree, void *key)
+{
+    return (t_rb_tree_cursor){tree, bound(tree, key, false)};
+}
+
+t_rb_tree_cursor rb_tree_upper_bound(t_rb_tree *tree, void *key)
+{
+    return (t_rb_tree_cursor){tree, bound(tree, key, true)};
+}
+
+bool rb_tree_cursor_is_end(t_rb_tree_cursor *cursor)
+{
+    return cursor->node == NULL;
+}
+
+void *rb_tree_cursor_key(t_rb_tree_cursor *cursor)
+{
+    return cursor->node ? cursor->node->key : NULL;
+}
+
+void *rb_tree_cursor_value(t_rb_tree_cursor *cursor)
+{
+    return cursor->node ? cursor->node->value : NULL;
+}
+
+bool rb_tree_cursor_next(t_rb_tree_cursor *cursor)
+{
+    if (!cursor->node)
+        return false;
+    cursor->node = successor(cursor->node);
+    return cursor->node != NULL;
+}
+
+bool rb_tree_cursor_prev(t_rb_tree_cursor *cursor)
+{
+    cursor->node = cursor->node ? predecessor(cursor->node) : rightmost(cursor->tree->root);
+    return cursor->node != NULL;
+}
+
+t_rb_tree_cursor rb_tree_select(t_rb_tree *tree, int k)
+{
+    t_rbt_node *current = tree->root;
+    if (k < 0 || k >= tree->size)
+        current = NULL;
+    while (current)
+    {
+        int left_size = subtree_size(current->left);
+        if (k == left_size)
+            break;
+        if (k < left_size)
+        {
+            current = current->left;
+        }
+        else
+        {
+            k -= left_size + 1;
+            current = current->right;
+        }
+    }
+    return (t_rb_tree_cursor){tree, current};
+}
+
+int rb_tree_rank(t_rb_tree *tree, void *key)
+{
+    int rank = 0;
+    t_rbt_node *current = tree->root;
+    while (current)
+    {
+        int order = compare_keys(tree, key, current->key);
+        if (order <= 0)
+        {
+            if (order == 0)
+                return rank + subtree_size(current->left);
+            current = current->left;
+        }
+        else
+        {
+            rank += subtree_size(current->left) + 1;
+            current = current->right;
+        }
+    }
+    return rank;
+}
+
+bool rb_tree_build_from_sorted(t_rb_tree *tree, t_key *keys, void **values, int n)
+{
+    if (!rb_tree_is_empty(tree))
+    {
+        fprintf(stderr, "Bulk load into the non empty tree %p", (void *)tree);
+        return false;
+    }
+    size_t bytes = 0;
+    for (int i = 0; i < n; i++)
+    {
+        if (i > 0 && compare_keys(tree, keys[i - 1].data, keys[i].data) >= 0)
+        {
+            fprintf(stderr, "Keys %d and %d out of order in a bulk load into tree %p", i - 1, i, (void *)tree);
+            return false;
+        }
+        bytes += node_stride(keys[i].size);
+    }
+    if (n <= 0)
+        return true;
+
+    t_rbt_node **nodes = malloc(n * sizeof(t_rbt_node *));
+    unsigned char *memory = nodes ? add_block(tree, bytes) : NULL;
+    if (!memory)
+    {
+        free(nodes);
+        return false;
+    }
+    for (int i = 0; i < n; i++)
+        nodes[i] = place_node(&memory, keys[i], values ? values[i] : NULL);
+    relink_sorted(tree, nodes, n);
+    free(nodes);
+    return true;
+}
+
+bool rb_tree_insert_batch(t_rb_tree *tree, t_key *keys, void **values, int n)
+{
+    if (n <= 0)
+        return true;
+    int *order = malloc(n * sizeof(int));
+    int *scratch = malloc(n * sizeof(int));
+    if (!order || !scratch)
+    {
+        free(order);
+        free(scratch);
+        return false;
+    }
+    for (int i = 0; i < n; i++)
+        order[i] = i;
+    sort_batch(tree, keys, order, scratch, n);
+
+    // the sort is stable, the last of a run of equal keys is the one given last
+    int unique = 0;
+    for (int i = 0; i < n; i++)
+    {
+        if (i + 1 < n && compare_keys(tree, keys[order[i]].data, keys[order[i + 1]].data) == 0)
+            continue;
+        order[unique++] = order[i];
+    }
+    free(scratch);
+
+    // a rebuild touches every node, log2(size) steps down per key is cheaper for a few keys
+    int height = 0;
+    while ((1 << height) <= tree->size && height < 30)
+        height++;
+    if ((long)unique * height < tree->size)
+    {
+        bool inserted = true;
+        for (int i = 0; inserted && i < unique; i++)
+            inserted = rb_tree_insert(tree, keys[order[i]], values ? values[order[i]] : NULL);
+        free(order);
+        return inserted;
+    }
+
+    // first pass merging the batch into the tree only finds out how much memory the new nodes take
+    t_rbt_node **nodes = malloc((tree->size + unique) * sizeof(t_rbt_node *));
+    size_t bytes = 0;
+    int added = 0;
+    t_rbt_node *old = leftmost(tree->root);
+    for (int i = 0; nodes && i < unique; i++)
+    {
+        t_key key = keys[order[i]];
+        while (old && compare_keys(tree, old->key, key.data) < 0)
+            old = successor(old);
+        if (!old || compare_keys(tree, old->key, key.data) != 0)
+        {
+            bytes += node_stride(key.size);
+            added++;
+        }
+    }
+    unsigned char *memory = nodes && added > 0 ? add_block(tree, bytes) : NULL;
+    if (!nodes || (added > 0 && !memory))
+    {
+        free(nodes);
+        free(order);
+        return false;
+    }
+
+    int count = 0;
+    old = leftmost(tree->root);
+    for (int i = 0; i < unique; i++)
+    {
+        t_key key = keys[order[i]];
+        void *value = values ? values[order[i]] : NULL;
+        int order_to_old = -1;
+        while (old && (order_to_old = compare_keys(tree, old->key, key.data)) < 0)
+        {
+            nodes[count++] = old;
+            old = successor(old);
+        }
+        if (old && order_to_old == 0)
+        {
+            old->value = value;
+            nodes[count++] = old;
+            old = successor(old);
+        }
+        else
+        {
+            nodes[count++] = place_node(&memory, key, value);
+        }
+    }
+    for (; old; old = successor(old))
+        nodes[count++] = old;
+
+    relink_sorted(tree, nodes, count);
+    free(nodes);
+    free(order);
+    return true;
+}
+
+static t_rbt_node *leftmost(t_rbt_node *node)
+{
+    while (node && node->left)
+        node = node->left;
+    return node;
+}
+
+static t_rbt_node *rightmost(t_rbt_node *node)
+{
+    while (node && node->right)
+        node = node->right;
+    return node;
+}
+
+// the leftmost of the right subtree, or else the first ancestor reached from its left side
+static t_rbt_node *successor(t_rbt_node *node)
+{
+    if (node->right)
+        return leftmost(node->right);
+    while (node->parent && node == node->parent->right)
+        node = node->parent;
+    return node->parent;
+}
+
+static t_rbt_node *predecessor(t_rbt_node *node)
+{
+    if (node->left)
+        return rightmost(node->left);
+    while (node->parent && node == node->parent->left)
+        node = node->parent;
+    return node->parent;
+}
+
+// first node whose key is not before key, or strictly after it
+static t_rbt_node *bound(t_rb_tree *tree, void *key, bool strict)
+{
+    t_rbt_node *found = NULL;
+    t_rbt_node *current = tree->root;
+    while (current)
+    {
+        int order = compare_keys(tree, current->key, key);
+        if (order > 0 || (order == 0 && !strict))
+        {
+            found = current;
+            current = current->left;
+        }
+        else
+        {
+            current = current->right;
+        }
+    }
+    return found;
+}
+
+static int subtree_size(t_rbt_node *node)
+{
+    return node ? node->subtree_size : 0;
+}
+
+// from its children, which must already be right
+static void recount_subtree(t_rbt_node *node)
+{
+    node->subtree_size = 1 + subtree_size(node->left) + subtree_size(node->right);
+}
+
+// a node and its key, rounded up so the node after it is aligned too
+static size_t node_stride(size_t key_size)
+{
+    size_t alignment = _Alignof(max_align_t);
+    return (sizeof(t_rbt_node) + key_size + alignment - 1) / alignment * alignment;
+}
+
+static unsigned char *add_block(t_rb_tree *tree, size_t bytes)
+{
+    struct rbt_block *block = malloc(sizeof(struct rbt_block) + bytes);
+    if (!block)
+        return NULL;
+    block->next = tree->blocks;
+    tree->blocks = block;
+    return block->nodes;
+}
+
+static void free_blocks(t_rb_tree *tree)
+{
+    while (tree->blocks)
+    {
+        struct rbt_block *next = tree->blocks->next;
+        free(tree->blocks);
+        tree->blocks = next;
+    }
+}
+
+// a node at memory, which then moves past it
+static t_rbt_node *place_node(unsigned char **memory, t_key key, void *value)
+{
+    t_rbt_node *node = (t_rbt_node *)*memory;
+    *memory += node_stride(key.size);
+    node->key_size = key.size;
+    memcpy(node->key, key.data, key.size);
+    node->value = value;
+    node->in_block = true;
+    return node;
+}
+
+// bottom up merge sort of the indexes of the keys, stable so a repeated key keeps the order
+// it was given in. qsort can not pass the tree to its comparator
+static void sort_batch(t_rb_tree *tree, t_key *keys, int *order, int *scratch, int n)
+{
+    for (int width = 1; width < n; width *= 2)
+    {
+        for (int lo = 0; lo < n; lo += 2 * width)
+        {
+            int mid = lo + width < n ? lo + width : n;
+            int hi = lo + 2 * width < n ? lo + 2 * width : n;
+            int left = lo, right = mid, out = lo;
+            while (left < mid && right < hi)
+            {
+                if (compare_keys(tree, keys[order[right]].data, keys[order[left]].data) < 0)
+                    scratch[out++] = order[right++];
+                else
+                    scratch[out++] = order[left++];
+            }
+            while (left < mid)
+                scratch[out++] = order[left++];
+            while (right < hi)
+                scratch[out++] = order[right++];
+        }
+        memcpy(order, scratch, n * sizeof(int));
+    }
+}
+
+// the middle node as the root and each half as a subtree, so the sizes of two siblings differ
+// by one at most and every empty link is on the last two levels. Making the nodes on
+// red_depth, the deepest one, red gives every path from the root the same black nodes
+static t_rbt_node *link_balanced(t_rbt_node **nodes, int n, t_rbt_node *parent, int depth, int red_depth)
+{
+    if (n <= 0)
+        return NULL;
+    int mid = n / 2;
+    t_rbt_node *node = nodes[mid];
+    node->parent = parent;
+    node->color = depth == red_depth && depth > 0 ? RED : BLACK;
+    node->subtree_size = n;
+    node->left = link_balanced(nodes, mid, node, depth + 1, red_depth);
+    node->right = link_balanced(nodes + mid + 1, n - mid - 1, node, depth + 1, red_depth);
+    return node;
+}
+
+// makes the tree out of the n nodes in ascending key order
+static void relink_sorted(t_rb_tree *tree, t_rbt_node **nodes, int n)
+{
+    int deepest = 0;
+    while ((2 << deepest) <= n)
+        deepest++;
+    tree->root = link_balanced(nodes, n, NULL, 0, deepest);
+    tree->size = n;
+}
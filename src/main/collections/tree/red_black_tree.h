@@ -2,7 +2,9 @@
 #define RED_BLACK_TREE_H_INCLUDED
 
 #include <stdlib.h>
+#include <stddef.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <string.h>
 #include <stdio.h>
 
@@ -14,31 +16,69 @@ typedef bool node_color;
 // same type as the key
 typedef bool (*t_comparator)(void *, void *);
 
+// negative, zero or positive as the first key goes before, equals or goes after the second
+typedef int (*t_three_way_comparator)(const void *, const void *);
+
+// how a tree compares keys, fixed at creation. The built-in comparators are recognised and
+// compared inline instead of through the function pointer
+typedef enum
+{
+    RB_TREE_COMPARE_LESS_THAN,
+    RB_TREE_COMPARE_THREE_WAY,
+    RB_TREE_COMPARE_INT,
+    RB_TREE_COMPARE_INT64,
+    RB_TREE_COMPARE_STRING
+} t_rb_tree_compare_kind;
+
 typedef struct
 {
     void *data;
     size_t size;
 } t_key;
 
+// one allocation per node: the key bytes are copied right after the links, so comparing
+// against a node reads the cache line its links were just read from
 typedef struct node
 {
-    t_key key;
     void *value;
-    node_color color;
     struct node *left;
     struct node *right;
     struct node *parent;
+    size_t key_size;
+    node_color color;
+    // placed in one of the tree's blocks by a bulk load, freed with the block and not by itself
+    bool in_block;
+    // nodes in the subtree rooted here, this one included. Fits in the padding before key
+    int subtree_size;
+    _Alignas(max_align_t) unsigned char key[];
 } t_rbt_node;
 
 typedef struct
 {
     int size;
     t_rbt_node *root;
+    // only one of them is set, depending on the create function
     t_comparator comparator;
+    t_three_way_comparator compare;
+    t_rb_tree_compare_kind compare_kind;
+    // the memory of the nodes bulk loads placed back to back, NULL until one runs
+    struct rbt_block *blocks;
 } t_rb_tree;
 
+// comparator is a less than, telling equal keys apart costs a second call
 t_rb_tree *rbt_tree_create(t_comparator comparator);
 
+// one call per node visited. Pass one of the built-ins below to have keys compared inline
+t_rb_tree *rbt_tree_create_with_cmp(t_three_way_comparator compare);
+
+// built-in comparators: int keys, int64_t keys and NUL terminated byte strings
+
+int rb_tree_compare_int(const void *a, const void *b);
+
+int rb_tree_compare_int64(const void *a, const void *b);
+
+int rb_tree_compare_string(const void *a, const void *b);
+
 int rb_tree_size(t_rb_tree *tree);
 
 bool rb_tree_is_empty(t_rb_tree *tree);
@@ -59,6 +99,71 @@ void rb_tree_clear(t_rb_tree *tree);
 
 void rb_tree_clear_and_destroy_elements(t_rb_tree *tree, void (*element_destroyer)(void *));
 
+// bulk loads. The nodes they create are laid out contiguously in one block per call, in key
+// order, which the tree keeps until it is cleared or destroyed: removing one of them does
+// not give its memory back on its own
+
+// fills the empty tree with the n keys, which must be in strictly ascending order, in O(n):
+// a perfectly balanced tree whose deepest level is red and every other one black. values
+// holds the value of every key or is NULL for none. False, with the tree still empty, when
+// the tree was not empty, the keys were out of order or there was no memory
+bool rb_tree_build_from_sorted(t_rb_tree *tree, t_key *keys, void **values, int n);
+
+// inserts the n keys in any order, as many rb_tree_insert calls would: a key already in the
+// tree, or repeated in the batch, gets the last value given for it. The batch is sorted and
+// merged with the tree, which is then rebuilt in O(n + size). A batch too small for that to
+// pay off goes in key by key. False when there was no memory, the tree is then unchanged
+// unless the batch was going in key by key, in which case the keys before stay inserted
+bool rb_tree_insert_batch(t_rb_tree *tree, t_key *keys, void **values, int n);
+
 void rb_tree_iterate_preorder(t_rb_tree* tree, void(*iterator)(void* key,void* value));
 
+// ascending key order
+void rb_tree_iterate_inorder(t_rb_tree *tree, void (*iterator)(void *key, void *value));
+
+// every key from lo to hi, both included, in ascending order. O(log n + k) for k keys
+void rb_tree_range(t_rb_tree *tree, void *lo, void *hi, void (*iterator)(void *key, void *value));
+
+// ordered cursors
+
+// a node of the tree, or the end past the last key when node is NULL. Moving walks the
+// parent links, no recursion and no stack. Nodes never move once inserted, so a cursor
+// stays valid through inserts and removes of other keys
+typedef struct
+{
+    t_rb_tree *tree;
+    t_rbt_node *node;
+} t_rb_tree_cursor;
+
+t_rb_tree_cursor rb_tree_first(t_rb_tree *tree);
+
+t_rb_tree_cursor rb_tree_last(t_rb_tree *tree);
+
+// at the first key not before key, the end if there is none
+t_rb_tree_cursor rb_tree_lower_bound(t_rb_tree *tree, void *key);
+
+// at the first key after key, the end if there is none
+t_rb_tree_cursor rb_tree_upper_bound(t_rb_tree *tree, void *key);
+
+// order statistics, O(log n) through the subtree sizes
+
+// at the k-th smallest key counting from 0, the end when k is out of range
+t_rb_tree_cursor rb_tree_select(t_rb_tree *tree, int k);
+
+// how many keys go before key, its index in ascending order when it is in the tree
+int rb_tree_rank(t_rb_tree *tree, void *key);
+
+bool rb_tree_cursor_is_end(t_rb_tree_cursor *cursor);
+
+void *rb_tree_cursor_key(t_rb_tree_cursor *cursor);
+
+void *rb_tree_cursor_value(t_rb_tree_cursor *cursor);
+
+// to the next key, false once it walked off the last one onto the end. The end stays there
+bool rb_tree_cursor_next(t_rb_tree_cursor *cursor);
+
+// to the previous key, false once it walked off the first one onto the end. From the end it
+// goes to the last key
+bool rb_tree_cursor_prev(t_rb_tree_cursor *cursor);
+
 #endif
@@ -0,0 +1,263 @@
+#include <sched.h>
+#include <unistd.h>
+#include "thread_pool.h"
+
+// grows on demand, big enough that a recursive split rarely needs to
+#define WORKER_DEQUE_CAPACITY 64
+
+// the worker running on this thread, NULL outside of every pool
+static _Thread_local t_pool_worker *current_worker;
+
+static void *worker_body(void *arg);
+static t_pool_worker *worker_of(t_thread_pool *pool);
+static t_task *find_task(t_thread_pool *pool, t_pool_worker *worker);
+static void run_task(t_thread_pool *pool, t_task *task);
+static void sleep_until_joined(t_thread_pool *pool, t_task_group *group);
+static void sleep_until_work(t_thread_pool *pool);
+static void destroy_workers(t_thread_pool *pool, int count);
+
+t_thread_pool *thread_pool_create(int worker_count)
+{
+    if (worker_count <= 0)
+        worker_count = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (worker_count <= 0)
+        worker_count = 1;
+
+    t_thread_pool *pool = malloc(sizeof(t_thread_pool));
+    if (!pool)
+        return NULL;
+    pool->workers = calloc(worker_count, sizeof(t_pool_worker));
+    pool->injected = blocking_queue_create();
+    if (!pool->workers || !pool->injected)
+    {
+        free(pool->workers);
+        if (pool->injected)
+            blocking_queue_destroy(pool->injected);
+        free(pool);
+        return NULL;
+    }
+    pool->worker_count = worker_count;
+    task_group_init(&pool->default_group);
+    atomic_init(&pool->queued, 0);
+    atomic_init(&pool->sleeping, 0);
+    atomic_init(&pool->shutting_down, false);
+    pthread_mutex_init(&pool->sleep_lock, NULL);
+    pthread_cond_init(&pool->wake_up, NULL);
+    atomic_init(&pool->joining, 0);
+    pthread_mutex_init(&pool->join_lock, NULL);
+    pthread_cond_init(&pool->group_done, NULL);
+
+    for (int i = 0; i < worker_count; i++)
+    {
+        t_pool_worker *worker = &pool->workers[i];
+        worker->pool = pool;
+        worker->random_state = i + 1;
+        worker->tasks = work_stealing_deque_create(WORKER_DEQUE_CAPACITY);
+        if (!worker->tasks)
+        {
+            destroy_workers(pool, i);
+            return NULL;
+        }
+    }
+    // every deque exists before the first worker may try to steal from it
+    for (int i = 0; i < worker_count; i++)
+    {
+        if (pthread_create(&pool->workers[i].thread, NULL, worker_body, &pool->workers[i]) != 0)
+        {
+            atomic_store(&pool->shutting_down, true);
+            for (int j = 0; j < i; j++)
+            {
+                pthread_mutex_lock(&pool->sleep_lock);
+                pthread_cond_broadcast(&pool->wake_up);
+                pthread_mutex_unlock(&pool->sleep_lock);
+                pthread_join(pool->workers[j].thread, NULL);
+            }
+            destroy_workers(pool, worker_count);
+            return NULL;
+        }
+    }
+    return pool;
+}
+
+int thread_pool_size(t_thread_pool *pool)
+{
+    return pool->worker_count;
+}
+
+void task_group_init(t_task_group *group)
+{
+    atomic_init(&group->pending, 0);
+}
+
+void thread_pool_spawn(t_thread_pool *pool, t_task_group *group, void (*function)(void *), void *argument)
+{
+    t_task *task = malloc(sizeof(t_task));
+    if (!task)
+    {
+        // nobody else can run it, at least the work gets done
+        function(argument);
+        return;
+    }
+    task->function = function;
+    task->argument = argument;
+    task->group = group;
+    atomic_fetch_add_explicit(&group->pending, 1, memory_order_relaxed);
+
+    // counted before it becomes visible, so no worker goes to sleep in between
+    atomic_fetch_add(&pool->queued, 1);
+    t_pool_worker *worker = worker_of(pool);
+    t_queue_error pushed = worker ? work_stealing_deque_push(worker->tasks, task)
+                                  : blocking_queue_push(pool->injected, task);
+    if (pushed != QUEUE_SUCCESS)
+    {
+        // no queue took it, so nobody else will ever run it or count it down
+        atomic_fetch_sub(&pool->queued, 1);
+        atomic_fetch_sub_explicit(&group->pending, 1, memory_order_relaxed);
+        free(task);
+        function(argument);
+        return;
+    }
+
+    if (atomic_load(&pool->sleeping) > 0)
+    {
+        pthread_mutex_lock(&pool->sleep_lock);
+        pthread_cond_signal(&pool->wake_up);
+        pthread_mutex_unlock(&pool->sleep_lock);
+    }
+}
+
+void thread_pool_join(t_thread_pool *pool, t_task_group *group)
+{
+    t_pool_worker *worker = worker_of(pool);
+    while (atomic_load_explicit(&group->pending, memory_order_acquire) > 0)
+    {
+        t_task *task = find_task(pool, worker);
+        if (task)
+            run_task(pool, task);
+        else if (worker)
+            sched_yield();
+        else
+            sleep_until_joined(pool, group);
+    }
+}
+
+void thread_pool_submit(t_thread_pool *pool, void (*function)(void *), void *argument)
+{
+    thread_pool_spawn(pool, &pool->default_group, function, argument);
+}
+
+void thread_pool_wait(t_thread_pool *pool)
+{
+    thread_pool_join(pool, &pool->default_group);
+}
+
+void thread_pool_destroy(t_thread_pool *pool)
+{
+    thread_pool_wait(pool);
+    atomic_store(&pool->shutting_down, true);
+    pthread_mutex_lock(&pool->sleep_lock);
+    pthread_cond_broadcast(&pool->wake_up);
+    pthread_mutex_unlock(&pool->sleep_lock);
+    for (int i = 0; i < pool->worker_count; i++)
+        pthread_join(pool->workers[i].thread, NULL);
+    destroy_workers(pool, pool->worker_count);
+}
+
+static void *worker_body(void *arg)
+{
+    t_pool_worker *worker = arg;
+    t_thread_pool *pool = worker->pool;
+    current_worker = worker;
+    while (!atomic_load(&pool->shutting_down))
+    {
+        t_task *task = find_task(pool, worker);
+        if (task)
+            run_task(pool, task);
+        else
+            sleep_until_work(pool);
+    }
+    return NULL;
+}
+
+static t_pool_worker *worker_of(t_thread_pool *pool)
+{
+    return current_worker && current_worker->pool == pool ? current_worker : NULL;
+}
+
+// own deque first, then the injection queue, then one round over the other workers
+static t_task *find_task(t_thread_pool *pool, t_pool_worker *worker)
+{
+    void *task = NULL;
+    bool found = (worker && work_stealing_deque_pop(worker->tasks, &task) == QUEUE_SUCCESS)
+              || blocking_queue_try_pop(pool->injected, &task) == QUEUE_SUCCESS;
+
+    unsigned int start = 0;
+    if (worker)
+    {
+        // xorshift, so thieves don't all go after the same victim
+        worker->random_state ^= worker->random_state << 13;
+        worker->random_state ^= worker->random_state >> 17;
+        worker->random_state ^= worker->random_state << 5;
+        start = worker->random_state;
+    }
+    for (int i = 0; !found && i < pool->worker_count; i++)
+    {
+        t_pool_worker *victim = &pool->workers[(start + i) % pool->worker_count];
+        found = victim != worker && work_stealing_deque_steal(victim->tasks, &task) == QUEUE_SUCCESS;
+    }
+
+    if (!found)
+        return NULL;
+    atomic_fetch_sub(&pool->queued, 1);
+    return task;
+}
+
+static void run_task(t_thread_pool *pool, t_task *task)
+{
+    t_task_group *group = task->group;
+    task->function(task->argument);
+    free(task);
+    // the group may be gone as soon as it reaches 0, so the wakeup goes through the pool.
+    // Pairs with sleep_until_joined: either it sees this joiner or the joiner sees the 0
+    if (atomic_fetch_sub(&group->pending, 1) == 1 && atomic_load(&pool->joining) > 0)
+    {
+        pthread_mutex_lock(&pool->join_lock);
+        pthread_cond_broadcast(&pool->group_done);
+        pthread_mutex_unlock(&pool->join_lock);
+    }
+}
+
+static void sleep_until_work(t_thread_pool *pool)
+{
+    pthread_mutex_lock(&pool->sleep_lock);
+    // pairs with spawn: either it sees this sleeper or this sees its task
+    atomic_fetch_add(&pool->sleeping, 1);
+    if (atomic_load(&pool->queued) == 0 && !atomic_load(&pool->shutting_down))
+        pthread_cond_wait(&pool->wake_up, &pool->sleep_lock);
+    atomic_fetch_sub(&pool->sleeping, 1);
+    pthread_mutex_unlock(&pool->sleep_lock);
+}
+
+// a thread outside the pool waiting for group, which it has no business spinning for
+static void sleep_until_joined(t_thread_pool *pool, t_task_group *group)
+{
+    pthread_mutex_lock(&pool->join_lock);
+    atomic_fetch_add(&pool->joining, 1);
+    while (atomic_load(&group->pending) > 0)
+        pthread_cond_wait(&pool->group_done, &pool->join_lock);
+    atomic_fetch_sub(&pool->joining, 1);
+    pthread_mutex_unlock(&pool->join_lock);
+}
+
+static void destroy_workers(t_thread_pool *pool, int count)
+{
+    for (int i = 0; i < count; i++)
+        work_stealing_deque_destroy(pool->workers[i].tasks);
+    free(pool->workers);
+    blocking_queue_destroy(pool->injected);
+    pthread_mutex_destroy(&pool->sleep_lock);
+    pthread_cond_destroy(&pool->wake_up);
+    pthread_mutex_destroy(&pool->join_lock);
+    pthread_cond_destroy(&pool->group_done);
+    free(pool);
+}
@@ -0,0 +1,77 @@
+#ifndef THREAD_POOL_H_INCLUDED
+#define THREAD_POOL_H_INCLUDED
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include "../collections/queue/work_stealing_deque.h"
+#include "../collections/queue/blocking_queue.h"
+
+// parallel collection operations cut their input in about this many pieces per worker,
+// enough for stealing to even out uneven elements without drowning in tiny tasks
+#define THREAD_POOL_CHUNKS_PER_WORKER 8
+
+// tasks spawned into a group can be waited for together, groups nest freely
+typedef struct{
+    atomic_int pending;
+} t_task_group;
+
+typedef struct{
+    void (*function)(void*);
+    void* argument;
+    t_task_group* group;
+} t_task;
+
+typedef struct{
+    pthread_t thread;
+    t_work_stealing_deque* tasks;
+    struct thread_pool* pool;
+    unsigned int random_state;
+} t_pool_worker;
+
+// Fork-join thread pool. Each worker owns a work stealing deque: tasks spawned from a worker
+// go to its own deque, which it drains newest first while the data is still in cache. Idle
+// workers steal the oldest task of a random victim, usually the biggest piece of work left.
+// Tasks spawned from other threads go through a shared injection queue
+typedef struct thread_pool{
+    int worker_count;
+    t_pool_worker* workers;
+    t_blocking_queue* injected;
+    // thread_pool_submit / thread_pool_wait use this one
+    t_task_group default_group;
+    // spawned and not taken by anyone yet, idle workers only sleep when it is 0
+    atomic_long queued;
+    atomic_int sleeping;
+    atomic_bool shutting_down;
+    pthread_mutex_t sleep_lock;
+    pthread_cond_t wake_up;
+    // threads outside the pool blocked in thread_pool_join, woken when any group reaches 0
+    atomic_int joining;
+    pthread_mutex_t join_lock;
+    pthread_cond_t group_done;
+} t_thread_pool;
+
+// worker_count <= 0 means one per online cpu
+t_thread_pool* thread_pool_create(int worker_count);
+
+int thread_pool_size(t_thread_pool* pool);
+
+void task_group_init(t_task_group* group);
+
+// runs function(argument) on some worker as part of group
+void thread_pool_spawn(t_thread_pool* pool, t_task_group* group, void (*function)(void*), void* argument);
+
+// returns once every task of group finished. Workers run pool tasks in the meantime, so tasks
+// may spawn and join groups of their own without starving the pool. Other threads help while
+// there is work to take, then sleep until the group is done
+void thread_pool_join(t_thread_pool* pool, t_task_group* group);
+
+void thread_pool_submit(t_thread_pool* pool, void (*function)(void*), void* argument);
+
+// waits for every task given to thread_pool_submit
+void thread_pool_wait(t_thread_pool* pool);
+
+// waits for submitted tasks, then stops the workers. Spawned groups must be joined before
+void thread_pool_destroy(t_thread_pool* pool);
+
+#endif
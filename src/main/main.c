@@ -3,9 +3,14 @@
 #include <CUnit/CUnit.h>
 #include "../test/collections/list/linked_list_test.h"
 #include "../test/collections/queue_stack/queue_stack_test.h"
+#include "../test/collections/queue_stack/concurrent_queue_test.h"
 #include "../test/collections/list/array_list_test.h"
+#include "../test/collections/list/unrolled_list_test.h"
 #include "../test/collections/map/hash_map_test.h"
+#include "../test/collections/map/concurrent_hash_map_test.h"
 #include "../test/collections/tree/rb_tree_test.h"
+#include "../test/collections/stream/stream_test.h"
+#include "../test/concurrency/thread_pool_test.h"
 
 
 
@@ -14,13 +19,19 @@ int main(void){
     CU_initialize_registry();
     CU_pSuite linked_list_suite = get_linked_list_suite();
     CU_pSuite stack_and_queue_suite = get_queue_stack_suite();
+    CU_pSuite concurrent_queue_suite = get_concurrent_queue_suite();
     CU_pSuite array_list_suite = get_array_list_suite();
+    CU_pSuite unrolled_list_suite = get_unrolled_list_suite();
     CU_pSuite hash_map_suite = get_hash_map_suite();
+    CU_pSuite concurrent_hash_map_suite = get_concurrent_hash_map_suite();
     CU_pSuite rb_tree_suite = get_rb_tree_suite();
+    CU_pSuite thread_pool_suite = get_thread_pool_suite();
+    CU_pSuite stream_suite = get_stream_suite();
 
     if(NULL  == linked_list_suite || NULL == stack_and_queue_suite
-    || NULL == array_list_suite || NULL == hash_map_suite
-    || NULL == rb_tree_suite){
+    || NULL == array_list_suite || NULL == unrolled_list_suite || NULL == hash_map_suite
+    || NULL == concurrent_hash_map_suite || NULL == concurrent_queue_suite
+    || NULL == rb_tree_suite || NULL == thread_pool_suite || NULL == stream_suite){
         return CU_get_error();
     }
     CU_basic_run_tests();
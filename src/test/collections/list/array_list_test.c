@@ -1,4 +1,14 @@
 #include "array_list_test.h"
+#include "../../../main/collections/list/typed_array_list.h"
+
+typedef struct
+{
+    int x;
+    int y;
+} t_point;
+
+DEFINE_ARRAY_LIST(int, int)
+DEFINE_ARRAY_LIST(t_point, point)
 
 static t_array_list *list;
 
@@ -134,6 +144,131 @@ static void test_array_list_remove_element(void)
     remove_random_ints();
 }
 
+static void double_int(int *n)
+{
+    *n *= 2;
+}
+
+static void test_typed_array_list(void)
+{
+    t_array_list_int *ints = array_list_int_create_with_capacity(2);
+    int out;
+
+    for (int i = 0; i < 100; i++)
+        array_list_int_add(ints, i);
+    CU_ASSERT_EQUAL(array_list_int_size(ints), 100);
+    CU_ASSERT(ints->capacity >= 100);
+
+    CU_ASSERT_EQUAL(array_list_int_add_to_index(ints, 0, -1), LIST_SUCCESS);
+    CU_ASSERT_EQUAL(array_list_int_add_to_index(ints, 102, 5), LIST_INDEX_OUT_OF_BOUNDS);
+    CU_ASSERT_EQUAL(array_list_int_remove(ints, 50, &out), LIST_SUCCESS);
+    CU_ASSERT_EQUAL(out, 49);
+    CU_ASSERT_EQUAL(array_list_int_get(ints, 100, &out), LIST_INDEX_OUT_OF_BOUNDS);
+
+    array_list_int_foreach(ints, double_int);
+    array_list_int_get(ints, 0, &out);
+    CU_ASSERT_EQUAL(out, -2);
+    array_list_int_get(ints, 99, &out);
+    CU_ASSERT_EQUAL(out, 198);
+
+    array_list_int_clean(ints);
+    CU_ASSERT_TRUE(array_list_int_is_empty(ints));
+    array_list_int_destroy(ints);
+
+    t_array_list_point *points = array_list_point_create();
+    t_point point;
+    CU_ASSERT_EQUAL(array_list_point_add(points, (t_point){1, 2}), LIST_SUCCESS);
+    array_list_point_add(points, (t_point){3, 4});
+    array_list_point_remove(points, 0, NULL);
+    array_list_point_get(points, 0, &point);
+    CU_ASSERT_EQUAL(point.x, 3);
+    CU_ASSERT_EQUAL(point.y, 4);
+    array_list_point_destroy(points);
+}
+
+static bool int_less_than(void *a, void *b)
+{
+    return *(int *)a < *(int *)b;
+}
+
+// 0 when self holds exactly values in ascending order
+static int count_unsorted(t_array_list *self, int *values, int count)
+{
+    int errors = array_list_size(self) != (unsigned int)count;
+    long long sum = 0;
+    for (int i = 0; i < count; i++)
+    {
+        sum += *(int *)self->array[i] - values[i];
+        if (i > 0)
+            errors += int_less_than(self->array[i], self->array[i - 1]);
+    }
+    return errors + (sum != 0);
+}
+
+static void test_array_list_sort(void)
+{
+    t_array_list *sorted = array_list_create();
+    int count = 20000;
+    int *values = malloc(count * sizeof(int));
+
+    // random with duplicates, ascending, descending, all equal and organ pipe
+    for (int pattern = 0; pattern < 5; pattern++)
+    {
+        array_list_clean(sorted);
+        for (int i = 0; i < count; i++)
+        {
+            int value[] = {(int)((i * 2654435761u) % 5000), i, count - i, 7, i < count / 2 ? i : count - i};
+            values[i] = value[pattern];
+            array_list_add(sorted, &values[i]);
+        }
+        array_list_sort(sorted, int_less_than);
+        CU_ASSERT_EQUAL(count_unsorted(sorted, values, count), 0);
+    }
+
+    // around the insertion sort threshold
+    for (int size = 0; size < 40; size++)
+    {
+        array_list_clean(sorted);
+        for (int i = 0; i < size; i++)
+        {
+            values[i] = (i * 37) % 11;
+            array_list_add(sorted, &values[i]);
+        }
+        array_list_sort(sorted, int_less_than);
+        CU_ASSERT_EQUAL(count_unsorted(sorted, values, size), 0);
+    }
+    array_list_destroy(sorted);
+    free(values);
+}
+
+static bool int_at_most(void *a, void *b)
+{
+    return *(int *)a <= *(int *)b;
+}
+
+// a comparator that is not strict must not send the partition scans out of the array
+static void test_array_list_sort_non_strict_comparator(void)
+{
+    t_array_list *sorted = array_list_create();
+    int count = 5000;
+    int *values = malloc(count * sizeof(int));
+
+    // all equal, then few distinct values
+    for (int pattern = 0; pattern < 2; pattern++)
+    {
+        array_list_clean(sorted);
+        for (int i = 0; i < count; i++)
+        {
+            values[i] = pattern == 0 ? 7 : (int)((i * 2654435761u) % 3);
+            array_list_add(sorted, &values[i]);
+        }
+        array_list_sort(sorted, int_at_most);
+        CU_ASSERT_EQUAL(count_unsorted(sorted, values, count), 0);
+    }
+    array_list_destroy(sorted);
+    free(values);
+}
+
 CU_pSuite get_array_list_suite(void)
 {
     CU_pSuite suite = CU_add_suite("Array list suite", init_suite, clean_suite);
@@ -142,5 +277,8 @@ CU_pSuite get_array_list_suite(void)
     CU_add_test(suite, "Test of array list add to and index with resizing", test_array_list_resizing);
     CU_add_test(suite, "Test of array list remove by index", test_array_list_remove);
     CU_add_test(suite, "Test of array list remove by element", test_array_list_remove_element);
+    CU_add_test(suite, "Test of typed array list", test_typed_array_list);
+    CU_add_test(suite, "Test of array list sort", test_array_list_sort);
+    CU_add_test(suite, "Test of array list sort with a less or equal comparator", test_array_list_sort_non_strict_comparator);
     return suite;
 }
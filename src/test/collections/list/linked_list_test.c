@@ -537,6 +537,288 @@ static int destroy_linked_list(void)
     return 0;
 }
 
+static void test_linked_list_node_pool(void)
+{
+    t_linked_list *own = linked_list_create();
+    CU_ASSERT_TRUE(own->owns_pool);
+
+    for (int i = 0; i < 1000; i++)
+        linked_list_add(own, &i);
+    t_node_pool_slab *slabs = own->pool->slabs;
+
+    // released nodes are reused before the pool grows
+    for (int i = 0; i < 10; i++)
+        linked_list_remove(own, 0, NULL);
+    for (int i = 0; i < 10; i++)
+        linked_list_add_first(own, &i);
+    CU_ASSERT_PTR_EQUAL(own->pool->slabs, slabs);
+    CU_ASSERT_PTR_NULL(own->pool->free_nodes);
+
+    // clean hands every node back at once and keeps a single slab
+    linked_list_clean(own);
+    CU_ASSERT_EQUAL(linked_list_size(own), 0);
+    CU_ASSERT_PTR_NULL(own->pool->slabs->next);
+    add_random_elements(own);
+    CU_ASSERT_EQUAL(*(int *)own->tail->data, 1);
+    remove_random_elements(own);
+    linked_list_destroy(own);
+}
+
+static void test_linked_list_shared_node_pool(void)
+{
+    t_node_pool *pool = node_pool_create();
+    t_linked_list *a = linked_list_create_with_pool(pool);
+    t_linked_list *b = linked_list_create_with_pool(pool);
+    int *buffer;
+
+    add_random_elements(a);
+    add_random_elements(b);
+    linked_list_remove_and_destroy(a, 1, free);
+    linked_list_add(b, malloc(sizeof(int)));
+
+    // cleaning one list must leave the nodes of the other alone
+    remove_random_elements(a);
+    CU_ASSERT_EQUAL(linked_list_size(b), 4);
+    linked_list_get(b, 2, (void **)&buffer);
+    CU_ASSERT_EQUAL(*buffer, 1);
+
+    linked_list_destroy(a);
+    linked_list_destroy_and_destroy_elements(b, free);
+    node_pool_destroy(pool);
+}
+
+// sorted by key only, index tells equal keys apart to check stability
+typedef struct
+{
+    int key;
+    int index;
+} t_sort_item;
+
+static bool compare_sort_items(void *a, void *b)
+{
+    return ((t_sort_item *)a)->key < ((t_sort_item *)b)->key;
+}
+
+static int count_sort_errors(t_linked_list *sorted)
+{
+    int errors = 0;
+    t_double_l_node *previous = NULL;
+    for (t_double_l_node *node = sorted->head; node; node = node->next)
+    {
+        errors += node->prev != previous;
+        if (previous)
+        {
+            t_sort_item *a = previous->data;
+            t_sort_item *b = node->data;
+            errors += a->key > b->key || (a->key == b->key && a->index > b->index);
+        }
+        previous = node;
+    }
+    return errors + (sorted->tail != previous);
+}
+
+static void test_linked_list_sort_big_and_stable(void)
+{
+    // the old recursive merge sort blew the stack long before this
+    int count = 300000;
+    t_sort_item *items = malloc(count * sizeof(t_sort_item));
+    t_linked_list *by_array = linked_list_create();
+    t_linked_list *in_place = linked_list_create();
+    for (int i = 0; i < count; i++)
+    {
+        items[i] = (t_sort_item){(int)((i * 2654435761u) % 1000), i};
+        linked_list_add(by_array, &items[i]);
+        linked_list_add(in_place, &items[i]);
+    }
+
+    linked_list_sort(by_array, compare_sort_items);
+    linked_list_sort_in_place(in_place, compare_sort_items);
+    CU_ASSERT_EQUAL(linked_list_size(by_array), count);
+    CU_ASSERT_EQUAL(count_sort_errors(by_array), 0);
+    CU_ASSERT_EQUAL(count_sort_errors(in_place), 0);
+
+    // sizes around the run length and both sort paths
+    for (int size = 0; size < 40; size++)
+    {
+        linked_list_clean(by_array);
+        linked_list_clean(in_place);
+        for (int i = 0; i < size; i++)
+        {
+            linked_list_add(by_array, &items[i]);
+            linked_list_add(in_place, &items[i]);
+        }
+        linked_list_sort(by_array, compare_sort_items);
+        linked_list_sort_in_place(in_place, compare_sort_items);
+        CU_ASSERT_EQUAL(count_sort_errors(by_array), 0);
+        CU_ASSERT_EQUAL(count_sort_errors(in_place), 0);
+    }
+
+    linked_list_destroy(by_array);
+    linked_list_destroy(in_place);
+    free(items);
+}
+
+static int removal_target;
+
+static bool is_removal_target(void *value)
+{
+    return *(int *)value == removal_target;
+}
+
+static bool int_less_than(void *a, void *b)
+{
+    return *(int *)a < *(int *)b;
+}
+
+// mismatches between an indexed list and the array list it should equal, read through
+// positional gets so every one goes through the index
+static int count_index_errors(t_linked_list *indexed, t_array_list *oracle)
+{
+    int errors = linked_list_size(indexed) != (int)array_list_size(oracle);
+    for (int i = 0; !errors && i < linked_list_size(indexed); i++)
+    {
+        void *value;
+        errors += linked_list_get(indexed, i, &value) != LIST_SUCCESS || value != oracle->array[i];
+    }
+    return errors;
+}
+
+static void test_linked_list_index(void)
+{
+    int count = 4000;
+    int *values = malloc(count * sizeof(int));
+    for (int i = 0; i < count; i++)
+        values[i] = (int)((i * 2654435761u) % 100000);
+    t_linked_list *indexed = linked_list_create();
+    t_array_list *oracle = array_list_create();
+    for (int i = 0; i < 100; i++)
+    {
+        linked_list_add(indexed, &values[i]);
+        array_list_add(oracle, &values[i]);
+    }
+    CU_ASSERT_TRUE(linked_list_enable_index(indexed));
+    CU_ASSERT_TRUE(linked_list_is_indexed(indexed));
+
+    unsigned int random = 12345;
+    int next_value = 100;
+    int errors = 0;
+    for (int step = 0; step < 20000; step++)
+    {
+        random = random * 1103515245u + 12345u;
+        int size = linked_list_size(indexed);
+        int position = size > 0 ? (int)((random >> 8) % size) : 0;
+        void *removed, *expected;
+        switch ((random >> 4) % 8)
+        {
+        case 0:
+        case 1:
+            if (next_value == count)
+                break;
+            linked_list_add_to_index(indexed, position, &values[next_value]);
+            // the list appends when asked for the position of its last element
+            if (position == size - 1 && position > 0)
+                array_list_add(oracle, &values[next_value]);
+            else
+                array_list_add_to_index(oracle, position, &values[next_value]);
+            next_value++;
+            break;
+        case 2:
+            if (next_value == count)
+                break;
+            if (random & 0x10000)
+            {
+                linked_list_add_first(indexed, &values[next_value]);
+                array_list_add_to_index(oracle, 0, &values[next_value]);
+            }
+            else
+            {
+                linked_list_add(indexed, &values[next_value]);
+                array_list_add(oracle, &values[next_value]);
+            }
+            next_value++;
+            break;
+        case 3:
+        case 4:
+            if (size == 0)
+                break;
+            linked_list_remove(indexed, position, &removed);
+            array_list_remove(oracle, position, &expected);
+            errors += removed != expected;
+            break;
+        case 5:
+            if (size == 0)
+                break;
+            removal_target = *(int *)oracle->array[position];
+            linked_list_remove_by_condition(indexed, is_removal_target, &removed);
+            // values repeat, the first equal one goes
+            position = 0;
+            while (*(int *)oracle->array[position] != removal_target)
+                position++;
+            array_list_remove(oracle, position, &expected);
+            errors += removed != expected;
+            break;
+        case 6:
+            if (size == 0)
+                break;
+            linked_list_set(indexed, position, &values[count - 1 - position], &removed);
+            errors += removed != oracle->array[position];
+            oracle->array[position] = &values[count - 1 - position];
+            break;
+        default:
+            if (size == 0)
+                break;
+            linked_list_get(indexed, position, &removed);
+            errors += removed != oracle->array[position];
+            break;
+        }
+        if (step % 1000 == 0)
+            errors += count_index_errors(indexed, oracle);
+    }
+    CU_ASSERT_EQUAL(errors, 0);
+    CU_ASSERT_EQUAL(count_index_errors(indexed, oracle), 0);
+
+    // bulk operations
+    t_linked_list *slice = linked_list_slice_and_remove(indexed, 10, 50);
+    for (int i = 0; i < 50; i++)
+        array_list_remove(oracle, 10, NULL);
+    CU_ASSERT_EQUAL(count_index_errors(indexed, oracle), 0);
+    linked_list_add_all(slice, indexed);
+    for (t_double_l_node *node = slice->head; node; node = node->next)
+        array_list_add(oracle, node->data);
+    CU_ASSERT_EQUAL(count_index_errors(indexed, oracle), 0);
+    linked_list_sort(indexed, int_less_than);
+    array_list_sort(oracle, int_less_than);
+    CU_ASSERT_EQUAL(count_index_errors(indexed, oracle), 0);
+    linked_list_add(indexed, &values[0]);
+    array_list_add(oracle, &values[0]);
+    linked_list_sort_in_place(indexed, int_less_than);
+    array_list_sort(oracle, int_less_than);
+    // equal values may be ordered apart, compare what they point at
+    int mismatches = 0;
+    for (int i = 0; i < linked_list_size(indexed); i++)
+    {
+        void *value;
+        linked_list_get(indexed, i, &value);
+        mismatches += *(int *)value != *(int *)oracle->array[i];
+    }
+    CU_ASSERT_EQUAL(mismatches, 0);
+
+    linked_list_clean(indexed);
+    CU_ASSERT_TRUE(linked_list_is_indexed(indexed));
+    linked_list_add(indexed, &values[1]);
+    linked_list_add_first(indexed, &values[2]);
+    void *first;
+    linked_list_get(indexed, 0, &first);
+    CU_ASSERT_PTR_EQUAL(first, &values[2]);
+    linked_list_disable_index(indexed);
+    CU_ASSERT_FALSE(linked_list_is_indexed(indexed));
+
+    linked_list_destroy(slice);
+    linked_list_destroy(indexed);
+    array_list_destroy(oracle);
+    free(values);
+}
+
 CU_pSuite get_linked_list_suite(void)
 {
     CU_pSuite suite = CU_add_suite("Linked list suite", init_linked_list, destroy_linked_list);
@@ -560,7 +842,9 @@ CU_pSuite get_linked_list_suite(void)
     CU_add_test(suite, "test of linked_list_filter()", test_linked_list_filter);
     CU_add_test(suite, "test of linked_list_map()", test_linked_list_map);
     CU_add_test(suite, "test of linked_list_sort()", test_linked_list_sort);
+    CU_add_test(suite, "test of linked_list_sort() on big lists and equal keys", test_linked_list_sort_big_and_stable);
     CU_add_test(suite, "test of linked_list_sorted()", test_linked_list_sorted);
+    CU_add_test(suite, "test of the linked list skip list index against an array list", test_linked_list_index);
     CU_add_test(suite, "test of linked_list_add_sorted()", test_linked_list_add_sorted);
     CU_add_test(suite, "test of linked_list_slice()", test_linked_list_slice);
     CU_add_test(suite, "test of linked_list_slice_and_remove()", test_linked_list_slice_and_remove);
@@ -569,5 +853,7 @@ CU_pSuite get_linked_list_suite(void)
     CU_add_test(suite, "test of linked_list_foldl()", test_linked_list_foldl);
     CU_add_test(suite, "test of linked_list_foldl1()", test_linked_list_foldl1);
     CU_add_test(suite, "test of linked_list_foldr()", test_linked_list_foldr);
+    CU_add_test(suite, "test of linked list node pool", test_linked_list_node_pool);
+    CU_add_test(suite, "test of linked lists sharing a node pool", test_linked_list_shared_node_pool);
     return suite;
 }
@@ -0,0 +1,187 @@
+#include <stdint.h>
+#include "unrolled_list_test.h"
+
+#define OPERATIONS 20000
+
+static t_unrolled_list *list;
+
+static int init_suite(void)
+{
+    list = unrolled_list_create();
+    return 0;
+}
+
+static int clean_suite(void)
+{
+    unrolled_list_destroy(list);
+    return 0;
+}
+
+static bool is_even(void *x)
+{
+    return *(int *)x % 2 == 0;
+}
+
+static void *twice(void *x)
+{
+    int *result = malloc(sizeof(int));
+    *result = *(int *)x * 2;
+    return result;
+}
+
+// folds keep a running int in the seed
+static void *sum(void *acc, void *x)
+{
+    *(int *)acc += *(int *)x;
+    return acc;
+}
+
+// max(a, b) on the element pointers themselves, both orders give the same answer
+static void *bigger(void *a, void *b)
+{
+    return *(int *)a > *(int *)b ? a : b;
+}
+
+static void *subtract_right(void *x, void *acc)
+{
+    *(int *)acc = *(int *)x - *(int *)acc;
+    return acc;
+}
+
+// every element keeps its index in the list, nodes fill up and split
+static void test_unrolled_list_add_and_get(void)
+{
+    int values[100];
+    int *out;
+
+    for (int i = 0; i < 100; i++)
+    {
+        values[i] = i;
+        unrolled_list_add(list, &values[i]);
+    }
+    CU_ASSERT_EQUAL(unrolled_list_size(list), 100);
+    for (int i = 0; i < 100; i++)
+    {
+        CU_ASSERT_EQUAL(unrolled_list_get(list, i, (void **)&out), LIST_SUCCESS);
+        CU_ASSERT_EQUAL(*out, i);
+    }
+    CU_ASSERT_EQUAL(unrolled_list_get(list, 100, (void **)&out), LIST_INDEX_OUT_OF_BOUNDS);
+    CU_ASSERT_EQUAL(unrolled_list_get(list, -1, (void **)&out), LIST_INDEX_OUT_OF_BOUNDS);
+    CU_ASSERT_EQUAL(unrolled_list_add_to_index(list, 101, &values[0]), LIST_INDEX_OUT_OF_BOUNDS);
+    CU_ASSERT_EQUAL(unrolled_list_index_of(list, &values[42]), 42);
+    CU_ASSERT_EQUAL(unrolled_list_index_of(list, list), -1);
+
+    unrolled_list_add_first(list, &values[99]);
+    CU_ASSERT_EQUAL(unrolled_list_get(list, 0, (void **)&out), LIST_SUCCESS);
+    CU_ASSERT_EQUAL(*out, 99);
+    CU_ASSERT_EQUAL(unrolled_list_set(list, 50, &values[0], (void **)&out), LIST_SUCCESS);
+    CU_ASSERT_EQUAL(*out, 49);
+    unrolled_list_clean(list);
+    CU_ASSERT_TRUE(unrolled_list_is_empty(list));
+}
+
+static void test_unrolled_list_higher_order(void)
+{
+    int values[30];
+    for (int i = 0; i < 30; i++)
+    {
+        values[i] = i + 1;
+        unrolled_list_add(list, &values[i]);
+    }
+
+    t_unrolled_list *evens = unrolled_list_filter(list, is_even);
+    CU_ASSERT_EQUAL(unrolled_list_size(evens), 15);
+    CU_ASSERT_TRUE(unrolled_list_all_satisfy(evens, is_even));
+    CU_ASSERT_EQUAL(unrolled_list_count(list, is_even), 15);
+    CU_ASSERT_TRUE(unrolled_list_any_satisfy(list, is_even));
+
+    t_unrolled_list *doubled = unrolled_list_map(list, twice);
+    CU_ASSERT_TRUE(unrolled_list_all_satisfy(doubled, is_even));
+    int total = 0;
+    unrolled_list_foldl(doubled, &total, sum);
+    CU_ASSERT_EQUAL(total, 30 * 31);
+
+    CU_ASSERT_EQUAL(*(int *)unrolled_list_foldl1(list, bigger), 30);
+    CU_ASSERT_EQUAL(*(int *)unrolled_list_foldr1(list, bigger), 30);
+    // 1 - (2 - (3 - ... (30 - 0))) = -15
+    int right = 0;
+    unrolled_list_foldr(list, &right, subtract_right);
+    CU_ASSERT_EQUAL(right, -15);
+
+    int *found;
+    CU_ASSERT_EQUAL(unrolled_list_remove_by_condition(list, is_even, (void **)&found), LIST_SUCCESS);
+    CU_ASSERT_EQUAL(*found, 2);
+    CU_ASSERT_EQUAL(unrolled_list_find(list, is_even, (void **)&found), LIST_SUCCESS);
+    CU_ASSERT_EQUAL(*found, 4);
+
+    unrolled_list_destroy(evens);
+    unrolled_list_destroy_and_destroy_elements(doubled, free);
+    unrolled_list_clean(list);
+}
+
+// random inserts, removes and sets against an array list doing the same
+static void test_unrolled_list_against_array_list(void)
+{
+    t_array_list *oracle = array_list_create();
+    unsigned int random_state = 7;
+    int mismatches = 0;
+
+    for (uintptr_t i = 1; i <= OPERATIONS; i++)
+    {
+        random_state = random_state * 1103515245 + 12345;
+        unsigned int choice = (random_state >> 16) % 10;
+        int size = unrolled_list_size(list);
+        int index = size ? (int)((random_state >> 4) % (size + 1)) : 0;
+        void *out = NULL, *expected = NULL;
+
+        if (choice < 5 || size == 0)
+        {
+            unrolled_list_add_to_index(list, index, (void *)i);
+            array_list_add_to_index(oracle, index, (void *)i);
+        }
+        else if (choice < 9)
+        {
+            index %= size;
+            unrolled_list_remove(list, index, &out);
+            array_list_remove(oracle, index, &expected);
+            mismatches += out != expected;
+        }
+        else
+        {
+            index %= size;
+            unrolled_list_set(list, index, (void *)i, &out);
+            array_list_get(oracle, index, &expected);
+            oracle->array[index] = (void *)i;
+            mismatches += out != expected;
+        }
+    }
+
+    mismatches += unrolled_list_size(list) != (int)array_list_size(oracle);
+    int index = 0;
+    for (t_unrolled_node *node = list->head; node; node = node->next)
+    {
+        // no empty nodes, back links intact
+        mismatches += node->count == 0 || (node->next && node->next->prev != node);
+        for (int i = 0; i < node->count; i++)
+            mismatches += node->elements[i] != oracle->array[index++];
+    }
+    for (int i = 0; i < unrolled_list_size(list); i += 97)
+    {
+        void *out;
+        unrolled_list_get(list, i, &out);
+        mismatches += out != oracle->array[i];
+    }
+    CU_ASSERT_EQUAL(mismatches, 0);
+
+    array_list_destroy(oracle);
+    unrolled_list_clean(list);
+}
+
+CU_pSuite get_unrolled_list_suite(void)
+{
+    CU_pSuite suite = CU_add_suite("Unrolled list suite", init_suite, clean_suite);
+    CU_add_test(suite, "Test of unrolled list add and get", test_unrolled_list_add_and_get);
+    CU_add_test(suite, "Test of unrolled list filter, map and folds", test_unrolled_list_higher_order);
+    CU_add_test(suite, "Test of unrolled list against an array list", test_unrolled_list_against_array_list);
+    return suite;
+}
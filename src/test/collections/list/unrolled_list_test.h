@@ -0,0 +1,11 @@
+#ifndef UNROLLED_LIST_TEST_H_INCLUDED
+#define UNROLLED_LIST_TEST_H_INCLUDED
+
+#include <CUnit/Basic.h>
+#include <CUnit/CUnit.h>
+#include "../../../main/collections/list/unrolled_list.h"
+#include "../../../main/collections/list/array_list.h"
+
+CU_pSuite get_unrolled_list_suite(void);
+
+#endif
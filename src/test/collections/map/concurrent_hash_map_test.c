@@ -0,0 +1,153 @@
+
+#include "concurrent_hash_map_test.h"
+
+#define THREADS 8
+#define KEYS_PER_THREAD 5000
+
+static t_concurrent_hash_map* map;
+static int factory_calls;
+static pthread_mutex_t factory_calls_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+typedef struct{
+    int thread_index;
+} t_worker_args;
+
+static void* put_and_remove_worker(void* arg){
+    t_worker_args* args = arg;
+    char key[32];
+    for(int i = 0; i < KEYS_PER_THREAD; i++){
+        sprintf(key,"%d:%d",args->thread_index,i);
+        int* x = malloc(sizeof(int));
+        *x = i;
+        concurrent_hash_map_put(map,key,x);
+    }
+    // drop the odd keys again, readers of other stripes must never notice
+    for(int i = 1; i < KEYS_PER_THREAD; i += 2){
+        sprintf(key,"%d:%d",args->thread_index,i);
+        concurrent_hash_map_remove_and_destroy_element(map,key,free);
+    }
+    return NULL;
+}
+
+static void test_concurrent_hash_map_put_and_remove(void){
+    pthread_t threads[THREADS];
+    t_worker_args args[THREADS];
+
+    for(int i = 0; i < THREADS; i++){
+        args[i].thread_index = i;
+        pthread_create(&threads[i],NULL,put_and_remove_worker,&args[i]);
+    }
+    for(int i = 0; i < THREADS; i++)
+        pthread_join(threads[i],NULL);
+
+    CU_ASSERT_EQUAL(concurrent_hash_map_size(map),THREADS * KEYS_PER_THREAD / 2);
+
+    char key[32];
+    for(int t = 0; t < THREADS; t++){
+        for(int i = 0; i < KEYS_PER_THREAD; i++){
+            sprintf(key,"%d:%d",t,i);
+            int* x = concurrent_hash_map_get(map,key);
+            if(i % 2){
+                CU_ASSERT_PTR_NULL(x);
+            }
+            else{
+                CU_ASSERT_PTR_NOT_NULL_FATAL(x);
+                CU_ASSERT_EQUAL(*x,i);
+            }
+        }
+    }
+
+    concurrent_hash_map_clean_and_destroy_elements(map,free);
+    CU_ASSERT_EQUAL(concurrent_hash_map_size(map),0);
+}
+
+static void* counting_factory(char* key){
+    pthread_mutex_lock(&factory_calls_mutex);
+    factory_calls++;
+    pthread_mutex_unlock(&factory_calls_mutex);
+    return strdup(key);
+}
+
+// CUnit asserts are not thread safe, workers only count what went wrong
+static void* compute_if_absent_worker(void* arg){
+    int* mismatches = arg;
+    char key[16];
+    // every thread races for the same keys
+    for(int i = 0; i < KEYS_PER_THREAD; i++){
+        sprintf(key,"%d",i);
+        char* value = concurrent_hash_map_compute_if_absent(map,key,counting_factory);
+        if(strcmp(value,key) != 0) (*mismatches)++;
+    }
+    return NULL;
+}
+
+static void test_concurrent_hash_map_compute_if_absent(void){
+    pthread_t threads[THREADS];
+    int mismatches[THREADS] = {0};
+    factory_calls = 0;
+
+    for(int i = 0; i < THREADS; i++)
+        pthread_create(&threads[i],NULL,compute_if_absent_worker,&mismatches[i]);
+    for(int i = 0; i < THREADS; i++){
+        pthread_join(threads[i],NULL);
+        CU_ASSERT_EQUAL(mismatches[i],0);
+    }
+
+    CU_ASSERT_EQUAL(factory_calls,KEYS_PER_THREAD);
+    CU_ASSERT_EQUAL(concurrent_hash_map_size(map),KEYS_PER_THREAD);
+
+    concurrent_hash_map_clean_and_destroy_elements(map,free);
+}
+
+static int values_total;
+
+static void add_to_total(char* key, void* data){
+    (void) key;
+    values_total += *(int*)data;
+}
+
+static void test_concurrent_hash_map_with_options(void){
+    t_concurrent_hash_map* other = concurrent_hash_map_create_with_options((t_concurrent_hash_map_options){
+        .stripe_count = 5,
+        .map_options = {.type = HASH_MAP_SWISS_TABLE, .incremental_rehash = true}
+    });
+    CU_ASSERT_EQUAL(other->stripe_count,8);
+    CU_ASSERT_FALSE(other->stripes[0].map->incremental_rehash);
+
+    char key[16];
+    for(int i = 0; i < 1000; i++){
+        sprintf(key,"%d",i);
+        int* x = malloc(sizeof(int));
+        *x = 1;
+        concurrent_hash_map_put(other,key,x);
+    }
+    values_total = 0;
+    concurrent_hash_map_iterate(other,add_to_total);
+    CU_ASSERT_EQUAL(values_total,1000);
+
+    int* removed = concurrent_hash_map_remove(other,"10");
+    CU_ASSERT_PTR_NOT_NULL_FATAL(removed);
+    free(removed);
+    CU_ASSERT_PTR_NULL(concurrent_hash_map_get(other,"10"));
+    CU_ASSERT_EQUAL(concurrent_hash_map_size(other),999);
+
+    concurrent_hash_map_destroy_and_destroy_elements(other,free);
+}
+
+static int init_suite(void){
+    map = concurrent_hash_map_create();
+    return 0;
+}
+
+static int clean_suite(void){
+    concurrent_hash_map_destroy_and_destroy_elements(map,free);
+    return 0;
+}
+
+CU_pSuite get_concurrent_hash_map_suite(void){
+    CU_pSuite suite = CU_add_suite("Concurrent hash map suite", init_suite, clean_suite);
+    CU_add_test(suite,"Concurrent hash map test of put and remove from many threads",test_concurrent_hash_map_put_and_remove);
+    CU_add_test(suite,"Concurrent hash map test of compute if absent",test_concurrent_hash_map_compute_if_absent);
+    CU_add_test(suite,"Concurrent hash map test of options",test_concurrent_hash_map_with_options);
+    return suite;
+}
@@ -0,0 +1,10 @@
+#ifndef CONCURRENT_HASH_MAP_TEST_H_INCLUDED
+#define CONCURRENT_HASH_MAP_TEST_H_INCLUDED
+
+#include <CUnit/Basic.h>
+#include <CUnit/CUnit.h>
+#include "../../../main/collections/map/concurrent_hashmap.h"
+
+CU_pSuite get_concurrent_hash_map_suite(void);
+
+#endif
@@ -1,4 +1,22 @@
 #include "hash_map_test.h"
+#include <stdint.h>
+#include "../../../main/collections/map/typed_hash_map.h"
+
+typedef struct{
+    int count;
+    double total;
+} t_stats;
+
+static unsigned long hash_string_key(char* const* key){
+    return hash_wy(*key);
+}
+
+static bool string_keys_equal(char* const* a, char* const* b){
+    return strcmp(*a,*b) == 0;
+}
+
+DEFINE_HASH_MAP(uint64_t, t_stats, u64_stats)
+DEFINE_HASH_MAP_WITH_FUNCTIONS(char*, int, str_int, hash_string_key, string_keys_equal)
 
 static t_hash_map* map;
 
@@ -70,7 +88,7 @@ static void test_hash_map_resizing(void){
         hash_map_put(map,n,x);
     }
 
-    CU_ASSERT_EQUAL(hash_map_size(map),15);
+    CU_ASSERT_EQUAL(hash_map_size(map),len);
     CU_ASSERT_TRUE(map->capacity > MAP_INITIAL_CAPACITY);
     CU_ASSERT_EQUAL_FATAL(*(int*)hash_map_get(map,"15"),15);
     CU_ASSERT_EQUAL_FATAL(*(int*)hash_map_get(map,"14"),14);
@@ -151,6 +169,498 @@ static void test_hash_map_iterate(void){
     hash_map_clean_and_destroy_elements(map,free);
 }
 
+static void test_open_addressing_put_and_remove(void){
+    t_hash_map* other = hash_map_create_with_options((t_hash_map_options){.type = HASH_MAP_OPEN_ADDRESSING});
+
+    hash_map_put(other,"1",strdup("uno"));
+    hash_map_put(other,"2",strdup("dos"));
+    hash_map_put(other,"3",strdup("tres"));
+
+    char* value2 = hash_map_remove(other,"2");
+    CU_ASSERT_PTR_NOT_NULL_FATAL(value2);
+    CU_ASSERT_STRING_EQUAL(value2,"dos");
+    free(value2);
+
+    CU_ASSERT_PTR_NULL(hash_map_get(other,"2"));
+    CU_ASSERT_STRING_EQUAL_FATAL((char*) hash_map_get(other,"1"),"uno");
+    CU_ASSERT_STRING_EQUAL_FATAL((char*) hash_map_get(other,"3"),"tres");
+    CU_ASSERT_EQUAL(hash_map_size(other),2);
+
+    hash_map_remove_and_destroy_element(other,"3",free);
+    CU_ASSERT_PTR_NULL(hash_map_get(other,"3"));
+    CU_ASSERT_EQUAL(hash_map_size(other),1);
+
+    hash_map_destroy_and_destroy_elements(other,free);
+}
+
+static void test_open_addressing_collisions(void){
+    t_hash_map* other = hash_map_create_with_options((t_hash_map_options){
+        .type = HASH_MAP_OPEN_ADDRESSING,
+        .hash_function = my_hash
+    });
+
+    hash_map_put(other,"Alberto",strdup("1"));
+    hash_map_put(other,"Alvaro",strdup("2"));
+    hash_map_put(other,"bb",strdup("3"));
+    hash_map_put(other,"Alf",strdup("4"));
+    hash_map_put(other,"bc",strdup("5"));
+
+    // removing from the middle of a probe sequence must shift the rest back
+    hash_map_remove_and_destroy_element(other,"Alvaro",free);
+
+    CU_ASSERT_PTR_NULL(hash_map_get(other,"Alvaro"));
+    CU_ASSERT_STRING_EQUAL_FATAL((char*) hash_map_get(other,"Alberto"),"1");
+    CU_ASSERT_STRING_EQUAL_FATAL((char*) hash_map_get(other,"bb"),"3");
+    CU_ASSERT_STRING_EQUAL_FATAL((char*) hash_map_get(other,"Alf"),"4");
+    CU_ASSERT_STRING_EQUAL_FATAL((char*) hash_map_get(other,"bc"),"5");
+    CU_ASSERT_EQUAL(hash_map_size(other),4);
+
+    hash_map_destroy_and_destroy_elements(other,free);
+}
+
+static int values_total;
+
+static void add_to_total(char* key, void* data){
+    (void) key;
+    values_total += *(int*)data;
+}
+
+static void test_open_addressing_resizing(void){
+    t_hash_map* other = hash_map_create_with_options((t_hash_map_options){.type = HASH_MAP_OPEN_ADDRESSING});
+    char n[12];
+    int len = 1000;
+    for(int i = 0; i < len; i++){
+        snprintf(n,sizeof n,"%d",i);
+        int* x = malloc(sizeof(int));
+        *x = i;
+        hash_map_put(other,n,x);
+    }
+
+    CU_ASSERT_EQUAL(hash_map_size(other),len);
+    CU_ASSERT_TRUE(other->capacity >= len);
+    CU_ASSERT_EQUAL(other->capacity & (other->capacity - 1), 0);
+
+    for(int i = 0; i < len; i += 2){
+        snprintf(n,sizeof n,"%d",i);
+        hash_map_remove_and_destroy_element(other,n,free);
+    }
+    for(int i = 1; i < len; i += 2){
+        snprintf(n,sizeof n,"%d",i);
+        int* x = hash_map_get(other,n);
+        CU_ASSERT_PTR_NOT_NULL_FATAL(x);
+        CU_ASSERT_EQUAL(*x,i);
+    }
+
+    // sum of the odd numbers below len
+    values_total = 0;
+    hash_map_iterate(other,add_to_total);
+    CU_ASSERT_EQUAL(values_total,(len / 2) * (len / 2));
+
+    hash_map_destroy_and_destroy_elements(other,free);
+}
+
+static void test_swiss_table_put_and_remove(void){
+    t_hash_map* other = hash_map_create_with_options((t_hash_map_options){.type = HASH_MAP_SWISS_TABLE});
+
+    hash_map_put(other,"1",strdup("uno"));
+    hash_map_put(other,"2",strdup("dos"));
+    hash_map_put(other,"3",strdup("tres"));
+
+    char* value2 = hash_map_remove(other,"2");
+    CU_ASSERT_PTR_NOT_NULL_FATAL(value2);
+    CU_ASSERT_STRING_EQUAL(value2,"dos");
+    free(value2);
+
+    CU_ASSERT_PTR_NULL(hash_map_get(other,"2"));
+    CU_ASSERT_STRING_EQUAL_FATAL((char*) hash_map_get(other,"1"),"uno");
+    CU_ASSERT_STRING_EQUAL_FATAL((char*) hash_map_get(other,"3"),"tres");
+
+    free(hash_map_get(other,"3"));
+    hash_map_put(other,"3",strdup("TRES"));
+    CU_ASSERT_STRING_EQUAL_FATAL((char*) hash_map_get(other,"3"),"TRES");
+    hash_map_remove_and_destroy_element(other,"1",free);
+    CU_ASSERT_EQUAL(hash_map_size(other),1);
+
+    hash_map_destroy_and_destroy_elements(other,free);
+}
+
+static void test_swiss_table_full_groups(void){
+    // every key gets the same hash, so they share one tag and overflow their group
+    t_hash_map* other = hash_map_create_with_options((t_hash_map_options){
+        .type = HASH_MAP_SWISS_TABLE,
+        .hash_function = my_hash
+    });
+    char n[13];
+    int len = 40;
+    for(int i = 0; i < len; i++){
+        snprintf(n,sizeof n,"a%d",i);
+        int* x = malloc(sizeof(int));
+        *x = i;
+        hash_map_put(other,n,x);
+    }
+
+    for(int i = 0; i < len; i += 3){
+        snprintf(n,sizeof n,"a%d",i);
+        hash_map_remove_and_destroy_element(other,n,free);
+    }
+    for(int i = 0; i < len; i++){
+        snprintf(n,sizeof n,"a%d",i);
+        int* x = hash_map_get(other,n);
+        if(i % 3 == 0){
+            CU_ASSERT_PTR_NULL(x);
+        } else {
+            CU_ASSERT_PTR_NOT_NULL_FATAL(x);
+            CU_ASSERT_EQUAL(*x,i);
+        }
+    }
+
+    hash_map_destroy_and_destroy_elements(other,free);
+}
+
+static void test_swiss_table_churn(void){
+    // inserting and removing keeps leaving tombstones, the table must reclaim them
+    t_hash_map* other = hash_map_create_with_options((t_hash_map_options){.type = HASH_MAP_SWISS_TABLE});
+    char n[12];
+    for(int i = 0; i < 5000; i++){
+        snprintf(n,sizeof n,"%d",i);
+        hash_map_put(other,n,&values_total);
+        if(i >= 10){
+            snprintf(n,sizeof n,"%d",i - 10);
+            CU_ASSERT_PTR_EQUAL(hash_map_remove(other,n),&values_total);
+        }
+    }
+
+    CU_ASSERT_EQUAL(hash_map_size(other),10);
+    CU_ASSERT_TRUE(other->capacity <= 64);
+    CU_ASSERT_PTR_EQUAL(hash_map_get(other,"4999"),&values_total);
+    CU_ASSERT_PTR_NULL(hash_map_get(other,"4989"));
+
+    hash_map_destroy(other);
+}
+
+static void test_incremental_rehash(void){
+    t_hash_map* other = hash_map_create_with_options((t_hash_map_options){.incremental_rehash = true});
+    char n[12];
+    int len = 1000;
+    bool saw_rehash_in_progress = false;
+
+    for(int i = 0; i < len; i++){
+        snprintf(n,sizeof n,"%d",i);
+        int* x = malloc(sizeof(int));
+        *x = i;
+        hash_map_put(other,n,x);
+        saw_rehash_in_progress |= other->old_buckets != NULL;
+    }
+    CU_ASSERT_TRUE(saw_rehash_in_progress);
+    CU_ASSERT_EQUAL(hash_map_size(other),len);
+
+    // every key must be reachable whichever table it currently lives in
+    for(int i = 0; i < len; i++){
+        snprintf(n,sizeof n,"%d",i);
+        int* x = hash_map_get(other,n);
+        CU_ASSERT_PTR_NOT_NULL_FATAL(x);
+        CU_ASSERT_EQUAL(*x,i);
+    }
+
+    for(int i = 0; i < len; i += 2){
+        snprintf(n,sizeof n,"%d",i);
+        hash_map_remove_and_destroy_element(other,n,free);
+    }
+    CU_ASSERT_EQUAL(hash_map_size(other),len / 2);
+
+    values_total = 0;
+    hash_map_iterate(other,add_to_total);
+    CU_ASSERT_EQUAL(values_total,(len / 2) * (len / 2));
+
+    hash_map_destroy_and_destroy_elements(other,free);
+}
+
+static void test_incremental_rehash_iterate_mid_migration(void){
+    t_hash_map* other = hash_map_create_with_options((t_hash_map_options){.incremental_rehash = true});
+    char n[12];
+    int i = 0;
+
+    // stop right after a resize started, before any lookup moves more buckets
+    do{
+        snprintf(n,sizeof n,"%d",i);
+        int* x = malloc(sizeof(int));
+        *x = 1;
+        hash_map_put(other,n,x);
+        i++;
+    } while(other->old_buckets == NULL);
+
+    values_total = 0;
+    hash_map_iterate(other,add_to_total);
+    CU_ASSERT_EQUAL(values_total,i);
+    CU_ASSERT_PTR_NOT_NULL(other->old_buckets);
+
+    hash_map_destroy_and_destroy_elements(other,free);
+}
+
+static void test_iterator_with_options(t_hash_map_options options){
+    t_hash_map* other = hash_map_create_with_options(options);
+    char n[16];
+    int* values = malloc(1000 * sizeof(int));
+    int total = 0;
+    for(int i = 0; i < 1000; i++){
+        values[i] = i;
+        total += i;
+        sprintf(n,"%d",i);
+        hash_map_put(other,n,&values[i]);
+    }
+
+    t_hash_map_iterator iterator;
+    hash_map_iterator_init(&iterator,other);
+    char* key;
+    void* value;
+    int count = 0, sum = 0, mismatches = 0;
+    while(hash_map_iterator_next(&iterator,&key,&value)){
+        count++;
+        sum += *(int*)value;
+        mismatches += hash_map_get(other,key) != value;
+    }
+    CU_ASSERT_EQUAL(count,1000);
+    CU_ASSERT_EQUAL(sum,total);
+    CU_ASSERT_EQUAL(mismatches,0);
+    CU_ASSERT_FALSE(hash_map_iterator_next(&iterator,NULL,NULL));
+
+    hash_map_destroy(other);
+    free(values);
+}
+
+static void test_hash_map_iterator(void){
+    test_iterator_with_options((t_hash_map_options){0});
+    test_iterator_with_options((t_hash_map_options){.type = HASH_MAP_OPEN_ADDRESSING});
+    test_iterator_with_options((t_hash_map_options){.type = HASH_MAP_SWISS_TABLE});
+
+    // mid migration the entries are split between both bucket arrays
+    t_hash_map* other = hash_map_create_with_options((t_hash_map_options){.incremental_rehash = true});
+    char n[16];
+    int i = 0;
+    do{
+        sprintf(n,"%d",i);
+        hash_map_put(other,n,&values_total);
+        i++;
+    } while(other->old_buckets == NULL);
+    t_hash_map_iterator iterator;
+    hash_map_iterator_init(&iterator,other);
+    int count = 0;
+    while(hash_map_iterator_next(&iterator,NULL,NULL))
+        count++;
+    CU_ASSERT_EQUAL(count,i);
+    hash_map_destroy(other);
+}
+
+static void test_arena_keys_with_type(t_hash_map_type type){
+    t_hash_map* other = hash_map_create_with_options((t_hash_map_options){
+        .type = type,
+        .key_storage = HASH_MAP_KEYS_ARENA
+    });
+    char n[16];
+
+    // churn enough keys through the map to make removed keys outweigh the live ones
+    for(int i = 0; i < 20000; i++){
+        sprintf(n,"key:%d",i);
+        hash_map_put(other,n,&values_total);
+        if(i >= 100){
+            sprintf(n,"key:%d",i - 100);
+            hash_map_remove(other,n);
+        }
+    }
+
+    CU_ASSERT_EQUAL(hash_map_size(other),100);
+    CU_ASSERT_TRUE(other->key_arena->wasted_bytes < KEY_ARENA_CHUNK_SIZE * 2);
+    for(int i = 19900; i < 20000; i++){
+        sprintf(n,"key:%d",i);
+        CU_ASSERT_PTR_EQUAL(hash_map_get(other,n),&values_total);
+    }
+
+    hash_map_clean(other);
+    CU_ASSERT_EQUAL(other->key_arena->live_bytes,0);
+    CU_ASSERT_PTR_NULL(other->key_arena->chunks->next);
+
+    hash_map_put(other,"again",&values_total);
+    CU_ASSERT_PTR_EQUAL(hash_map_get(other,"again"),&values_total);
+
+    hash_map_destroy(other);
+}
+
+static void test_hash_map_arena_keys(void){
+    test_arena_keys_with_type(HASH_MAP_CHAINING);
+    test_arena_keys_with_type(HASH_MAP_OPEN_ADDRESSING);
+    test_arena_keys_with_type(HASH_MAP_SWISS_TABLE);
+}
+
+static char* borrowed_key;
+
+static void check_key_is_borrowed(char* key, void* data){
+    (void) data;
+    CU_ASSERT_PTR_EQUAL(key,borrowed_key);
+}
+
+static void test_hash_map_borrowed_keys(void){
+    t_hash_map_type types[] = {HASH_MAP_CHAINING, HASH_MAP_OPEN_ADDRESSING, HASH_MAP_SWISS_TABLE};
+    static char key[] = "borrowed";
+    borrowed_key = key;
+
+    for(int i = 0; i < 3; i++){
+        t_hash_map* other = hash_map_create_with_options((t_hash_map_options){
+            .type = types[i],
+            .key_storage = HASH_MAP_KEYS_BORROWED
+        });
+        hash_map_put(other,key,strdup("value"));
+        hash_map_iterate(other,check_key_is_borrowed);
+        CU_ASSERT_STRING_EQUAL_FATAL((char*) hash_map_get(other,"borrowed"),"value");
+        hash_map_remove_and_destroy_element(other,"borrowed",free);
+        CU_ASSERT_STRING_EQUAL(key,"borrowed");
+        hash_map_destroy(other);
+    }
+}
+
+static void test_hash_map_length_aware_keys(void){
+    t_hash_map_type types[] = {HASH_MAP_CHAINING, HASH_MAP_OPEN_ADDRESSING, HASH_MAP_SWISS_TABLE};
+    // keys sliced out of a buffer, none of them null terminated
+    char buffer[] = "applepieapple";
+
+    for(int i = 0; i < 3; i++){
+        t_hash_map* other = hash_map_create_with_options((t_hash_map_options){.type = types[i]});
+        hash_map_put_n(other,buffer,5,"first");
+        hash_map_put_n(other,buffer,8,"second");
+        hash_map_put_n(other,buffer + 8,5,"replaced");
+
+        CU_ASSERT_EQUAL(hash_map_size(other),2);
+        CU_ASSERT_STRING_EQUAL(hash_map_get(other,"apple"),"replaced");
+        CU_ASSERT_STRING_EQUAL(hash_map_get_n(other,buffer,8),"second");
+        CU_ASSERT_PTR_NULL(hash_map_get_n(other,buffer,4));
+
+        CU_ASSERT_STRING_EQUAL(hash_map_remove_n(other,buffer + 8,5),"replaced");
+        CU_ASSERT_STRING_EQUAL(hash_map_remove(other,"applepie"),"second");
+        CU_ASSERT_EQUAL(hash_map_size(other),0);
+        hash_map_destroy(other);
+    }
+}
+
+static void test_hash_functions(void){
+    t_hash_function functions[] = {hash_djb2, hash_fnv1a, hash_wy};
+    char long_key[] = "a key long enough to go through the 48 byte loop of the wide hash";
+
+    for(int i = 0; i < 3; i++){
+        t_hash_function_n function_n = hash_function_with_length(functions[i]);
+        CU_ASSERT_PTR_NOT_NULL_FATAL(function_n);
+        CU_ASSERT_EQUAL(functions[i](long_key),function_n(long_key,strlen(long_key)));
+        CU_ASSERT_EQUAL(functions[i](""),function_n("",0));
+        CU_ASSERT_NOT_EQUAL(functions[i]("key:1"),functions[i]("key:2"));
+
+        t_hash_map* other = hash_map_create_with_hash_function(functions[i]);
+        char n[16];
+        for(int j = 0; j < 1000; j++){
+            sprintf(n,"%d",j);
+            hash_map_put(other,n,&values_total);
+        }
+        hash_map_put(other,long_key,long_key);
+        CU_ASSERT_EQUAL(hash_map_size(other),1001);
+        CU_ASSERT_PTR_EQUAL(hash_map_get(other,"999"),&values_total);
+        CU_ASSERT_PTR_EQUAL(hash_map_get(other,long_key),long_key);
+        hash_map_destroy(other);
+    }
+    CU_ASSERT_PTR_NULL(hash_function_with_length(my_hash));
+}
+
+static void test_hash_map_power_of_two_capacity(void){
+    t_hash_map* other = hash_map_create();
+    char n[12];
+    for(int i = 0; i < 1000; i++){
+        snprintf(n,sizeof n,"%d",i);
+        hash_map_put(other,n,&values_total);
+        // the bucket index is a mask of the cached hash
+        CU_ASSERT_EQUAL(other->capacity & (other->capacity - 1),0);
+    }
+    hash_map_destroy(other);
+}
+
+static void test_batch_with_options(t_hash_map_options options){
+    t_hash_map* other = hash_map_create_with_options(options);
+    // not a multiple of the window, the last one is partial
+    int count = HASH_MAP_BATCH_WINDOW * 40 + 3;
+    char** keys = malloc(count * sizeof(char*));
+    void** values = malloc(count * sizeof(void*));
+    int* numbers = malloc(count * sizeof(int));
+
+    for(int i = 0; i < count; i++){
+        keys[i] = malloc(16);
+        sprintf(keys[i],"%d",i);
+        numbers[i] = i;
+        values[i] = &numbers[i];
+    }
+    // grows several times in the middle of the batch
+    hash_map_put_batch(other,keys,count,values);
+    CU_ASSERT_EQUAL(hash_map_size(other),count);
+
+    for(int i = 0; i < count; i += 2)
+        hash_map_remove(other,keys[i]);
+
+    memset(values,0,count * sizeof(void*));
+    hash_map_get_batch(other,keys,count,values);
+    for(int i = 0; i < count; i++){
+        if(i % 2 == 0){
+            CU_ASSERT_PTR_NULL(values[i]);
+        }
+        else{
+            CU_ASSERT_PTR_EQUAL(values[i],&numbers[i]);
+        }
+        CU_ASSERT_PTR_EQUAL(values[i],hash_map_get(other,keys[i]));
+        free(keys[i]);
+    }
+
+    hash_map_get_batch(other,keys,0,values);
+    hash_map_destroy(other);
+    free(numbers);
+    free(values);
+    free(keys);
+}
+
+static void test_hash_map_batch(void){
+    test_batch_with_options((t_hash_map_options){.type = HASH_MAP_CHAINING});
+    test_batch_with_options((t_hash_map_options){.type = HASH_MAP_CHAINING, .incremental_rehash = true});
+    test_batch_with_options((t_hash_map_options){.type = HASH_MAP_OPEN_ADDRESSING});
+    test_batch_with_options((t_hash_map_options){.type = HASH_MAP_SWISS_TABLE});
+}
+
+static void test_typed_hash_map(void){
+    t_hash_map_u64_stats* stats = hash_map_u64_stats_create();
+    for(uint64_t i = 0; i < 1000; i++)
+        hash_map_u64_stats_put(stats,i * 7919,(t_stats){.count = (int)i, .total = i / 2.0});
+    CU_ASSERT_EQUAL(hash_map_u64_stats_size(stats),1000);
+
+    t_stats* found = hash_map_u64_stats_get(stats,7919 * 10);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(found);
+    CU_ASSERT_EQUAL(found->count,10);
+    // values live in the map, updates through the pointer stick
+    found->count++;
+    CU_ASSERT_EQUAL(hash_map_u64_stats_get(stats,7919 * 10)->count,11);
+    CU_ASSERT_PTR_NULL(hash_map_u64_stats_get(stats,1));
+
+    t_stats removed;
+    for(uint64_t i = 0; i < 1000; i += 2)
+        CU_ASSERT_TRUE(hash_map_u64_stats_remove(stats,i * 7919,&removed));
+    CU_ASSERT_FALSE(hash_map_u64_stats_remove(stats,0,NULL));
+    CU_ASSERT_EQUAL(removed.count,998);
+    CU_ASSERT_EQUAL(hash_map_u64_stats_size(stats),500);
+    for(uint64_t i = 1; i < 1000; i += 2)
+        CU_ASSERT_PTR_NOT_NULL(hash_map_u64_stats_get(stats,i * 7919));
+    hash_map_u64_stats_destroy(stats);
+
+    t_hash_map_str_int* words = hash_map_str_int_create();
+    char first[] = "word";
+    hash_map_str_int_put(words,first,1);
+    hash_map_str_int_put(words,"word",2);
+    CU_ASSERT_EQUAL(hash_map_str_int_size(words),1);
+    CU_ASSERT_EQUAL(*hash_map_str_int_get(words,"word"),2);
+    hash_map_str_int_clean(words);
+    CU_ASSERT_PTR_NULL(hash_map_str_int_get(words,"word"));
+    hash_map_str_int_destroy(words);
+}
+
 static int init_suite(void){
     map = hash_map_create();
     return 0;
@@ -169,6 +679,22 @@ CU_pSuite get_hash_map_suite(void){
     CU_add_test(suite,"Hash map test of resizing",test_hash_map_resizing);
     CU_add_test(suite,"Hash map test of collisions",test_map_collision);
     CU_add_test(suite,"Hash map test of iterate",test_hash_map_iterate);
+    CU_add_test(suite,"Open addressing hash map test of put and remove",test_open_addressing_put_and_remove);
+    CU_add_test(suite,"Open addressing hash map test of collisions",test_open_addressing_collisions);
+    CU_add_test(suite,"Open addressing hash map test of resizing",test_open_addressing_resizing);
+    CU_add_test(suite,"Swiss table hash map test of put and remove",test_swiss_table_put_and_remove);
+    CU_add_test(suite,"Swiss table hash map test of full groups",test_swiss_table_full_groups);
+    CU_add_test(suite,"Swiss table hash map test of churn",test_swiss_table_churn);
+    CU_add_test(suite,"Hash map test of incremental rehash",test_incremental_rehash);
+    CU_add_test(suite,"Hash map test of iterate during incremental rehash",test_incremental_rehash_iterate_mid_migration);
+    CU_add_test(suite,"Hash map test of arena keys",test_hash_map_arena_keys);
+    CU_add_test(suite,"Hash map test of borrowed keys",test_hash_map_borrowed_keys);
+    CU_add_test(suite,"Hash map test of length aware keys",test_hash_map_length_aware_keys);
+    CU_add_test(suite,"Hash map test of built-in hash functions",test_hash_functions);
+    CU_add_test(suite,"Hash map test of power of two capacity",test_hash_map_power_of_two_capacity);
+    CU_add_test(suite,"Hash map test of batch put and get",test_hash_map_batch);
+    CU_add_test(suite,"Hash map test of external iterator",test_hash_map_iterator);
+    CU_add_test(suite,"Typed hash map test",test_typed_hash_map);
     return suite;
 }
 
@@ -0,0 +1,375 @@
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include "concurrent_queue_test.h"
+
+#define ITEMS 200000
+#define PRODUCERS 4
+#define CONSUMERS 4
+
+// CUnit asserts are not thread safe, workers only record what went wrong
+
+static t_spsc_queue *spsc;
+static t_mpmc_queue *mpmc;
+
+static void *spsc_producer(void *arg)
+{
+    (void)arg;
+    for (uintptr_t i = 1; i <= ITEMS; i++)
+    {
+        while (spsc_queue_push(spsc, (void *)i) == QUEUE_FULL)
+            sched_yield();
+    }
+    return NULL;
+}
+
+static void test_spsc_queue_full_and_empty(void)
+{
+    t_spsc_queue *queue = spsc_queue_create(3);
+    int values[4];
+    int *out;
+
+    CU_ASSERT_EQUAL(spsc_queue_capacity(queue), 4);
+    CU_ASSERT_EQUAL(spsc_queue_pop(queue, (void **)&out), QUEUE_EMPTY);
+    for (int i = 0; i < 4; i++)
+    {
+        values[i] = i;
+        CU_ASSERT_EQUAL(spsc_queue_push(queue, &values[i]), QUEUE_SUCCESS);
+    }
+    CU_ASSERT_EQUAL(spsc_queue_push(queue, &values[0]), QUEUE_FULL);
+    CU_ASSERT_EQUAL(spsc_queue_size(queue), 4);
+
+    CU_ASSERT_EQUAL(spsc_queue_pop(queue, (void **)&out), QUEUE_SUCCESS);
+    CU_ASSERT_EQUAL(*out, 0);
+    CU_ASSERT_EQUAL(spsc_queue_push(queue, &values[0]), QUEUE_SUCCESS);
+    for (int i = 1; i <= 4; i++)
+    {
+        CU_ASSERT_EQUAL(spsc_queue_pop(queue, (void **)&out), QUEUE_SUCCESS);
+        CU_ASSERT_EQUAL(*out, i % 4);
+    }
+    CU_ASSERT_TRUE(spsc_queue_is_empty(queue));
+
+    spsc_queue_push(queue, malloc(sizeof(int)));
+    spsc_queue_destroy_and_destroy_elements(queue, free);
+}
+
+static void test_spsc_queue_keeps_order_across_threads(void)
+{
+    pthread_t producer;
+    uintptr_t expected = 1;
+    int out_of_order = 0;
+    void *item;
+
+    spsc = spsc_queue_create(64);
+    pthread_create(&producer, NULL, spsc_producer, NULL);
+    while (expected <= ITEMS)
+    {
+        if (spsc_queue_pop(spsc, &item) == QUEUE_EMPTY)
+        {
+            sched_yield();
+            continue;
+        }
+        out_of_order += (uintptr_t)item != expected;
+        expected++;
+    }
+    pthread_join(producer, NULL);
+
+    CU_ASSERT_EQUAL(out_of_order, 0);
+    CU_ASSERT_TRUE(spsc_queue_is_empty(spsc));
+    spsc_queue_destroy(spsc);
+}
+
+typedef struct
+{
+    int index;
+    unsigned long long total;
+    int taken;
+    // per producer, the last item seen: items of one producer must come out in order
+    uintptr_t last_seen[PRODUCERS];
+    int out_of_order;
+} t_mpmc_worker;
+
+static atomic_int items_left;
+
+static void *mpmc_producer(void *arg)
+{
+    t_mpmc_worker *worker = arg;
+    for (uintptr_t i = 1; i <= ITEMS / PRODUCERS; i++)
+    {
+        // the producer travels in the top bits
+        void *item = (void *)(((uintptr_t)worker->index << 32) | i);
+        while (mpmc_queue_push(mpmc, item) == QUEUE_FULL)
+            sched_yield();
+    }
+    return NULL;
+}
+
+static void *mpmc_consumer(void *arg)
+{
+    t_mpmc_worker *worker = arg;
+    void *item;
+    while (atomic_load(&items_left) > 0)
+    {
+        if (mpmc_queue_pop(mpmc, &item) == QUEUE_EMPTY)
+        {
+            sched_yield();
+            continue;
+        }
+        atomic_fetch_sub(&items_left, 1);
+        uintptr_t producer = (uintptr_t)item >> 32;
+        uintptr_t sequence = (uintptr_t)item & 0xffffffff;
+        worker->out_of_order += sequence <= worker->last_seen[producer];
+        worker->last_seen[producer] = sequence;
+        worker->total += sequence;
+        worker->taken++;
+    }
+    return NULL;
+}
+
+static void test_mpmc_queue_full_and_empty(void)
+{
+    t_mpmc_queue *queue = mpmc_queue_create(1);
+    int values[2] = {1, 2};
+    int *out;
+
+    CU_ASSERT_EQUAL(mpmc_queue_capacity(queue), 2);
+    CU_ASSERT_EQUAL(mpmc_queue_pop(queue, (void **)&out), QUEUE_EMPTY);
+    CU_ASSERT_EQUAL(mpmc_queue_push(queue, &values[0]), QUEUE_SUCCESS);
+    CU_ASSERT_EQUAL(mpmc_queue_push(queue, &values[1]), QUEUE_SUCCESS);
+    CU_ASSERT_EQUAL(mpmc_queue_push(queue, &values[0]), QUEUE_FULL);
+    CU_ASSERT_EQUAL(mpmc_queue_size(queue), 2);
+
+    // several laps around the ring
+    for (int i = 0; i < 10; i++)
+    {
+        CU_ASSERT_EQUAL(mpmc_queue_pop(queue, (void **)&out), QUEUE_SUCCESS);
+        CU_ASSERT_EQUAL(*out, values[i % 2]);
+        CU_ASSERT_EQUAL(mpmc_queue_push(queue, out), QUEUE_SUCCESS);
+    }
+    mpmc_queue_pop(queue, NULL);
+    mpmc_queue_pop(queue, NULL);
+    CU_ASSERT_TRUE(mpmc_queue_is_empty(queue));
+
+    mpmc_queue_push(queue, malloc(sizeof(int)));
+    mpmc_queue_destroy_and_destroy_elements(queue, free);
+}
+
+static void test_mpmc_queue_many_producers_and_consumers(void)
+{
+    pthread_t producers[PRODUCERS], consumers[CONSUMERS];
+    t_mpmc_worker producer_args[PRODUCERS];
+    t_mpmc_worker consumer_args[CONSUMERS] = {0};
+
+    mpmc = mpmc_queue_create(128);
+    atomic_store(&items_left, ITEMS);
+    for (int i = 0; i < CONSUMERS; i++)
+        pthread_create(&consumers[i], NULL, mpmc_consumer, &consumer_args[i]);
+    for (int i = 0; i < PRODUCERS; i++)
+    {
+        producer_args[i].index = i;
+        pthread_create(&producers[i], NULL, mpmc_producer, &producer_args[i]);
+    }
+    for (int i = 0; i < PRODUCERS; i++)
+        pthread_join(producers[i], NULL);
+    for (int i = 0; i < CONSUMERS; i++)
+        pthread_join(consumers[i], NULL);
+
+    unsigned long long total = 0;
+    int taken = 0;
+    for (int i = 0; i < CONSUMERS; i++)
+    {
+        CU_ASSERT_EQUAL(consumer_args[i].out_of_order, 0);
+        total += consumer_args[i].total;
+        taken += consumer_args[i].taken;
+    }
+    unsigned long long per_producer = ITEMS / PRODUCERS;
+    CU_ASSERT_EQUAL(taken, ITEMS);
+    CU_ASSERT_EQUAL(total, PRODUCERS * per_producer * (per_producer + 1) / 2);
+    CU_ASSERT_TRUE(mpmc_queue_is_empty(mpmc));
+    mpmc_queue_destroy(mpmc);
+}
+
+static t_blocking_queue *blocking;
+
+static void *blocking_producer(void *arg)
+{
+    (void)arg;
+    void *batch[10];
+    for (uintptr_t i = 1; i <= ITEMS / PRODUCERS; i += 10)
+    {
+        for (uintptr_t j = 0; j < 10; j++)
+            batch[j] = (void *)(i + j);
+        blocking_queue_push_batch(blocking, batch, 10);
+    }
+    return NULL;
+}
+
+static void *blocking_consumer(void *arg)
+{
+    t_mpmc_worker *worker = arg;
+    void *batch[32];
+    int taken;
+    // 0 only once the queue is closed and drained
+    while ((taken = blocking_queue_pop_batch(blocking, batch, 32)) > 0)
+    {
+        for (int i = 0; i < taken; i++)
+            worker->total += (uintptr_t)batch[i];
+        worker->taken += taken;
+    }
+    return NULL;
+}
+
+static void test_blocking_queue_timeout_and_close(void)
+{
+    t_blocking_queue *queue = blocking_queue_create();
+    int value = 7;
+    int *out;
+
+    CU_ASSERT_EQUAL(blocking_queue_try_pop(queue, (void **)&out), QUEUE_EMPTY);
+    CU_ASSERT_EQUAL(blocking_queue_pop_timeout(queue, (void **)&out, 20), QUEUE_TIMEOUT);
+    CU_ASSERT_EQUAL(blocking_queue_pop_timeout(queue, (void **)&out, -1500), QUEUE_TIMEOUT);
+
+    blocking_queue_push(queue, &value);
+    CU_ASSERT_EQUAL(blocking_queue_size(queue), 1);
+    CU_ASSERT_EQUAL(blocking_queue_pop_timeout(queue, (void **)&out, 20), QUEUE_SUCCESS);
+    CU_ASSERT_PTR_EQUAL(out, &value);
+
+    // closing keeps what is queued but refuses new elements
+    CU_ASSERT_EQUAL(blocking_queue_push(queue, &value), QUEUE_SUCCESS);
+    blocking_queue_close(queue);
+    CU_ASSERT_EQUAL(blocking_queue_push(queue, &value), QUEUE_CLOSED);
+    void *batch[] = {&value, &value};
+    CU_ASSERT_EQUAL(blocking_queue_push_batch(queue, batch, 2), QUEUE_CLOSED);
+    CU_ASSERT_EQUAL(blocking_queue_size(queue), 1);
+    CU_ASSERT_EQUAL(blocking_queue_pop(queue, (void **)&out), QUEUE_SUCCESS);
+    CU_ASSERT_EQUAL(blocking_queue_pop(queue, (void **)&out), QUEUE_EMPTY);
+    CU_ASSERT_EQUAL(blocking_queue_pop_timeout(queue, (void **)&out, 1000), QUEUE_EMPTY);
+    CU_ASSERT_EQUAL(blocking_queue_pop_batch(queue, (void **)&out, 1), 0);
+    blocking_queue_destroy(queue);
+}
+
+static void test_blocking_queue_batches_across_threads(void)
+{
+    pthread_t producers[PRODUCERS], consumers[CONSUMERS];
+    t_mpmc_worker consumer_args[CONSUMERS] = {0};
+
+    blocking = blocking_queue_create();
+    for (int i = 0; i < CONSUMERS; i++)
+        pthread_create(&consumers[i], NULL, blocking_consumer, &consumer_args[i]);
+    for (int i = 0; i < PRODUCERS; i++)
+        pthread_create(&producers[i], NULL, blocking_producer, NULL);
+    for (int i = 0; i < PRODUCERS; i++)
+        pthread_join(producers[i], NULL);
+    blocking_queue_close(blocking);
+    for (int i = 0; i < CONSUMERS; i++)
+        pthread_join(consumers[i], NULL);
+
+    unsigned long long total = 0;
+    int taken = 0;
+    for (int i = 0; i < CONSUMERS; i++)
+    {
+        total += consumer_args[i].total;
+        taken += consumer_args[i].taken;
+    }
+    unsigned long long per_producer = ITEMS / PRODUCERS;
+    CU_ASSERT_EQUAL(taken, ITEMS);
+    CU_ASSERT_EQUAL(total, PRODUCERS * per_producer * (per_producer + 1) / 2);
+    blocking_queue_destroy(blocking);
+}
+
+static t_work_stealing_deque *deque;
+static atomic_bool owner_done;
+// how many times each item was taken, by the owner or a thief
+static atomic_int taken_times[ITEMS + 1];
+
+static void *deque_thief(void *arg)
+{
+    (void)arg;
+    void *item;
+    while (!atomic_load(&owner_done) || !work_stealing_deque_is_empty(deque))
+    {
+        if (work_stealing_deque_steal(deque, &item) == QUEUE_SUCCESS)
+            atomic_fetch_add(&taken_times[(uintptr_t)item], 1);
+        else
+            sched_yield();
+    }
+    return NULL;
+}
+
+static void test_work_stealing_deque_ends(void)
+{
+    t_work_stealing_deque *queue = work_stealing_deque_create(2);
+    int values[5] = {0, 1, 2, 3, 4};
+    int *out;
+
+    CU_ASSERT_EQUAL(work_stealing_deque_pop(queue, (void **)&out), QUEUE_EMPTY);
+    CU_ASSERT_EQUAL(work_stealing_deque_steal(queue, (void **)&out), QUEUE_EMPTY);
+    // grows twice
+    for (int i = 0; i < 5; i++)
+        work_stealing_deque_push(queue, &values[i]);
+    CU_ASSERT_EQUAL(work_stealing_deque_size(queue), 5);
+
+    // the owner takes the newest, thieves the oldest
+    CU_ASSERT_EQUAL(work_stealing_deque_pop(queue, (void **)&out), QUEUE_SUCCESS);
+    CU_ASSERT_EQUAL(*out, 4);
+    CU_ASSERT_EQUAL(work_stealing_deque_steal(queue, (void **)&out), QUEUE_SUCCESS);
+    CU_ASSERT_EQUAL(*out, 0);
+    CU_ASSERT_EQUAL(work_stealing_deque_steal(queue, (void **)&out), QUEUE_SUCCESS);
+    CU_ASSERT_EQUAL(*out, 1);
+    CU_ASSERT_EQUAL(work_stealing_deque_pop(queue, (void **)&out), QUEUE_SUCCESS);
+    CU_ASSERT_EQUAL(*out, 3);
+    CU_ASSERT_EQUAL(work_stealing_deque_pop(queue, (void **)&out), QUEUE_SUCCESS);
+    CU_ASSERT_EQUAL(*out, 2);
+    CU_ASSERT_EQUAL(work_stealing_deque_pop(queue, (void **)&out), QUEUE_EMPTY);
+    CU_ASSERT_TRUE(work_stealing_deque_is_empty(queue));
+
+    work_stealing_deque_push(queue, malloc(sizeof(int)));
+    work_stealing_deque_destroy_and_destroy_elements(queue, free);
+}
+
+static void test_work_stealing_deque_owner_and_thieves(void)
+{
+    pthread_t thieves[CONSUMERS];
+    void *item;
+
+    deque = work_stealing_deque_create(4);
+    atomic_store(&owner_done, false);
+    for (int i = 0; i <= ITEMS; i++)
+        atomic_init(&taken_times[i], 0);
+    for (int i = 0; i < CONSUMERS; i++)
+        pthread_create(&thieves[i], NULL, deque_thief, NULL);
+
+    // the owner keeps some for itself, racing the thieves for the last element
+    for (uintptr_t i = 1; i <= ITEMS; i++)
+    {
+        work_stealing_deque_push(deque, (void *)i);
+        if (i % 3 == 0 && work_stealing_deque_pop(deque, &item) == QUEUE_SUCCESS)
+            atomic_fetch_add(&taken_times[(uintptr_t)item], 1);
+    }
+    while (work_stealing_deque_pop(deque, &item) == QUEUE_SUCCESS)
+        atomic_fetch_add(&taken_times[(uintptr_t)item], 1);
+    atomic_store(&owner_done, true);
+    for (int i = 0; i < CONSUMERS; i++)
+        pthread_join(thieves[i], NULL);
+
+    int wrong = 0;
+    for (int i = 1; i <= ITEMS; i++)
+        wrong += atomic_load(&taken_times[i]) != 1;
+    CU_ASSERT_EQUAL(wrong, 0);
+    CU_ASSERT_TRUE(work_stealing_deque_is_empty(deque));
+    work_stealing_deque_destroy(deque);
+}
+
+CU_pSuite get_concurrent_queue_suite(void)
+{
+    CU_pSuite suite = CU_add_suite("concurrent queue suite", NULL, NULL);
+    CU_ADD_TEST(suite, test_spsc_queue_full_and_empty);
+    CU_ADD_TEST(suite, test_spsc_queue_keeps_order_across_threads);
+    CU_ADD_TEST(suite, test_mpmc_queue_full_and_empty);
+    CU_ADD_TEST(suite, test_mpmc_queue_many_producers_and_consumers);
+    CU_ADD_TEST(suite, test_blocking_queue_timeout_and_close);
+    CU_ADD_TEST(suite, test_blocking_queue_batches_across_threads);
+    CU_ADD_TEST(suite, test_work_stealing_deque_ends);
+    CU_ADD_TEST(suite, test_work_stealing_deque_owner_and_thieves);
+    return suite;
+}
@@ -0,0 +1,13 @@
+#ifndef CONCURRENT_QUEUE_TEST_H_INCLUDED
+#define CONCURRENT_QUEUE_TEST_H_INCLUDED
+
+#include <CUnit/Basic.h>
+#include <CUnit/CUnit.h>
+#include "../../../main/collections/queue/spsc_queue.h"
+#include "../../../main/collections/queue/mpmc_queue.h"
+#include "../../../main/collections/queue/blocking_queue.h"
+#include "../../../main/collections/queue/work_stealing_deque.h"
+
+CU_pSuite get_concurrent_queue_suite(void);
+
+#endif
@@ -37,9 +37,227 @@ static void test_stack_and_queue_palindrome(void)
     CU_ASSERT_FALSE(is_palindrome("jorge"));
 }
 
+static void test_queue_wraps_and_grows(void)
+{
+    t_queue *queue = queue_create();
+    int values[100];
+    int *out;
+
+    // move the head forward so the ring wraps before it grows
+    for (int i = 0; i < 10; i++)
+    {
+        queue_push(queue, &values[0]);
+        queue_pop(queue, NULL);
+    }
+    for (int i = 0; i < 100; i++)
+    {
+        values[i] = i;
+        queue_push(queue, &values[i]);
+        if (i == QUEUE_INITIAL_CAPACITY - 1)
+            CU_ASSERT_EQUAL(queue->capacity, QUEUE_INITIAL_CAPACITY);
+    }
+    CU_ASSERT_EQUAL(queue_size(queue), 100);
+    CU_ASSERT_EQUAL(queue->capacity & (queue->capacity - 1), 0);
+
+    for (int i = 0; i < 100; i++)
+    {
+        CU_ASSERT_EQUAL(queue_peek(queue, (void **)&out), QUEUE_SUCCESS);
+        CU_ASSERT_EQUAL(queue_pop(queue, (void **)&out), QUEUE_SUCCESS);
+        CU_ASSERT_EQUAL(*out, i);
+    }
+    CU_ASSERT_EQUAL(queue_pop(queue, (void **)&out), QUEUE_EMPTY);
+    CU_ASSERT_EQUAL(queue_peek(queue, (void **)&out), QUEUE_EMPTY);
+
+    for (int i = 0; i < 20; i++)
+        queue_push(queue, malloc(sizeof(int)));
+    queue_clean_and_destroy_elements(queue, free);
+    CU_ASSERT_TRUE(queue_is_empty(queue));
+    queue_destroy(queue);
+}
+
+static void test_stack_grows_and_searches(void)
+{
+    t_stack *stack = stack_create();
+    int values[100];
+    int *out;
+
+    for (int i = 0; i < 100; i++)
+    {
+        values[i] = i;
+        stack_push(stack, &values[i]);
+    }
+    CU_ASSERT_EQUAL(stack_size(stack), 100);
+    CU_ASSERT_EQUAL(stack_search(stack, &values[99]), 1);
+    CU_ASSERT_EQUAL(stack_search(stack, &values[0]), 100);
+    CU_ASSERT_EQUAL(stack_search(stack, stack), -1);
+
+    for (int i = 99; i >= 0; i--)
+    {
+        CU_ASSERT_EQUAL(stack_peek(stack, (void **)&out), STACK_SUCCESS);
+        CU_ASSERT_EQUAL(stack_pop(stack, (void **)&out), STACK_SUCCESS);
+        CU_ASSERT_EQUAL(*out, i);
+    }
+    CU_ASSERT_EQUAL(stack_pop(stack, (void **)&out), STACK_EMPTY);
+
+    for (int i = 0; i < 20; i++)
+        stack_push(stack, malloc(sizeof(int)));
+    stack_destroy_and_destroy_elements(stack, free);
+}
+
+static bool int_less_than(void *a, void *b)
+{
+    return *(int *)a < *(int *)b;
+}
+
+static void test_priority_queue_orders_elements(void)
+{
+    t_priority_queue *queue = priority_queue_create(int_less_than);
+    int values[1000];
+    int *out;
+
+    CU_ASSERT_EQUAL(priority_queue_pop(queue, (void **)&out), QUEUE_EMPTY);
+    // a permutation of 0..999, with pops in between
+    for (int i = 0; i < 1000; i++)
+    {
+        values[i] = (i * 7919) % 1000;
+        priority_queue_push(queue, &values[i]);
+        if (i % 10 == 9)
+        {
+            priority_queue_pop(queue, (void **)&out);
+            priority_queue_push(queue, out);
+        }
+    }
+    CU_ASSERT_EQUAL(priority_queue_size(queue), 1000);
+
+    int previous = -1;
+    int out_of_order = 0;
+    while (!priority_queue_is_empty(queue))
+    {
+        CU_ASSERT_EQUAL(priority_queue_peek(queue, (void **)&out), QUEUE_SUCCESS);
+        CU_ASSERT_EQUAL(priority_queue_pop(queue, (void **)&out), QUEUE_SUCCESS);
+        out_of_order += *out != previous + 1;
+        previous = *out;
+    }
+    CU_ASSERT_EQUAL(out_of_order, 0);
+    CU_ASSERT_EQUAL(previous, 999);
+
+    for (int i = 0; i < 20; i++)
+    {
+        int *x = malloc(sizeof(int));
+        *x = i;
+        priority_queue_push(queue, x);
+    }
+    priority_queue_destroy_and_destroy_elements(queue, free);
+}
+
+static void test_priority_queue_decrease_key_and_remove(void)
+{
+    t_priority_queue *queue = priority_queue_create(int_less_than);
+    t_priority_queue_handle handles[100];
+    int values[100];
+    int *out;
+
+    for (int i = 0; i < 100; i++)
+    {
+        values[i] = 100 + i;
+        handles[i] = priority_queue_push(queue, &values[i]);
+    }
+
+    values[70] = 5;
+    CU_ASSERT_EQUAL(priority_queue_decrease_key(queue, handles[70]), QUEUE_SUCCESS);
+    values[30] = 7;
+    CU_ASSERT_EQUAL(priority_queue_decrease_key(queue, handles[30]), QUEUE_SUCCESS);
+    CU_ASSERT_EQUAL(priority_queue_peek(queue, (void **)&out), QUEUE_SUCCESS);
+    CU_ASSERT_PTR_EQUAL(out, &values[70]);
+
+    CU_ASSERT_EQUAL(priority_queue_remove(queue, handles[70], (void **)&out), QUEUE_SUCCESS);
+    CU_ASSERT_PTR_EQUAL(out, &values[70]);
+    CU_ASSERT_EQUAL(priority_queue_remove(queue, handles[70], NULL), QUEUE_INVALID_HANDLE);
+    CU_ASSERT_EQUAL(priority_queue_decrease_key(queue, handles[70]), QUEUE_INVALID_HANDLE);
+    CU_ASSERT_EQUAL(priority_queue_decrease_key(queue, 1000), QUEUE_INVALID_HANDLE);
+    // from the middle of the heap, the last entry takes its place
+    CU_ASSERT_EQUAL(priority_queue_remove(queue, handles[50], NULL), QUEUE_SUCCESS);
+    CU_ASSERT_EQUAL(priority_queue_size(queue), 98);
+
+    // a freed handle is handed out again
+    int again = 1;
+    CU_ASSERT_EQUAL(priority_queue_push(queue, &again), handles[50]);
+
+    CU_ASSERT_EQUAL(priority_queue_pop(queue, (void **)&out), QUEUE_SUCCESS);
+    CU_ASSERT_EQUAL(*out, 1);
+    CU_ASSERT_EQUAL(priority_queue_pop(queue, (void **)&out), QUEUE_SUCCESS);
+    CU_ASSERT_EQUAL(*out, 7);
+    int previous = 0;
+    int out_of_order = 0;
+    while (priority_queue_pop(queue, (void **)&out) == QUEUE_SUCCESS)
+    {
+        out_of_order += *out <= previous || *out == 150;
+        previous = *out;
+    }
+    CU_ASSERT_EQUAL(out_of_order, 0);
+    CU_ASSERT_EQUAL(previous, 199);
+    priority_queue_destroy(queue);
+}
+
+static void test_priority_queue_from_array_list(void)
+{
+    t_array_list *list = array_list_create();
+    int values[500];
+    int *out;
+
+    for (int i = 0; i < 500; i++)
+    {
+        values[i] = (i * 313) % 500;
+        array_list_add(list, &values[i]);
+    }
+    t_priority_queue *queue = priority_queue_create_from_array_list(list, int_less_than);
+    CU_ASSERT_EQUAL(priority_queue_size(queue), 500);
+    CU_ASSERT_EQUAL(array_list_size(list), 500);
+
+    // handles follow the list indexes
+    values[123] = -1;
+    CU_ASSERT_EQUAL(priority_queue_decrease_key(queue, 123), QUEUE_SUCCESS);
+    CU_ASSERT_EQUAL(priority_queue_pop(queue, (void **)&out), QUEUE_SUCCESS);
+    CU_ASSERT_PTR_EQUAL(out, &values[123]);
+
+    int previous = -1;
+    int out_of_order = 0;
+    while (priority_queue_pop(queue, (void **)&out) == QUEUE_SUCCESS)
+    {
+        out_of_order += *out <= previous;
+        previous = *out;
+    }
+    CU_ASSERT_EQUAL(out_of_order, 0);
+    priority_queue_destroy(queue);
+
+    // nothing and a single element leave nothing to heapify
+    array_list_clean(list);
+    queue = priority_queue_create_from_array_list(list, int_less_than);
+    CU_ASSERT_EQUAL(priority_queue_size(queue), 0);
+    CU_ASSERT_EQUAL(priority_queue_pop(queue, (void **)&out), QUEUE_EMPTY);
+    CU_ASSERT_NOT_EQUAL(priority_queue_push(queue, &values[7]), -1);
+    CU_ASSERT_EQUAL(priority_queue_pop(queue, (void **)&out), QUEUE_SUCCESS);
+    CU_ASSERT_PTR_EQUAL(out, &values[7]);
+    priority_queue_destroy(queue);
+
+    array_list_add(list, &values[3]);
+    queue = priority_queue_create_from_array_list(list, int_less_than);
+    CU_ASSERT_EQUAL(priority_queue_size(queue), 1);
+    CU_ASSERT_EQUAL(priority_queue_pop(queue, (void **)&out), QUEUE_SUCCESS);
+    CU_ASSERT_PTR_EQUAL(out, &values[3]);
+    CU_ASSERT_EQUAL(priority_queue_pop(queue, (void **)&out), QUEUE_EMPTY);
+    priority_queue_destroy(queue);
+    array_list_destroy(list);
+}
+
 CU_pSuite get_queue_stack_suite(void)
 {
     CU_pSuite suite = CU_add_suite("queue and stack suite", NULL, NULL);
     CU_ADD_TEST(suite, test_stack_and_queue_palindrome);
+    CU_ADD_TEST(suite, test_queue_wraps_and_grows);
+    CU_ADD_TEST(suite, test_stack_grows_and_searches);
+    CU_ADD_TEST(suite, test_priority_queue_orders_elements);
+    CU_ADD_TEST(suite, test_priority_queue_decrease_key_and_remove);
+    CU_ADD_TEST(suite, test_priority_queue_from_array_list);
     return suite;
 }
@@ -5,6 +5,7 @@
 #include <CUnit/CUnit.h>
 #include "../../../main/collections/queue/queue.h"
 #include "../../../main/collections/stack/stack.h"
+#include "../../../main/collections/queue/priority_queue.h"
 
 CU_pSuite get_queue_stack_suite(void);
 
@@ -0,0 +1,167 @@
+#include "stream_test.h"
+
+#define ELEMENTS 1000
+
+static int values[ELEMENTS];
+static int doubled[ELEMENTS];
+static t_linked_list *linked;
+static t_array_list *array;
+static int conditions_called;
+
+static int init_suite(void)
+{
+    linked = linked_list_create();
+    array = array_list_create();
+    for (int i = 0; i < ELEMENTS; i++)
+    {
+        values[i] = i;
+        linked_list_add(linked, &values[i]);
+        array_list_add(array, &values[i]);
+    }
+    return 0;
+}
+
+static int clean_suite(void)
+{
+    linked_list_destroy(linked);
+    array_list_destroy(array);
+    return 0;
+}
+
+static bool is_even(void *x)
+{
+    conditions_called++;
+    return *(int *)x % 2 == 0;
+}
+
+// points into doubled, so mapping allocates nothing
+static void *twice(void *x)
+{
+    int i = *(int *)x;
+    doubled[i] = i * 2;
+    return &doubled[i];
+}
+
+// folds keep a running int in the seed
+static void *sum(void *acc, void *x)
+{
+    *(int *)acc += *(int *)x;
+    return acc;
+}
+
+static void test_stream_same_as_eager(void)
+{
+    t_linked_list *evens = linked_list_filter(linked, is_even);
+    t_linked_list *mapped = linked_list_map(evens, twice);
+    int eager = 0;
+    linked_list_foldl(mapped, &eager, sum);
+    linked_list_destroy(evens);
+    linked_list_destroy(mapped);
+
+    int lazy = 0;
+    stream_foldl(stream_map(stream_filter(stream_from_linked_list(linked), is_even), twice), &lazy, sum);
+    CU_ASSERT_EQUAL(lazy, eager);
+
+    lazy = 0;
+    stream_foldl(stream_map(stream_filter(stream_from_array_list(array), is_even), twice), &lazy, sum);
+    CU_ASSERT_EQUAL(lazy, eager);
+
+    CU_ASSERT_EQUAL(stream_count(stream_filter(stream_from_array_list(array), is_even)), ELEMENTS / 2);
+    CU_ASSERT_EQUAL(stream_count(stream_from_linked_list(linked)), ELEMENTS);
+}
+
+static void test_stream_take_stops_reading(void)
+{
+    conditions_called = 0;
+    t_linked_list *taken = stream_to_linked_list(stream_take(stream_filter(stream_from_linked_list(linked), is_even), 5));
+    CU_ASSERT_EQUAL(linked_list_size(taken), 5);
+    // 0 to 8 hold the first five evens, nothing past 8 is looked at
+    CU_ASSERT_EQUAL(conditions_called, 9);
+    int *last;
+    linked_list_get(taken, 4, (void **)&last);
+    CU_ASSERT_EQUAL(*last, 8);
+    linked_list_destroy(taken);
+
+    conditions_called = 0;
+    CU_ASSERT_EQUAL(stream_count(stream_take(stream_filter(stream_from_linked_list(linked), is_even), 0)), 0);
+    CU_ASSERT_EQUAL(conditions_called, 0);
+
+    CU_ASSERT_TRUE(stream_any_satisfy(stream_from_array_list(array), is_even));
+}
+
+static void test_stream_drop_and_take(void)
+{
+    t_array_list *window = stream_to_array_list(stream_take(stream_drop(stream_from_array_list(array), 10), 20));
+    CU_ASSERT_EQUAL(array_list_size(window), 20);
+    int errors = 0;
+    for (int i = 0; i < 20; i++)
+        errors += *(int *)window->array[i] != 10 + i;
+    CU_ASSERT_EQUAL(errors, 0);
+    array_list_destroy(window);
+
+    // the take counts what got past the filter, the drop what reached it
+    t_stream *stream = stream_take(stream_filter(stream_drop(stream_from_linked_list(linked), 3), is_even), 2);
+    int *first, *second, *none;
+    CU_ASSERT_TRUE(stream_next(stream, (void **)&first));
+    CU_ASSERT_TRUE(stream_next(stream, (void **)&second));
+    CU_ASSERT_FALSE(stream_next(stream, (void **)&none));
+    CU_ASSERT_EQUAL(*first, 4);
+    CU_ASSERT_EQUAL(*second, 6);
+    stream_destroy(stream);
+}
+
+static void test_stream_from_hash_map(void)
+{
+    t_hash_map_type types[] = {HASH_MAP_CHAINING, HASH_MAP_OPEN_ADDRESSING, HASH_MAP_SWISS_TABLE};
+    char key[16];
+    for (int t = 0; t < 3; t++)
+    {
+        t_hash_map *map = hash_map_create_with_options((t_hash_map_options){.type = types[t]});
+        int expected = 0;
+        for (int i = 0; i < ELEMENTS; i++)
+        {
+            sprintf(key, "%d", i);
+            hash_map_put(map, key, &values[i]);
+            expected += i % 2 == 0 ? i * 2 : 0;
+        }
+        int total = 0;
+        stream_foldl(stream_map(stream_filter(stream_from_hash_map(map), is_even), twice), &total, sum);
+        CU_ASSERT_EQUAL(total, expected);
+
+        t_linked_list *keys = stream_to_linked_list(stream_from_hash_map_keys(map));
+        CU_ASSERT_EQUAL(linked_list_size(keys), ELEMENTS);
+        int *value;
+        linked_list_get(keys, 0, (void **)&value);
+        CU_ASSERT_PTR_NOT_NULL(hash_map_get(map, (char *)value));
+        linked_list_destroy(keys);
+        hash_map_destroy(map);
+    }
+}
+
+static void test_stream_too_many_stages(void)
+{
+    t_stream *stream = stream_from_array_list(array);
+    for (int i = 0; i < STREAM_MAX_STAGES; i++)
+        stream = stream_drop(stream, 1);
+    CU_ASSERT_PTR_NOT_NULL(stream);
+    CU_ASSERT_EQUAL(stream_count(stream), ELEMENTS - STREAM_MAX_STAGES);
+
+    stream = stream_from_array_list(array);
+    for (int i = 0; i <= STREAM_MAX_STAGES; i++)
+        stream = stream_drop(stream, 1);
+    CU_ASSERT_PTR_NULL(stream);
+    int seed = 7;
+    CU_ASSERT_PTR_EQUAL(stream_foldl(stream, &seed, sum), &seed);
+    CU_ASSERT_EQUAL(stream_count(NULL), 0);
+}
+
+CU_pSuite get_stream_suite(void)
+{
+    CU_pSuite suite = CU_add_suite("Stream suite", init_suite, clean_suite);
+    CU_add_test(suite, "Test of streams against eager filter, map and foldl", test_stream_same_as_eager);
+    CU_add_test(suite, "Test of stream take reading no further than needed", test_stream_take_stops_reading);
+    CU_add_test(suite, "Test of stream drop and take", test_stream_drop_and_take);
+    CU_add_test(suite, "Test of streams over hash maps", test_stream_from_hash_map);
+    CU_add_test(suite, "Test of streams with too many stages", test_stream_too_many_stages);
+    return suite;
+}
@@ -0,0 +1,10 @@
+#ifndef STREAM_TEST_H_INCLUDED
+#define STREAM_TEST_H_INCLUDED
+
+#include <CUnit/Basic.h>
+#include <CUnit/CUnit.h>
+#include "../../../main/collections/stream/stream.h"
+
+CU_pSuite get_stream_suite(void);
+
+#endif
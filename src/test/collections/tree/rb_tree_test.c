@@ -76,11 +76,372 @@ static void test_rb_tree_delete(void)
     rb_tree_clear(tree);
 }
 
+// with whatever the tree was created with
+static bool goes_before(t_rb_tree *checked, void *a, void *b)
+{
+    return checked->compare ? checked->compare(a, b) < 0 : checked->comparator(a, b);
+}
+
+// black height of node, counting every broken link, color, order or size rule into errors
+static int check_subtree(t_rb_tree *checked, t_rbt_node *node, t_rbt_node *parent, int *errors)
+{
+    if (!node)
+        return 1;
+    *errors += node->parent != parent;
+    *errors += node->color == RED && parent && parent->color == RED;
+    *errors += node->left && !goes_before(checked, node->left->key, node->key);
+    *errors += node->right && !goes_before(checked, node->key, node->right->key);
+    *errors += node->subtree_size != 1 + (node->left ? node->left->subtree_size : 0) + (node->right ? node->right->subtree_size : 0);
+    int left = check_subtree(checked, node->left, node, errors);
+    int right = check_subtree(checked, node->right, node, errors);
+    *errors += left != right;
+    return left + (node->color == BLACK);
+}
+
+static int count_tree_errors(t_rb_tree *checked)
+{
+    int errors = checked->root && checked->root->color != BLACK;
+    check_subtree(checked, checked->root, NULL, &errors);
+    return errors;
+}
+
+static void test_rb_tree_random_insert_and_remove(void)
+{
+    int count = 5000;
+    int *values = malloc(count * sizeof(int));
+    bool *present = calloc(count, sizeof(bool));
+    int expected_size = 0, wrong_values = 0;
+    unsigned int random = 7;
+    for (int i = 0; i < count; i++)
+        values[i] = i;
+
+    for (int step = 0; step < 40000; step++)
+    {
+        random = random * 1103515245u + 12345u;
+        int key = (random >> 8) % count;
+        if ((random >> 4) % 3)
+        {
+            expected_size += !present[key];
+            present[key] = true;
+            rb_tree_insert(tree, (t_key){.size = sizeof(int), .data = &key}, &values[key]);
+        }
+        else
+        {
+            int *removed = NULL;
+            bool found = rb_tree_remove(tree, &key, (void **)&removed);
+            wrong_values += found != present[key] || (found && removed != &values[key]);
+            expected_size -= present[key];
+            present[key] = false;
+        }
+        if (step % 4000 == 0)
+            CU_ASSERT_EQUAL(count_tree_errors(tree), 0);
+    }
+    CU_ASSERT_EQUAL(count_tree_errors(tree), 0);
+    CU_ASSERT_EQUAL(rb_tree_size(tree), expected_size);
+    CU_ASSERT_EQUAL(wrong_values, 0);
+
+    for (int key = 0; key < count; key++)
+    {
+        int *found = NULL;
+        wrong_values += rb_tree_find(tree, &key, (void **)&found) != present[key] || (present[key] && found != &values[key]);
+    }
+    CU_ASSERT_EQUAL(wrong_values, 0);
+
+    rb_tree_clear(tree);
+    free(values);
+    free(present);
+}
+
+// descending order, a comparator the tree does not know
+static int compare_descending(const void *a, const void *b)
+{
+    return rb_tree_compare_int(b, a);
+}
+
+static void test_rb_tree_three_way_comparators(void)
+{
+    t_three_way_comparator comparators[] = {rb_tree_compare_int, compare_descending};
+    for (int c = 0; c < 2; c++)
+    {
+        t_rb_tree *ints = rbt_tree_create_with_cmp(comparators[c]);
+        CU_ASSERT_EQUAL(ints->compare_kind, c == 0 ? RB_TREE_COMPARE_INT : RB_TREE_COMPARE_THREE_WAY);
+        for (int i = 0; i < 1000; i++)
+        {
+            int key = (i * 7919) % 1000 - 500;
+            rb_tree_insert(ints, (t_key){.size = sizeof(int), .data = &key}, NULL);
+        }
+        for (int key = -500; key < 500; key += 2)
+            rb_tree_remove(ints, &key, NULL);
+        CU_ASSERT_EQUAL(rb_tree_size(ints), 500);
+        CU_ASSERT_EQUAL(count_tree_errors(ints), 0);
+        CU_ASSERT_TRUE(rb_tree_find(ints, &(int){-499}, NULL));
+        CU_ASSERT_FALSE(rb_tree_find(ints, &(int){-498}, NULL));
+        rb_tree_destroy(ints);
+    }
+
+    t_rb_tree *longs = rbt_tree_create_with_cmp(rb_tree_compare_int64);
+    CU_ASSERT_EQUAL(longs->compare_kind, RB_TREE_COMPARE_INT64);
+    for (int64_t i = 0; i < 100; i++)
+    {
+        int64_t key = (i - 50) * 10000000000LL;
+        rb_tree_insert(longs, (t_key){.size = sizeof(int64_t), .data = &key}, NULL);
+    }
+    CU_ASSERT_EQUAL(count_tree_errors(longs), 0);
+    CU_ASSERT_TRUE(rb_tree_find(longs, &(int64_t){-490000000000LL}, NULL));
+    rb_tree_destroy(longs);
+
+    t_rb_tree *strings = rbt_tree_create_with_cmp(rb_tree_compare_string);
+    CU_ASSERT_EQUAL(strings->compare_kind, RB_TREE_COMPARE_STRING);
+    char *words[] = {"pear", "apple", "fig", "banana", "apples", "kiwi"};
+    for (int i = 0; i < 6; i++)
+        rb_tree_insert(strings, (t_key){.size = strlen(words[i]) + 1, .data = words[i]}, words[i]);
+    char *found;
+    CU_ASSERT_TRUE(rb_tree_find(strings, "apples", (void **)&found));
+    CU_ASSERT_PTR_EQUAL(found, words[4]);
+    CU_ASSERT_FALSE(rb_tree_find(strings, "appl", NULL));
+    CU_ASSERT_EQUAL(count_tree_errors(strings), 0);
+    rb_tree_destroy(strings);
+
+    CU_ASSERT_PTR_NULL(rbt_tree_create_with_cmp(NULL));
+}
+
+static int visited[64];
+static int visited_count;
+
+static void visit_key(void *key, void *value)
+{
+    (void)value;
+    visited[visited_count++] = *(int *)key;
+}
+
+static void test_rb_tree_ordered_access(void)
+{
+    t_rb_tree *ordered = rbt_tree_create_with_cmp(rb_tree_compare_int);
+    // even keys 0 to 38, inserted out of order
+    for (int i = 0; i < 20; i++)
+    {
+        int key = (i * 7) % 20 * 2;
+        rb_tree_insert(ordered, (t_key){.size = sizeof(int), .data = &key}, NULL);
+    }
+
+    visited_count = 0;
+    rb_tree_iterate_inorder(ordered, visit_key);
+    int wrong = visited_count != 20;
+    for (int i = 0; i < visited_count; i++)
+        wrong += visited[i] != i * 2;
+    CU_ASSERT_EQUAL(wrong, 0);
+
+    visited_count = 0;
+    rb_tree_range(ordered, &(int){5}, &(int){12}, visit_key);
+    CU_ASSERT_EQUAL(visited_count, 4);
+    CU_ASSERT_EQUAL(visited[0], 6);
+    CU_ASSERT_EQUAL(visited[3], 12);
+    visited_count = 0;
+    rb_tree_range(ordered, &(int){39}, &(int){100}, visit_key);
+    CU_ASSERT_EQUAL(visited_count, 0);
+
+    t_rb_tree_cursor cursor = rb_tree_lower_bound(ordered, &(int){10});
+    CU_ASSERT_EQUAL(*(int *)rb_tree_cursor_key(&cursor), 10);
+    cursor = rb_tree_upper_bound(ordered, &(int){10});
+    CU_ASSERT_EQUAL(*(int *)rb_tree_cursor_key(&cursor), 12);
+    cursor = rb_tree_lower_bound(ordered, &(int){11});
+    CU_ASSERT_EQUAL(*(int *)rb_tree_cursor_key(&cursor), 12);
+    cursor = rb_tree_upper_bound(ordered, &(int){38});
+    CU_ASSERT_TRUE(rb_tree_cursor_is_end(&cursor));
+    CU_ASSERT_TRUE(rb_tree_cursor_prev(&cursor));
+    CU_ASSERT_EQUAL(*(int *)rb_tree_cursor_key(&cursor), 38);
+
+    // walk back to the front, removing keys around the cursor as it goes
+    cursor = rb_tree_lower_bound(ordered, &(int){20});
+    int steps = 0;
+    do
+    {
+        int key = *(int *)rb_tree_cursor_key(&cursor) + 2;
+        rb_tree_remove(ordered, &key, NULL);
+        steps++;
+    } while (rb_tree_cursor_prev(&cursor));
+    CU_ASSERT_EQUAL(steps, 11);
+    CU_ASSERT_TRUE(rb_tree_cursor_is_end(&cursor));
+    CU_ASSERT_EQUAL(count_tree_errors(ordered), 0);
+
+    cursor = rb_tree_first(ordered);
+    steps = 1;
+    while (rb_tree_cursor_next(&cursor))
+        steps++;
+    CU_ASSERT_EQUAL(steps, rb_tree_size(ordered));
+    CU_ASSERT_FALSE(rb_tree_cursor_next(&cursor));
+    rb_tree_destroy(ordered);
+
+    t_rb_tree *empty = rbt_tree_create_with_cmp(rb_tree_compare_int);
+    cursor = rb_tree_first(empty);
+    CU_ASSERT_TRUE(rb_tree_cursor_is_end(&cursor));
+    CU_ASSERT_FALSE(rb_tree_cursor_prev(&cursor));
+    CU_ASSERT_PTR_NULL(rb_tree_cursor_key(&cursor));
+    rb_tree_destroy(empty);
+}
+
+// select and rank against the sorted keys, rebuilt from present after every batch of changes
+static void test_rb_tree_order_statistics(void)
+{
+    int count = 2000;
+    bool *present = calloc(count, sizeof(bool));
+    int *sorted = malloc(count * sizeof(int));
+    t_rb_tree *ranked = rbt_tree_create_with_cmp(rb_tree_compare_int);
+    unsigned int random = 11;
+    int wrong = 0;
+
+    for (int round = 0; round < 20; round++)
+    {
+        for (int step = 0; step < 500; step++)
+        {
+            random = random * 1103515245u + 12345u;
+            int key = (random >> 8) % count;
+            if ((random >> 4) % 3)
+            {
+                present[key] = true;
+                rb_tree_insert(ranked, (t_key){.size = sizeof(int), .data = &key}, NULL);
+            }
+            else
+            {
+                present[key] = false;
+                rb_tree_remove(ranked, &key, NULL);
+            }
+        }
+        CU_ASSERT_EQUAL(count_tree_errors(ranked), 0);
+
+        int size = 0;
+        for (int key = 0; key < count; key++)
+        {
+            // keys before this one, whether it is in the tree or not
+            wrong += rb_tree_rank(ranked, &key) != size;
+            if (present[key])
+                sorted[size++] = key;
+        }
+        CU_ASSERT_EQUAL(rb_tree_size(ranked), size);
+        for (int k = 0; k < size; k++)
+        {
+            t_rb_tree_cursor cursor = rb_tree_select(ranked, k);
+            wrong += rb_tree_cursor_is_end(&cursor) || *(int *)rb_tree_cursor_key(&cursor) != sorted[k];
+        }
+        t_rb_tree_cursor past = rb_tree_select(ranked, size);
+        t_rb_tree_cursor before = rb_tree_select(ranked, -1);
+        wrong += !rb_tree_cursor_is_end(&past) + !rb_tree_cursor_is_end(&before);
+    }
+    CU_ASSERT_EQUAL(wrong, 0);
+
+    rb_tree_destroy(ranked);
+    free(present);
+    free(sorted);
+}
+
+static void test_rb_tree_bulk_loads(void)
+{
+    int count = 1000;
+    int *numbers = malloc(count * sizeof(int));
+    void **values = malloc(count * sizeof(void *));
+    t_key *keys = malloc(count * sizeof(t_key));
+    for (int i = 0; i < count; i++)
+    {
+        numbers[i] = i * 2;
+        values[i] = &numbers[i];
+        keys[i] = (t_key){.size = sizeof(int), .data = &numbers[i]};
+    }
+
+    // sizes around full levels, where the coloring changes
+    int sizes[] = {0, 1, 2, 3, 4, 7, 8, 15, 100, 1000};
+    int wrong = 0;
+    for (int s = 0; s < (int)(sizeof(sizes) / sizeof(int)); s++)
+    {
+        t_rb_tree *built = rbt_tree_create_with_cmp(rb_tree_compare_int);
+        CU_ASSERT_TRUE(rb_tree_build_from_sorted(built, keys, values, sizes[s]));
+        CU_ASSERT_EQUAL(count_tree_errors(built), 0);
+        CU_ASSERT_EQUAL(rb_tree_size(built), sizes[s]);
+        for (int i = 0; i < sizes[s]; i++)
+        {
+            int *found = NULL;
+            t_rb_tree_cursor cursor = rb_tree_select(built, i);
+            wrong += !rb_tree_find(built, &numbers[i], (void **)&found) || found != &numbers[i];
+            wrong += rb_tree_cursor_key(&cursor) == NULL || *(int *)rb_tree_cursor_key(&cursor) != numbers[i];
+        }
+        rb_tree_destroy(built);
+    }
+    CU_ASSERT_EQUAL(wrong, 0);
+
+    t_rb_tree *rejecting = rbt_tree_create_with_cmp(rb_tree_compare_int);
+    t_key unsorted[] = {keys[1], keys[0]};
+    CU_ASSERT_FALSE(rb_tree_build_from_sorted(rejecting, unsorted, NULL, 2));
+    CU_ASSERT_TRUE(rb_tree_is_empty(rejecting));
+    CU_ASSERT_TRUE(rb_tree_build_from_sorted(rejecting, keys, NULL, 10));
+    CU_ASSERT_FALSE(rb_tree_build_from_sorted(rejecting, keys + 10, NULL, 10));
+    CU_ASSERT_EQUAL(rb_tree_size(rejecting), 10);
+    rb_tree_destroy(rejecting);
+
+    // batches of shuffled keys, odd ones new and even ones partly already in, some repeated,
+    // into a tree that mixes nodes of its own with nodes of earlier batches
+    t_rb_tree *batched = rbt_tree_create_with_cmp(rb_tree_compare_int);
+    int *batch_numbers = malloc(count * sizeof(int));
+    t_key *batch = malloc(count * sizeof(t_key));
+    void **expected = calloc(2 * count, sizeof(void *));
+    for (int i = 0; i < count; i += 3)
+    {
+        rb_tree_insert(batched, keys[i], values[i]);
+        expected[numbers[i]] = values[i];
+    }
+    unsigned int random = 5;
+    for (int round = 0; round < 4; round++)
+    {
+        // the last round is small enough to go in key by key
+        int batch_size = round < 3 ? count : 8;
+        for (int i = 0; i < batch_size; i++)
+        {
+            random = random * 1103515245u + 12345u;
+            batch_numbers[i] = (random >> 8) % (2 * count);
+            batch[i] = (t_key){.size = sizeof(int), .data = &batch_numbers[i]};
+        }
+        CU_ASSERT_TRUE(rb_tree_insert_batch(batched, batch, NULL, 0));
+        CU_ASSERT_TRUE(rb_tree_insert_batch(batched, batch, values, batch_size));
+        for (int i = 0; i < batch_size; i++)
+            expected[batch_numbers[i]] = values[i];
+        CU_ASSERT_EQUAL(count_tree_errors(batched), 0);
+
+        // and removes, freeing the nodes of their own but not those in blocks
+        for (int key = round; key < 2 * count; key += 7)
+        {
+            rb_tree_remove(batched, &key, NULL);
+            expected[key] = NULL;
+        }
+        int size = 0;
+        for (int key = 0; key < 2 * count; key++)
+        {
+            void *found = NULL;
+            bool present = rb_tree_find(batched, &key, &found);
+            wrong += present != (expected[key] != NULL) || found != expected[key];
+            size += present;
+        }
+        CU_ASSERT_EQUAL(rb_tree_size(batched), size);
+        CU_ASSERT_EQUAL(count_tree_errors(batched), 0);
+    }
+    CU_ASSERT_EQUAL(wrong, 0);
+
+    rb_tree_destroy(batched);
+    free(batch_numbers);
+    free(batch);
+    free(expected);
+    free(numbers);
+    free(values);
+    free(keys);
+}
+
 CU_pSuite get_rb_tree_suite(void)
 {
     CU_pSuite suite = CU_add_suite("Red black tree suite", init_suite, clean_suite);
     CU_add_test(suite, "red black tree, test of insert", test_rb_tree_insert);
     CU_add_test(suite, "red black tree, test of delete", test_rb_tree_delete);
+    CU_add_test(suite, "red black tree, test of random inserts and removes", test_rb_tree_random_insert_and_remove);
+    CU_add_test(suite, "red black tree, test of three way comparators", test_rb_tree_three_way_comparators);
+    CU_add_test(suite, "red black tree, test of ordered iteration, bounds and cursors", test_rb_tree_ordered_access);
+    CU_add_test(suite, "red black tree, test of select and rank", test_rb_tree_order_statistics);
+    CU_add_test(suite, "red black tree, test of bulk loads", test_rb_tree_bulk_loads);
 
     return suite;
 }
@@ -0,0 +1,288 @@
+#include "thread_pool_test.h"
+
+#define WORKERS 4
+#define TASKS 10000
+#define ELEMENTS 20000
+// ranges at most this long are summed without splitting further
+#define SUM_CUTOFF 64
+
+static t_thread_pool *pool;
+static atomic_int counter;
+
+typedef struct
+{
+    long begin;
+    long end;
+    long result;
+} t_sum_range;
+
+static void increment_counter(void *arg)
+{
+    (void)arg;
+    atomic_fetch_add(&counter, 1);
+}
+
+// fork-join the classic way: spawn one half, do the other, join
+static void sum_range(void *arg)
+{
+    t_sum_range *range = arg;
+    if (range->end - range->begin <= SUM_CUTOFF)
+    {
+        range->result = 0;
+        for (long i = range->begin; i < range->end; i++)
+            range->result += i;
+        return;
+    }
+    long middle = range->begin + (range->end - range->begin) / 2;
+    t_sum_range lower = {range->begin, middle, 0};
+    t_sum_range upper = {middle, range->end, 0};
+    t_task_group group;
+    task_group_init(&group);
+    thread_pool_spawn(pool, &group, sum_range, &upper);
+    sum_range(&lower);
+    thread_pool_join(pool, &group);
+    range->result = lower.result + upper.result;
+}
+
+static void increment_element(void *element)
+{
+    // every element is visited by exactly one worker, no atomics needed
+    (*(int *)element)++;
+}
+
+static void test_thread_pool_submit_and_wait(void)
+{
+    atomic_store(&counter, 0);
+    for (int i = 0; i < TASKS; i++)
+        thread_pool_submit(pool, increment_counter, NULL);
+    thread_pool_wait(pool);
+    CU_ASSERT_EQUAL(atomic_load(&counter), TASKS);
+    CU_ASSERT_EQUAL(thread_pool_size(pool), WORKERS);
+
+    // nothing left to wait for
+    thread_pool_wait(pool);
+    CU_ASSERT_EQUAL(atomic_load(&counter), TASKS);
+}
+
+static void test_thread_pool_nested_fork_join(void)
+{
+    t_sum_range range = {0, 1000000, 0};
+    t_task_group group;
+    task_group_init(&group);
+    thread_pool_spawn(pool, &group, sum_range, &range);
+    thread_pool_join(pool, &group);
+    CU_ASSERT_EQUAL(range.result, 999999L * 1000000L / 2);
+}
+
+static void sleep_a_while(void *arg)
+{
+    (void)arg;
+    nanosleep(&(struct timespec){0, 300 * 1000 * 1000}, NULL);
+}
+
+// a thread outside the pool waiting on a long task sleeps instead of spinning
+static void test_thread_pool_join_from_outside_sleeps(void)
+{
+    t_task_group group;
+    task_group_init(&group);
+    // no worker is idle to take it right away, the joiner would run it itself otherwise
+    for (int i = 0; i < WORKERS; i++)
+        thread_pool_spawn(pool, &group, sleep_a_while, NULL);
+    nanosleep(&(struct timespec){0, 50 * 1000 * 1000}, NULL);
+    clock_t start = clock();
+    thread_pool_join(pool, &group);
+    double cpu_seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    CU_ASSERT_EQUAL(atomic_load(&group.pending), 0);
+    CU_ASSERT_TRUE(cpu_seconds < 0.1);
+}
+
+static void test_array_list_parallel_foreach(void)
+{
+    t_array_list *list = array_list_create();
+    array_list_parallel_foreach(list, pool, increment_element);
+
+    for (int i = 0; i < ELEMENTS; i++)
+    {
+        int *x = malloc(sizeof(int));
+        *x = i;
+        array_list_add(list, x);
+    }
+    array_list_parallel_foreach(list, pool, increment_element);
+
+    int wrong = 0;
+    for (int i = 0; i < ELEMENTS; i++)
+    {
+        int *x;
+        array_list_get(list, i, (void **)&x);
+        wrong += *x != i + 1;
+    }
+    CU_ASSERT_EQUAL(wrong, 0);
+    array_list_destroy_and_destroy_elements(list, free);
+}
+
+static void test_linked_list_parallel_foreach(void)
+{
+    t_linked_list *list = linked_list_create();
+    linked_list_parallel_foreach(list, pool, increment_element);
+
+    for (int i = 0; i < ELEMENTS; i++)
+    {
+        int *x = malloc(sizeof(int));
+        *x = i;
+        linked_list_add(list, x);
+    }
+    linked_list_parallel_foreach(list, pool, increment_element);
+
+    int wrong = 0;
+    int expected = 1;
+    for (t_double_l_node *node = list->head; node; node = node->next)
+        wrong += *(int *)node->data != expected++;
+    CU_ASSERT_EQUAL(wrong, 0);
+    linked_list_destroy_and_destroy_elements(list, free);
+}
+
+static int squares[ELEMENTS];
+
+// points into squares, a single writer per index
+static void *square(void *x)
+{
+    int i = *(int *)x;
+    squares[i] = i * i;
+    return &squares[i];
+}
+
+static bool is_multiple_of_three(void *x)
+{
+    return *(int *)x % 3 == 0;
+}
+
+static void *larger(void *a, void *b)
+{
+    return *(int *)b > *(int *)a ? b : a;
+}
+
+// associative but not commutative, any reordering of the partials would show
+static void *leftmost(void *a, void *b)
+{
+    (void)b;
+    return a;
+}
+
+static void test_array_list_parallel_map_filter_reduce(void)
+{
+    t_array_list *list = array_list_create();
+    int *values = malloc(ELEMENTS * sizeof(int));
+    CU_ASSERT_PTR_NULL(array_list_parallel_reduce(list, pool, larger));
+    t_array_list *empty = array_list_parallel_filter(list, pool, is_multiple_of_three);
+    CU_ASSERT_EQUAL(array_list_size(empty), 0);
+    array_list_destroy(empty);
+
+    for (int i = 0; i < ELEMENTS; i++)
+    {
+        values[i] = (i * 7919) % ELEMENTS;
+        array_list_add(list, &values[i]);
+    }
+
+    t_array_list *mapped = array_list_parallel_map(list, pool, square);
+    t_array_list *filtered = array_list_parallel_filter(list, pool, is_multiple_of_three);
+    int wrong = array_list_size(mapped) != ELEMENTS;
+    int expected_kept = 0;
+    for (int i = 0; i < ELEMENTS; i++)
+    {
+        wrong += *(int *)mapped->array[i] != values[i] * values[i];
+        if (values[i] % 3 == 0)
+            wrong += expected_kept >= (int)array_list_size(filtered) || filtered->array[expected_kept++] != &values[i];
+    }
+    CU_ASSERT_EQUAL(wrong, 0);
+    CU_ASSERT_EQUAL((int)array_list_size(filtered), expected_kept);
+
+    CU_ASSERT_EQUAL(*(int *)array_list_parallel_reduce(list, pool, larger), ELEMENTS - 1);
+    CU_ASSERT_PTR_EQUAL(array_list_parallel_reduce(list, pool, leftmost), &values[0]);
+
+    array_list_destroy(mapped);
+    array_list_destroy(filtered);
+    array_list_destroy(list);
+    free(values);
+}
+
+static bool int_less_than(void *a, void *b)
+{
+    return *(int *)a < *(int *)b;
+}
+
+static void test_array_list_parallel_sort(void)
+{
+    t_array_list *list = array_list_create();
+    int count = 200000;
+    int *values = malloc(count * sizeof(int));
+    long long expected_sum = 0;
+    for (int i = 0; i < count; i++)
+    {
+        values[i] = (int)((i * 2654435761u) % 100000);
+        expected_sum += values[i];
+        array_list_add(list, &values[i]);
+    }
+
+    array_list_parallel_sort(list, pool, int_less_than);
+
+    int out_of_order = 0;
+    long long sum = 0;
+    for (int i = 0; i < count; i++)
+    {
+        sum += *(int *)list->array[i];
+        out_of_order += i > 0 && int_less_than(list->array[i], list->array[i - 1]);
+    }
+    CU_ASSERT_EQUAL(out_of_order, 0);
+    CU_ASSERT_EQUAL(sum, expected_sum);
+    array_list_destroy(list);
+    free(values);
+}
+
+static void test_linked_list_parallel_sort(void)
+{
+    t_linked_list *list = linked_list_create();
+    int count = 100000;
+    int *values = malloc(count * sizeof(int));
+    for (int i = 0; i < count; i++)
+    {
+        values[i] = count - i;
+        linked_list_add(list, &values[i]);
+    }
+
+    linked_list_parallel_sort(list, pool, int_less_than);
+
+    int wrong = 0;
+    int expected = 1;
+    for (t_double_l_node *node = list->head; node; node = node->next)
+        wrong += *(int *)node->data != expected++;
+    CU_ASSERT_EQUAL(wrong, 0);
+    CU_ASSERT_EQUAL(*(int *)list->tail->data, count);
+    linked_list_destroy(list);
+    free(values);
+}
+
+static int init_suite(void)
+{
+    pool = thread_pool_create(WORKERS);
+    return pool == NULL;
+}
+
+static int clean_suite(void)
+{
+    thread_pool_destroy(pool);
+    return 0;
+}
+
+CU_pSuite get_thread_pool_suite(void)
+{
+    CU_pSuite suite = CU_add_suite("thread pool suite", init_suite, clean_suite);
+    CU_ADD_TEST(suite, test_thread_pool_submit_and_wait);
+    CU_ADD_TEST(suite, test_thread_pool_nested_fork_join);
+    CU_ADD_TEST(suite, test_thread_pool_join_from_outside_sleeps);
+    CU_ADD_TEST(suite, test_array_list_parallel_foreach);
+    CU_ADD_TEST(suite, test_linked_list_parallel_foreach);
+    CU_ADD_TEST(suite, test_array_list_parallel_map_filter_reduce);
+    CU_ADD_TEST(suite, test_array_list_parallel_sort);
+    CU_ADD_TEST(suite, test_linked_list_parallel_sort);
+    return suite;
+}
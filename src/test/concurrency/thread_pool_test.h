@@ -0,0 +1,13 @@
+#ifndef THREAD_POOL_TEST_H_INCLUDED
+#define THREAD_POOL_TEST_H_INCLUDED
+
+#include <time.h>
+#include <CUnit/Basic.h>
+#include <CUnit/CUnit.h>
+#include "../../main/concurrency/thread_pool.h"
+#include "../../main/collections/list/array_list.h"
+#include "../../main/collections/list/linked_list.h"
+
+CU_pSuite get_thread_pool_suite(void);
+
+#endif